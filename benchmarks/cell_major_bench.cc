@@ -0,0 +1,158 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: interleaved vs. cell-major deme execution (see CellExecutionMode in
+// source/Deme.h). For each workload & execution mode, runs REPLICATES seeds and
+// reports throughput along with outcome statistics, then compares each cell-major
+// batch size against interleaved execution.
+//  - Workloads: 'metabolize-heavy' (benchmarks/configs/metabolize-heavy.gp: every
+//    cell expresses every resource, donates, and divides; demes fill up, so cells
+//    compete for resources) and 'random' (random genomes; includes messaging).
+//  - Outcomes (per replicate, at the end of the run): mean resources collected per
+//    organism, mean active cells per deme, and mean organism age.
+//  - Comparison rows: speedup (interleaved ms / cell-major ms) and, for each
+//    outcome, the difference in means & Welch's t statistic (|t| well above ~2 =>
+//    the changed interleaving measurably changes that outcome).
+//  - Usage: ./cell_major_bench [UPDATES] [POP_SIZE] [REPLICATES]
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "base/vector.h"
+
+#include "../source/DOLWorld.h"
+#include "../source/DOLWorldConfig.h"
+
+constexpr size_t NUM_OUTCOMES = 3;
+const char * outcome_names[NUM_OUTCOMES] = {"collected_per_org", "active_cells_per_deme", "mean_age"};
+
+struct RunResult {
+  double ms=0.0;
+  double outcomes[NUM_OUTCOMES] = {};
+};
+
+RunResult RunBenchmark(const std::string & workload, const std::string & mode, size_t batch_steps,
+                       size_t updates, size_t pop_size, int seed) {
+  DOLWorldConfig config;
+  config.SEED(seed);
+  if (workload == "random") {
+    config.INIT_POP_MODE("random");
+  } else {
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH("benchmarks/configs/" + workload + ".gp");
+  }
+  config.INIT_POP_SIZE(pop_size);
+  config.MAX_POP_SIZE(pop_size);
+  config.CELL_EXECUTION_MODE(mode);
+  config.CELL_BATCH_STEPS(batch_steps);
+
+  // World setup/updates are chatty; keep it off of the benchmark output.
+  std::stringstream sink;
+  std::streambuf * cout_buf = std::cout.rdbuf(sink.rdbuf());
+  emp::Random rnd(seed);
+  DOLWorld world(rnd);
+  world.Setup(config);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t u = 0; u < updates; ++u) {
+    world.RunStep();
+    sink.str(""); // Don't let the sink grow over the run
+  }
+  const auto end = std::chrono::steady_clock::now();
+  std::cout.rdbuf(cout_buf);
+
+  RunResult result;
+  result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+  size_t num_orgs = 0;
+  for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+    if (!world.IsOccupied(pos)) continue;
+    ++num_orgs;
+    const Deme & deme = world.GetDeme(pos);
+    size_t active_cells = 0;
+    for (size_t cell_id = 0; cell_id < deme.GetCellCapacity(); ++cell_id) active_cells += (size_t)deme.IsCellActive(cell_id);
+    result.outcomes[0] += world.GetOrg(pos).GetPhenotype().total_resources_collected;
+    result.outcomes[1] += (double)active_cells;
+    result.outcomes[2] += (double)world.GetOrg(pos).GetPhenotype().age;
+  }
+  if (num_orgs) {
+    for (double & outcome : result.outcomes) outcome /= (double)num_orgs;
+  }
+  return result;
+}
+
+double Mean(const emp::vector<double> & values) {
+  double total = 0.0;
+  for (double value : values) total += value;
+  return (values.size()) ? total / (double)values.size() : 0.0;
+}
+
+double Variance(const emp::vector<double> & values) {
+  if (values.size() < 2) return 0.0;
+  const double mean = Mean(values);
+  double total = 0.0;
+  for (double value : values) total += (value - mean) * (value - mean);
+  return total / (double)(values.size() - 1);
+}
+
+/// Welch's t statistic for the difference in means of a and b (0 if both are constant)
+double WelchT(const emp::vector<double> & a, const emp::vector<double> & b) {
+  const double se = std::sqrt(Variance(a) / (double)a.size() + Variance(b) / (double)b.size());
+  const double diff = Mean(a) - Mean(b);
+  if (se == 0.0) return (diff == 0.0) ? 0.0 : INFINITY;
+  return diff / se;
+}
+
+int main(int argc, char* argv[]) {
+  const size_t updates = (argc > 1) ? std::stoul(argv[1]) : 300;
+  const size_t pop_size = (argc > 2) ? std::stoul(argv[2]) : 50;
+  const size_t replicates = (argc > 3) ? std::stoul(argv[3]) : 8;
+  const emp::vector<std::string> workloads = {"metabolize-heavy", "random"};
+  const emp::vector<size_t> batch_sizes = {1, 4, 8, 30};   // Cell-major batch sizes (0 => interleaved)
+
+  std::cout << "workload,mode,batch_steps,updates,pop_size,replicate,ms_per_update";
+  for (const char * name : outcome_names) std::cout << "," << name;
+  std::cout << std::endl;
+  emp::vector<std::string> summary;
+  for (const std::string & workload : workloads) {
+    // results[0] = interleaved; results[1+i] = cell-major with batch_sizes[i]
+    emp::vector<emp::vector<RunResult>> results(batch_sizes.size() + 1);
+    for (size_t config_id = 0; config_id < results.size(); ++config_id) {
+      const std::string mode = (config_id) ? "cell-major" : "interleaved";
+      const size_t batch_steps = (config_id) ? batch_sizes[config_id - 1] : 1;
+      for (size_t rep = 0; rep < replicates; ++rep) {
+        const RunResult result = RunBenchmark(workload, mode, batch_steps, updates, pop_size, (int)rep + 1);
+        results[config_id].emplace_back(result);
+        std::cout << workload << "," << mode << "," << batch_steps << "," << updates << "," << pop_size << ","
+                  << rep << "," << (result.ms / (double)updates);
+        for (double outcome : result.outcomes) std::cout << "," << outcome;
+        std::cout << std::endl;
+      }
+    }
+    // Compare every cell-major batch size against interleaved execution
+    auto collect = [&results](size_t config_id, int outcome) {
+      emp::vector<double> values;
+      for (const RunResult & result : results[config_id]) values.emplace_back((outcome < 0) ? result.ms : result.outcomes[outcome]);
+      return values;
+    };
+    const emp::vector<double> base_ms = collect(0, -1);
+    for (size_t config_id = 1; config_id < results.size(); ++config_id) {
+      std::ostringstream row;
+      row << workload << "," << batch_sizes[config_id - 1] << "," << (Mean(base_ms) / Mean(collect(config_id, -1)));
+      for (size_t outcome = 0; outcome < NUM_OUTCOMES; ++outcome) {
+        const emp::vector<double> base = collect(0, (int)outcome);
+        const emp::vector<double> batched = collect(config_id, (int)outcome);
+        row << "," << (Mean(batched) - Mean(base)) << "," << WelchT(batched, base);
+      }
+      summary.emplace_back(row.str());
+    }
+  }
+
+  std::cout << std::endl << "workload,batch_steps,speedup_vs_interleaved";
+  for (const char * name : outcome_names) std::cout << "," << name << "_diff," << name << "_welch_t";
+  std::cout << std::endl;
+  for (const std::string & row : summary) std::cout << row << std::endl;
+  return 0;
+}
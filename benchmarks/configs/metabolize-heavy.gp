@@ -0,0 +1,13 @@
+BIRTH-[0000000000000000]
+Fn-0000000000000000:
+  Inc(0,0,0)
+  While(0,0,0)
+    Express-0
+    Express-1
+    Express-2
+    Express-3
+    Express-4
+    DonateResources
+    RotateCW
+    CellDivide
+  Close
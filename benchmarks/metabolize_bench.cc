@@ -0,0 +1,72 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: metabolize-heavy populations under each resource consumption/decay
+// policy combination, with and without event tracing (to measure trace overhead).
+//  - Every organism runs benchmarks/configs/metabolize-heavy.gp (expresses every
+//    resource, donates, and divides every pass through its main loop), so the
+//    run is dominated by metabolize attempts & resource decay.
+//  - Usage: ./metabolize_bench [UPDATES] [POP_SIZE] [REPLICATES]
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "base/vector.h"
+
+#include "../source/DOLWorld.h"
+#include "../source/DOLWorldConfig.h"
+
+double RunBenchmark(const std::string & consume_mode, const std::string & decay_mode, bool trace,
+                    size_t updates, size_t pop_size, int seed) {
+  DOLWorldConfig config;
+  config.SEED(seed);
+  config.INIT_POP_MODE("load-single");
+  config.LOAD_ANCESTOR_INDIV_FPATH("benchmarks/configs/metabolize-heavy.gp");
+  config.INIT_POP_SIZE(pop_size);
+  config.MAX_POP_SIZE(pop_size);
+  config.RESOURCE_CONSUMPTION_MODE(consume_mode);
+  config.RESOURCE_DECAY_MODE(decay_mode);
+  config.TRACE_EVENTS(trace);
+  config.TRACE_FPATH("metabolize_bench_trace.dol");
+
+  // World setup/updates are chatty; keep it off of the benchmark output.
+  std::stringstream sink;
+  std::streambuf * cout_buf = std::cout.rdbuf(sink.rdbuf());
+  emp::Random rnd(seed);
+  DOLWorld world(rnd);
+  world.Setup(config);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t u = 0; u < updates; ++u) {
+    world.RunStep();
+    sink.str(""); // Don't let the sink grow over the run
+  }
+  world.CloseTrace(); // Include flushing the trace's index in the timing
+  const auto end = std::chrono::steady_clock::now();
+  std::cout.rdbuf(cout_buf);
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+  const size_t updates = (argc > 1) ? std::stoul(argv[1]) : 500;
+  const size_t pop_size = (argc > 2) ? std::stoul(argv[2]) : 100;
+  const size_t replicates = (argc > 3) ? std::stoul(argv[3]) : 3;
+  const emp::vector<std::string> modes = {"fixed", "proportional"};
+
+  std::cout << "consume_mode,decay_mode,trace,updates,pop_size,replicate,total_ms,ms_per_update" << std::endl;
+  for (const std::string & consume_mode : modes) {
+    for (const std::string & decay_mode : modes) {
+      for (bool trace : {false, true}) {
+        for (size_t rep = 0; rep < replicates; ++rep) {
+          const double ms = RunBenchmark(consume_mode, decay_mode, trace, updates, pop_size, (int)rep + 1);
+          std::cout << consume_mode << "," << decay_mode << "," << trace << "," << updates << "," << pop_size << ","
+                    << rep << "," << ms << "," << (ms / (double)updates) << std::endl;
+        }
+      }
+    }
+  }
+  std::remove("metabolize_bench_trace.dol");
+}
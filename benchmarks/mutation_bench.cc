@@ -0,0 +1,64 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: mutation engines (see source/Mutator.h) at the default mutation
+// rates. Every engine mutates copies of the same random genomes; mutations per
+// genome should agree across engines (per-site & skip-ahead sample the same
+// distribution), while time per genome shows the cost of sampling sites.
+//  - Usage: ./mutation_bench [GENOMES] [REPLICATES]
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "base/vector.h"
+#include "tools/Random.h"
+
+#include "../source/DOLWorld.h"
+#include "../source/DOLWorldConfig.h"
+#include "../source/DigitalOrganism.h"
+#include "../source/Mutator.h"
+
+int main(int argc, char* argv[]) {
+  const size_t num_genomes = (argc > 1) ? std::stoul(argv[1]) : 100000;
+  const size_t replicates = (argc > 2) ? std::stoul(argv[2]) : 3;
+  const emp::vector<std::string> engines = {"signalgp", "per-site", "skip-ahead"};
+
+  // A world only for its instruction set (setup is chatty; keep it off of the benchmark output)
+  DOLWorldConfig config;
+  config.SEED(1);
+  config.INIT_POP_SIZE(1);
+  config.MAX_POP_SIZE(1);
+  std::stringstream sink;
+  std::streambuf * cout_buf = std::cout.rdbuf(sink.rdbuf());
+  emp::Random world_rnd(config.SEED());
+  DOLWorld world(world_rnd);
+  world.Setup(config);
+  std::cout.rdbuf(cout_buf);
+
+  std::cout << "engine,genomes,replicate,mutations_per_genome,total_ms,us_per_genome" << std::endl;
+  for (size_t rep = 0; rep < replicates; ++rep) {
+    emp::Random genome_rnd((int)rep + 1);
+    emp::vector<DigitalOrganism::Genome> genomes;
+    for (size_t i = 0; i < 64; ++i) genomes.emplace_back(GenRandDigitalOrganismGenome(genome_rnd, world.GetInstLib(), config));
+    for (const std::string & engine : engines) {
+      config.MUTATION_ENGINE(engine);
+      Mutator mutator;
+      mutator.Setup(config);
+      emp::Random rnd((int)rep + 1);
+      size_t num_mutations = 0;
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < num_genomes; ++i) {
+        DigitalOrganism::Genome genome(genomes[i % genomes.size()]);
+        num_mutations += mutator.Mutate(genome, rnd);
+      }
+      const auto end = std::chrono::steady_clock::now();
+      const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+      std::cout << engine << "," << num_genomes << "," << rep << ","
+                << ((double)num_mutations / (double)num_genomes) << "," << ms << ","
+                << (1000.0 * ms / (double)num_genomes) << std::endl;
+    }
+  }
+}
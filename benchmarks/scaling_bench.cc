@@ -0,0 +1,343 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: how the engine scales with population size, deme size, CPU cycles
+// per update, number of resources, and number of threads (for sizing cluster
+// jobs), checked against a stored baseline.
+//  - Sweeps one axis at a time around a base point (MAX_POP_SIZE=1000, 5x5
+//    demes, 30 cycles, 4 periodic resources, 1 thread); the world starts full
+//    (INIT_POP_SIZE = MAX_POP_SIZE).
+//  - Workloads (fixed seed): 'single-static-task' (tests/test-configs/
+//    single-static-task.gp), 'metabolize-heavy' (benchmarks/configs/
+//    metabolize-heavy.gp), and 'random' (random genomes).
+//  - Each configuration runs in its own child process, so peak RSS is that
+//    configuration's own (not the largest run so far).
+//  - Reports updates/sec, ns per cell-cycle (CPU cycles given to cells active at
+//    the start of each update), and peak RSS. Results are written to
+//    scaling_bench.csv (baseline format).
+//  - MODE 'check' (default) compares against the baseline file
+//    (benchmarks/configs/scaling_baseline.csv by default). A configuration
+//    regresses if updates/sec falls, or ns per cell-cycle or peak RSS rises, by
+//    more than TOLERANCE (a fraction of the baseline). Exits with 1 if any
+//    configuration regressed, failed, or has no baseline row, or if the baseline
+//    file can't be read. A baseline file with no rows at all (e.g., the one in a
+//    fresh checkout) skips the check: nothing runs, SKIPPED is reported, and the
+//    exit status is 0.
+//  - MODE 'record' runs the sweep and writes the baseline file instead (only if
+//    every configuration ran). Baselines are machine-specific: record & check on
+//    the same machine, with the same SWEEP & UPDATES.
+//  - Usage: ./scaling_bench [MODE] [SWEEP] [UPDATES] [TOLERANCE] [BASELINE_FPATH]
+//    SWEEP: 'quick' (MAX_POP_SIZE up to 10k; default) or 'full' (up to 50k)
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "base/vector.h"
+
+#include "../source/DOLWorld.h"
+#include "../source/DOLWorldConfig.h"
+
+constexpr int SEED = 1;
+
+struct Workload {
+  std::string name;
+  std::string ancestor_fpath;   ///< Empty => random genomes
+};
+
+struct ScalingConfig {
+  std::string workload;
+  std::string axis;             ///< Which axis this point sweeps ('base' for the base point)
+  size_t pop_size=1000;
+  size_t deme_side=5;           ///< DEME_WIDTH = DEME_HEIGHT
+  size_t cycles=30;             ///< CPU_CYCLES_PER_UPDATE
+  size_t resources=4;           ///< NUM_PERIODIC_RESOURCES
+  size_t threads=1;             ///< NUM_THREADS
+
+  /// Identifies a configuration in the baseline
+  std::string GetKey(size_t updates) const {
+    std::ostringstream key;
+    key << workload << "," << pop_size << "," << deme_side << "," << cycles << "," << resources << "," << threads << "," << updates;
+    return key.str();
+  }
+};
+
+struct ScalingResult {
+  bool ok=false;
+  double updates_per_sec=0.0;
+  double ns_per_cell_cycle=0.0;
+  double peak_rss_kb=0.0;
+};
+
+/// Peak resident set size of this process (KB)
+double GetPeakRSSKB() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+  return (double)usage.ru_maxrss / 1024.0;   // bytes on macOS
+#else
+  return (double)usage.ru_maxrss;            // KB on Linux
+#endif
+}
+
+/// Run one configuration in this process
+ScalingResult RunScaling(const Workload & workload, const ScalingConfig & scaling, size_t updates) {
+  DOLWorldConfig config;
+  config.SEED(SEED);
+  if (workload.ancestor_fpath.empty()) {
+    config.INIT_POP_MODE("random");
+  } else {
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH(workload.ancestor_fpath);
+  }
+  config.INIT_POP_SIZE(scaling.pop_size);
+  config.MAX_POP_SIZE(scaling.pop_size);
+  config.DEME_WIDTH(scaling.deme_side);
+  config.DEME_HEIGHT(scaling.deme_side);
+  config.CPU_CYCLES_PER_UPDATE(scaling.cycles);
+  config.NUM_PERIODIC_RESOURCES(scaling.resources);
+  config.NUM_THREADS(scaling.threads);
+  config.PHASE_TIMING(false);
+
+  // World setup/updates are chatty; keep it off of the benchmark output.
+  std::stringstream sink;
+  std::streambuf * cout_buf = std::cout.rdbuf(sink.rdbuf());
+  emp::Random rnd(SEED);
+  DOLWorld world(rnd);
+  world.Setup(config);
+  double ns = 0.0;
+  double cell_cycles = 0.0;
+  for (size_t u = 0; u < updates; ++u) {
+    // Cycles handed out this update (counted outside of the timed span)
+    size_t active_cells = 0;
+    for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+      if (world.IsOccupied(pos)) active_cells += world.GetDeme(pos).GetNumActiveCells();
+    }
+    cell_cycles += (double)(active_cells * scaling.cycles);
+    const auto start = std::chrono::steady_clock::now();
+    world.RunStep();
+    const auto end = std::chrono::steady_clock::now();
+    ns += std::chrono::duration<double, std::nano>(end - start).count();
+    sink.str(""); // Don't let the sink grow over the run
+  }
+  std::cout.rdbuf(cout_buf);
+
+  ScalingResult result;
+  result.ok = true;
+  result.updates_per_sec = (ns > 0.0) ? 1e9 * (double)updates / ns : 0.0;
+  result.ns_per_cell_cycle = (cell_cycles > 0.0) ? ns / cell_cycles : 0.0;
+  result.peak_rss_kb = GetPeakRSSKB();
+  return result;
+}
+
+/// Run one configuration in a child process (so that peak RSS is its own)
+ScalingResult RunScalingForked(const Workload & workload, const ScalingConfig & scaling, size_t updates) {
+  ScalingResult result;
+  int fds[2];
+  if (pipe(fds) != 0) return result;
+  std::cout.flush(); // Don't duplicate buffered output in the child
+  const pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return result;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    const ScalingResult child_result = RunScaling(workload, scaling, updates);
+    const ssize_t written = write(fds[1], &child_result, sizeof(child_result));
+    close(fds[1]);
+    _exit((written == (ssize_t)sizeof(child_result)) ? 0 : 1);
+  }
+  close(fds[1]);
+  ScalingResult child_result;
+  const bool got_result = read(fds[0], &child_result, sizeof(child_result)) == (ssize_t)sizeof(child_result);
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (got_result && WIFEXITED(status) && WEXITSTATUS(status) == 0) result = child_result;
+  return result;
+}
+
+/// Baseline results by configuration key (see ScalingConfig::GetKey); lines
+/// starting with '#' and the header are skipped
+std::map<std::string, ScalingResult> LoadBaseline(const std::string & fpath) {
+  std::map<std::string, ScalingResult> baseline;
+  std::ifstream file(fpath);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#' || line.rfind("workload,", 0) == 0) continue;
+    // workload,axis,pop_size,deme_side,cycles,resources,threads,updates,updates_per_sec,ns_per_cell_cycle,peak_rss_kb
+    emp::vector<std::string> fields;
+    std::stringstream fields_stream(line);
+    std::string field;
+    while (std::getline(fields_stream, field, ',')) fields.emplace_back(field);
+    if (fields.size() != 11) {
+      std::cout << "Skipping malformed baseline line: " << line << std::endl;
+      continue;
+    }
+    std::ostringstream key;
+    key << fields[0];
+    for (size_t i = 2; i < 8; ++i) key << "," << fields[i];
+    ScalingResult result;
+    result.ok = true;
+    result.updates_per_sec = std::stod(fields[8]);
+    result.ns_per_cell_cycle = std::stod(fields[9]);
+    result.peak_rss_kb = std::stod(fields[10]);
+    baseline[key.str()] = result;
+  }
+  return baseline;
+}
+
+/// Every configuration to run: each axis swept around the base point
+emp::vector<ScalingConfig> GetSweep(const emp::vector<Workload> & workloads, bool full) {
+  const emp::vector<size_t> pop_sizes = (full) ? emp::vector<size_t>{100, 1000, 10000, 50000} : emp::vector<size_t>{100, 1000, 10000};
+  const emp::vector<size_t> deme_sides = {3, 5, 10, 20};
+  const emp::vector<size_t> cycles = {10, 30, 100};
+  const emp::vector<size_t> resources = {1, 4, 16};
+  const emp::vector<size_t> threads = {1, 2, 4, 8};
+  const ScalingConfig base;
+  emp::vector<ScalingConfig> sweep;
+  for (const Workload & workload : workloads) {
+    ScalingConfig point = base;
+    point.workload = workload.name;
+    point.axis = "base";
+    sweep.emplace_back(point);
+    // Skip each axis' base value (already run as the base point)
+    auto add_axis = [&sweep, &point](const std::string & axis, const emp::vector<size_t> & values, size_t ScalingConfig::* member) {
+      for (size_t value : values) {
+        if (value == point.*member) continue;
+        ScalingConfig swept = point;
+        swept.axis = axis;
+        swept.*member = value;
+        sweep.emplace_back(swept);
+      }
+    };
+    add_axis("pop_size", pop_sizes, &ScalingConfig::pop_size);
+    add_axis("deme_side", deme_sides, &ScalingConfig::deme_side);
+    add_axis("cycles", cycles, &ScalingConfig::cycles);
+    add_axis("resources", resources, &ScalingConfig::resources);
+    add_axis("threads", threads, &ScalingConfig::threads);
+  }
+  return sweep;
+}
+
+/// Write recorded results (rows in results format) as the new baseline
+bool SaveBaseline(const std::string & fpath, const std::string & header, const emp::vector<std::string> & rows,
+                  const std::string & sweep_mode, size_t updates) {
+  std::ofstream file(fpath);
+  if (!file.is_open()) return false;
+  file << "# Baseline for benchmarks/scaling_bench.cc (see its header comment). Rows are" << std::endl;
+  file << "# machine-specific: record them on the machine you check on with" << std::endl;
+  file << "#   make scaling_bench_record SCALING_ARGS=\"" << sweep_mode << " " << updates << "\"" << std::endl;
+  file << header << std::endl;
+  for (const std::string & row : rows) file << row << std::endl;
+  return file.good();
+}
+
+int main(int argc, char* argv[]) {
+  const std::string mode = (argc > 1) ? argv[1] : "check";
+  const std::string sweep_mode = (argc > 2) ? argv[2] : "quick";
+  const size_t updates = (argc > 3) ? std::stoul(argv[3]) : 20;
+  const double tolerance = (argc > 4) ? std::stod(argv[4]) : 0.10;
+  const std::string baseline_fpath = (argc > 5) ? argv[5] : "benchmarks/configs/scaling_baseline.csv";
+  const std::string results_fpath = "scaling_bench.csv";
+  if (mode != "check" && mode != "record") {
+    std::cout << "Unrecognized MODE (" << mode << "). Options: 'check', 'record'" << std::endl;
+    return -1;
+  }
+  if (sweep_mode != "quick" && sweep_mode != "full") {
+    std::cout << "Unrecognized SWEEP (" << sweep_mode << "). Options: 'quick', 'full'" << std::endl;
+    return -1;
+  }
+  const bool recording = (mode == "record");
+  const emp::vector<Workload> workloads = {{"single-static-task", "tests/test-configs/single-static-task.gp"},
+                                           {"metabolize-heavy", "benchmarks/configs/metabolize-heavy.gp"},
+                                           {"random", ""}};
+  const emp::vector<ScalingConfig> sweep = GetSweep(workloads, sweep_mode == "full");
+  const std::map<std::string, ScalingResult> baseline = (recording) ? std::map<std::string, ScalingResult>() : LoadBaseline(baseline_fpath);
+  if (!recording && !std::ifstream(baseline_fpath).is_open()) {
+    std::cout << "Failed to read baseline file (" << baseline_fpath << ")." << std::endl;
+    return 1;
+  }
+  if (!recording && baseline.empty()) {
+    std::cout << "SKIPPED: no baseline results in " << baseline_fpath << ", so there's nothing to check against."
+              << " Record them on this machine first (./scaling_bench record " << sweep_mode << " " << updates << ")." << std::endl;
+    return 0;
+  }
+
+  std::ofstream results_file(results_fpath);
+  const std::string header = "workload,axis,pop_size,deme_side,cycles,resources,threads,updates,updates_per_sec,ns_per_cell_cycle,peak_rss_kb";
+  results_file << header << std::endl;
+  std::cout << header << ",baseline_updates_per_sec,baseline_ns_per_cell_cycle,baseline_peak_rss_kb,status" << std::endl;
+  size_t num_regressions = 0;
+  size_t num_failures = 0;
+  size_t num_missing = 0;
+  emp::vector<std::string> rows;
+  for (const ScalingConfig & scaling : sweep) {
+    const Workload & workload = *std::find_if(workloads.begin(), workloads.end(),
+                                              [&scaling](const Workload & w) { return w.name == scaling.workload; });
+    const ScalingResult result = RunScalingForked(workload, scaling, updates);
+    std::ostringstream row;
+    row << scaling.workload << "," << scaling.axis << "," << scaling.pop_size << "," << scaling.deme_side << ","
+        << scaling.cycles << "," << scaling.resources << "," << scaling.threads << "," << updates << ","
+        << result.updates_per_sec << "," << result.ns_per_cell_cycle << "," << result.peak_rss_kb;
+    std::cout << row.str();
+    if (!result.ok) {
+      ++num_failures;
+      std::cout << ",,,,FAILED" << std::endl;
+      continue;
+    }
+    results_file << row.str() << std::endl;
+    rows.emplace_back(row.str());
+    if (recording) {
+      std::cout << ",,,,recorded" << std::endl;
+      continue;
+    }
+    const auto base_it = baseline.find(scaling.GetKey(updates));
+    if (base_it == baseline.end()) {
+      ++num_missing;
+      std::cout << ",,,,NO-BASELINE" << std::endl;
+      continue;
+    }
+    const ScalingResult & base = base_it->second;
+    emp::vector<std::string> regressed;
+    if (result.updates_per_sec < base.updates_per_sec * (1.0 - tolerance)) regressed.emplace_back("updates_per_sec");
+    if (result.ns_per_cell_cycle > base.ns_per_cell_cycle * (1.0 + tolerance)) regressed.emplace_back("ns_per_cell_cycle");
+    if (result.peak_rss_kb > base.peak_rss_kb * (1.0 + tolerance)) regressed.emplace_back("peak_rss_kb");
+    std::string status = "ok";
+    if (regressed.size()) {
+      ++num_regressions;
+      status = "REGRESSION:";
+      for (size_t i = 0; i < regressed.size(); ++i) status += ((i) ? "+" : "") + regressed[i];
+    }
+    std::cout << "," << base.updates_per_sec << "," << base.ns_per_cell_cycle << "," << base.peak_rss_kb << "," << status << std::endl;
+  }
+
+  if (recording) {
+    std::cout << std::endl << sweep.size() << " configurations; " << num_failures << " failed. Results written to " << results_fpath;
+    if (num_failures) {
+      std::cout << "; baseline (" << baseline_fpath << ") left unchanged." << std::endl;
+      return 1;
+    }
+    if (!SaveBaseline(baseline_fpath, header, rows, sweep_mode, updates)) {
+      std::cout << "; failed to write baseline (" << baseline_fpath << ")." << std::endl;
+      return 1;
+    }
+    std::cout << " and recorded as the baseline (" << baseline_fpath << ")." << std::endl;
+    return 0;
+  }
+  std::cout << std::endl << sweep.size() << " configurations; " << num_regressions << " regressed beyond "
+            << (100.0 * tolerance) << "%; " << num_failures << " failed; " << num_missing << " missing from the baseline"
+            << " (" << baseline_fpath << "). Results written to " << results_fpath << "." << std::endl;
+  return (num_regressions || num_failures || num_missing) ? 1 : 0;
+}
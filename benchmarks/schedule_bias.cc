@@ -0,0 +1,68 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: cell scheduling strategies (see source/CellSchedule.h). For each
+// strategy and deme size, measures ordering bias (MeasureScheduleBias) and the
+// cost of producing one cycle's order.
+//  - Bias columns: position_chi2_per_dof (~1 = uniform positions), max_precedence_bias
+//    (0 = every pair equally likely in either order), order_repeat_rate (0.5 =
+//    consecutive cycles independent).
+//  - Usage: ./schedule_bias [UPDATES] [CYCLES_PER_UPDATE] [TABLE_SIZE]
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "base/vector.h"
+#include "tools/Random.h"
+
+#include "../source/CellSchedule.h"
+
+/// Nanoseconds per cycle spent producing schedules (cells do no work)
+double TimeSchedule(CellScheduler & scheduler, size_t updates, size_t cycles_per_update) {
+  size_t checksum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t u = 0; u < updates; ++u) {
+    scheduler.BeginUpdate();
+    for (size_t c = 0; c < cycles_per_update; ++c) {
+      scheduler.ForEachCell([&checksum](size_t id) { checksum += id; });
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  static volatile size_t sink;
+  sink = checksum; // Keep the loop from being optimized away
+  return std::chrono::duration<double, std::nano>(end - start).count() / (double)(updates * cycles_per_update);
+}
+
+int main(int argc, char* argv[]) {
+  const size_t updates = (argc > 1) ? std::stoul(argv[1]) : 2000;
+  const size_t cycles_per_update = (argc > 2) ? std::stoul(argv[2]) : 30;
+  const size_t table_size = (argc > 3) ? std::stoul(argv[3]) : 4096;
+  const emp::vector<size_t> deme_sides = {5, 10};
+  const emp::vector<std::pair<std::string, CellScheduleMode>> modes = {
+    {"shuffle", CellScheduleMode::SHUFFLE},
+    {"permutation-table", CellScheduleMode::PERMUTATION_TABLE},
+    {"rotate", CellScheduleMode::ROTATE},
+    {"fixed", CellScheduleMode::FIXED}
+  };
+
+  std::cout << "mode,deme_cells,updates,cycles_per_update,table_size,position_chi2_per_dof,max_precedence_bias,order_repeat_rate,ns_per_cycle" << std::endl;
+  for (size_t side : deme_sides) {
+    const size_t num_cells = side * side;
+    for (const auto & mode : modes) {
+      emp::Random rnd(1);
+      auto table = (mode.second == CellScheduleMode::PERMUTATION_TABLE)
+                 ? std::make_shared<CellPermutationTable>(rnd, num_cells, table_size) : nullptr;
+      CellScheduler scheduler(&rnd, num_cells);
+      scheduler.SetMode(mode.second, table);
+      const ScheduleBias bias = MeasureScheduleBias(scheduler, updates, cycles_per_update);
+      const double ns_per_cycle = TimeSchedule(scheduler, updates, cycles_per_update);
+      std::cout << mode.first << "," << num_cells << "," << updates << "," << cycles_per_update << ","
+                << table_size << "," << bias.position_chi2_per_dof << "," << bias.max_precedence_bias << ","
+                << bias.order_repeat_rate << "," << ns_per_cycle << std::endl;
+    }
+  }
+  return 0;
+}
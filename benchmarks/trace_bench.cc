@@ -0,0 +1,122 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Benchmark: event tracing overhead (TRACE_EVENTS; see source/EventTrace.h).
+//  - For each workload, runs the same seeds with tracing off & on (alternating,
+//    so machine noise hits both alike) and compares median ms per update.
+//  - Workloads: 'single-static-task' (tests/test-configs/single-static-task.gp),
+//    'metabolize-heavy' (benchmarks/configs/metabolize-heavy.gp), and 'random'
+//    (random genomes; includes messaging).
+//  - Reports overhead (traced / untraced - 1) and trace bytes per update
+//    (keyframes every TRACE_KEYFRAME_INTERVAL updates, at its default).
+//  - Exits with 1 if tracing costs more than MAX_OVERHEAD (a fraction; 0.10 by
+//    default) on any workload.
+//  - Usage: ./trace_bench [UPDATES] [POP_SIZE] [REPLICATES] [MAX_OVERHEAD]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "base/vector.h"
+
+#include "../source/DOLWorld.h"
+#include "../source/DOLWorldConfig.h"
+
+const std::string TRACE_FPATH = "trace_bench.dol";
+
+struct RunResult {
+  double ms=0.0;
+  size_t trace_bytes=0;
+};
+
+RunResult RunBenchmark(const std::string & workload, bool trace, size_t updates, size_t pop_size, int seed) {
+  DOLWorldConfig config;
+  config.SEED(seed);
+  if (workload == "random") {
+    config.INIT_POP_MODE("random");
+  } else {
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH((workload == "single-static-task") ? "tests/test-configs/single-static-task.gp"
+                                                                         : "benchmarks/configs/" + workload + ".gp");
+  }
+  config.INIT_POP_SIZE(pop_size);
+  config.MAX_POP_SIZE(pop_size);
+  config.TRACE_EVENTS(trace);
+  config.TRACE_FPATH(TRACE_FPATH);
+
+  // World setup/updates are chatty; keep it off of the benchmark output.
+  std::stringstream sink;
+  std::streambuf * cout_buf = std::cout.rdbuf(sink.rdbuf());
+  emp::Random rnd(seed);
+  DOLWorld world(rnd);
+  world.Setup(config);
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t u = 0; u < updates; ++u) {
+    world.RunStep();
+    sink.str(""); // Don't let the sink grow over the run
+  }
+  world.CloseTrace(); // Flushing the trace is part of its cost
+  const auto end = std::chrono::steady_clock::now();
+  std::cout.rdbuf(cout_buf);
+
+  RunResult result;
+  result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+  if (trace) {
+    std::ifstream trace_file(TRACE_FPATH, std::ios::binary | std::ios::ate);
+    result.trace_bytes = (trace_file.is_open()) ? (size_t)trace_file.tellg() : 0;
+    std::remove(TRACE_FPATH.c_str());
+  }
+  return result;
+}
+
+double Median(emp::vector<double> values) {
+  if (values.empty()) return 0.0;
+  std::sort(values.begin(), values.end());
+  const size_t mid = values.size() / 2;
+  return (values.size() % 2) ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+int main(int argc, char* argv[]) {
+  const size_t updates = (argc > 1) ? std::stoul(argv[1]) : 200;
+  const size_t pop_size = (argc > 2) ? std::stoul(argv[2]) : 100;
+  const size_t replicates = (argc > 3) ? std::stoul(argv[3]) : 5;
+  const double max_overhead = (argc > 4) ? std::stod(argv[4]) : 0.10;
+  const emp::vector<std::string> workloads = {"single-static-task", "metabolize-heavy", "random"};
+
+  std::cout << "workload,trace,updates,pop_size,replicate,ms_per_update,trace_bytes" << std::endl;
+  emp::vector<std::string> summary;
+  bool ok = true;
+  for (const std::string & workload : workloads) {
+    emp::vector<double> ms_off;
+    emp::vector<double> ms_on;
+    emp::vector<double> bytes_on;
+    for (size_t rep = 0; rep < replicates; ++rep) {
+      for (bool trace : {false, true}) {
+        const RunResult result = RunBenchmark(workload, trace, updates, pop_size, (int)rep + 1);
+        const double ms_per_update = result.ms / (double)updates;
+        ((trace) ? ms_on : ms_off).emplace_back(ms_per_update);
+        if (trace) bytes_on.emplace_back((double)result.trace_bytes);
+        std::cout << workload << "," << trace << "," << updates << "," << pop_size << "," << rep << ","
+                  << ms_per_update << "," << result.trace_bytes << std::endl;
+      }
+    }
+    const double overhead = Median(ms_on) / Median(ms_off) - 1.0;
+    const bool passed = overhead <= max_overhead;
+    ok = ok && passed;
+    std::ostringstream row;
+    row << workload << "," << Median(ms_off) << "," << Median(ms_on) << "," << overhead << ","
+        << (Median(bytes_on) / (double)updates) << "," << ((passed) ? "ok" : "OVER");
+    summary.emplace_back(row.str());
+  }
+
+  std::cout << std::endl << "workload,ms_per_update_untraced,ms_per_update_traced,overhead,trace_bytes_per_update,status" << std::endl;
+  for (const std::string & row : summary) std::cout << row << std::endl;
+  std::cout << std::endl << "Tracing overhead " << ((ok) ? "within " : "exceeds ") << max_overhead
+            << " on " << ((ok) ? "every workload." : "at least one workload.") << std::endl;
+  return (ok) ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/**
+ *  @date 2019
+ *
+ *  @file  BinaryIO.h
+ *
+ *  Byte buffers for compact binary formats (event traces, genome/population files):
+ *  LEB128 varints, zigzag-encoded signed values, little-endian raw words, and
+ *  packed bit vectors.
+ */
+
+#ifndef _BINARY_IO_H
+#define _BINARY_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "base/vector.h"
+
+/// Growable output byte buffer
+struct BinaryBuffer {
+  emp::vector<uint8_t> bytes;
+
+  void Clear() { bytes.clear(); }
+  size_t GetSize() const { return bytes.size(); }
+
+  void PutByte(uint8_t b) { bytes.emplace_back(b); }
+
+  void PutBytes(const void * data, size_t size) {
+    const uint8_t * begin = (const uint8_t *)data;
+    bytes.insert(bytes.end(), begin, begin + size);
+  }
+
+  void PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes.emplace_back((uint8_t)(value | 0x80));
+      value >>= 7;
+    }
+    bytes.emplace_back((uint8_t)value);
+  }
+
+  void PutZigzag(int64_t value) { PutVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63)); }
+
+  void PutUInt32(uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) bytes.emplace_back((uint8_t)(value >> (8*i)));
+  }
+
+  void PutUInt64(uint64_t value) {
+    for (size_t i = 0; i < 8; ++i) bytes.emplace_back((uint8_t)(value >> (8*i)));
+  }
+
+  void PutDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutUInt64(bits);
+  }
+
+  void PutString(const std::string & str) {
+    PutVarint(str.size());
+    PutBytes(str.data(), str.size());
+  }
+
+  void PutBits(const emp::vector<bool> & bits) {
+    for (size_t i = 0; i < bits.size(); i += 8) {
+      uint8_t b = 0;
+      for (size_t k = 0; k < 8 && i + k < bits.size(); ++k) b |= (uint8_t)(bits[i+k] << k);
+      bytes.emplace_back(b);
+    }
+  }
+
+  /// Write buffer contents to an output stream
+  void Write(std::ostream & os) const {
+    os.write((const char *)bytes.data(), (std::streamsize)bytes.size());
+  }
+};
+
+/// Read cursor over an in-memory byte range. Reading past the end of the range
+/// yields zeros and marks the cursor as failed (check IsOK()).
+struct BinaryCursor {
+  const uint8_t * data=nullptr;
+  size_t size=0;
+  size_t pos=0;
+  bool failed=false;
+
+  bool AtEnd() const { return pos >= size; }
+  bool IsOK() const { return !failed; }
+
+  uint8_t GetByte() {
+    if (pos >= size) { failed = true; return 0; }
+    return data[pos++];
+  }
+
+  /// Get pointer to the next 'count' bytes (& skip over them); nullptr if not enough bytes remain
+  const uint8_t * GetBytes(size_t count) {
+    if (pos > size || count > size - pos) { failed = true; pos = size; return nullptr; }
+    const uint8_t * begin = data + pos;
+    pos += count;
+    return begin;
+  }
+
+  uint64_t GetVarint() {
+    uint64_t value = 0;
+    for (size_t shift = 0; shift < 64; shift += 7) {
+      const uint8_t b = GetByte();
+      value |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return value;
+    }
+    failed = true; // Too many continuation bytes
+    return value;
+  }
+
+  int64_t GetZigzag() {
+    const uint64_t value = GetVarint();
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+  }
+
+  uint32_t GetUInt32() {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) value |= (uint32_t)GetByte() << (8*i);
+    return value;
+  }
+
+  uint64_t GetUInt64() {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) value |= (uint64_t)GetByte() << (8*i);
+    return value;
+  }
+
+  double GetDouble() {
+    const uint64_t bits = GetUInt64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::string GetString() {
+    const size_t len = (size_t)GetVarint();
+    const uint8_t * begin = GetBytes(len);
+    return (begin) ? std::string((const char *)begin, len) : std::string();
+  }
+
+  void GetBits(emp::vector<bool> & bits) {
+    for (size_t i = 0; i < bits.size(); i += 8) {
+      const uint8_t b = GetByte();
+      for (size_t k = 0; k < 8 && i + k < bits.size(); ++k) bits[i+k] = (b >> k) & 1;
+    }
+  }
+};
+
+/// Read an entire file into memory with a single read. Returns false on failure.
+bool ReadWholeFile(const std::string & path, emp::vector<uint8_t> & data) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  const std::streamsize size = in.tellg();
+  if (size < 0) return false;
+  in.seekg(0);
+  data.resize((size_t)size);
+  if (size > 0) in.read((char *)data.data(), size);
+  return (bool)in;
+}
+
+#endif
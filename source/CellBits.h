@@ -0,0 +1,107 @@
+/**
+ *  @date 2019
+ *
+ *  @file  CellBits.h
+ *
+ *  Per-deme cell state packed one bit per cell. A CellBitRows holds any number
+ *  of rows (e.g., one per resource), each row one bit per cell in 64-bit words,
+ *  so a deme of up to 64 cells keeps a whole row in a single word:
+ *  - Clearing a row (or every row) is a handful of word stores.
+ *  - Questions about the whole deme (e.g., which cells are active but not new
+ *    born) are bitwise operations over a few words (see ForEachSetBit).
+ */
+
+#ifndef _CELL_BITS_H
+#define _CELL_BITS_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+class CellBitRows {
+protected:
+  size_t num_cells=0;
+  size_t num_rows=0;
+  size_t words_per_row=0;
+  emp::vector<uint64_t> words;   ///< num_rows rows of words_per_row words
+
+public:
+  /// Word (within a row) holding cell_id's bit
+  static constexpr size_t WordID(size_t cell_id) { return cell_id >> 6; }
+  /// cell_id's bit within its word
+  static constexpr uint64_t BitMask(size_t cell_id) { return (uint64_t)1 << (cell_id & 63); }
+
+  CellBitRows(size_t _num_cells=0, size_t _num_rows=1) { Resize(_num_cells, _num_rows); }
+
+  /// Resize to num_rows rows of num_cells bits (every bit cleared)
+  void Resize(size_t _num_cells, size_t _num_rows) {
+    num_cells = _num_cells;
+    num_rows = _num_rows;
+    words_per_row = (num_cells + 63) / 64;
+    words.assign(num_rows * words_per_row, 0);
+  }
+
+  size_t GetNumCells() const { return num_cells; }
+  size_t GetNumRows() const { return num_rows; }
+  size_t GetWordsPerRow() const { return words_per_row; }
+
+  bool Get(size_t row, size_t cell_id) const {
+    emp_assert(row < num_rows && cell_id < num_cells);
+    return words[row * words_per_row + WordID(cell_id)] & BitMask(cell_id);
+  }
+
+  void Set(size_t row, size_t cell_id, bool value=true) {
+    emp_assert(row < num_rows && cell_id < num_cells);
+    uint64_t & word = words[row * words_per_row + WordID(cell_id)];
+    if (value) word |= BitMask(cell_id);
+    else word &= ~BitMask(cell_id);
+  }
+
+  /// Clear cell_id's bit in every row
+  void ClearCell(size_t cell_id) {
+    emp_assert(cell_id < num_cells);
+    const size_t word_id = WordID(cell_id);
+    const uint64_t mask = ~BitMask(cell_id);
+    for (size_t row = 0; row < num_rows; ++row) words[row * words_per_row + word_id] &= mask;
+  }
+
+  /// Clear every bit in row
+  void ClearRow(size_t row) {
+    emp_assert(row < num_rows);
+    std::fill(words.begin() + row * words_per_row, words.begin() + (row + 1) * words_per_row, 0);
+  }
+
+  /// Clear every bit in every row
+  void ClearAll() { std::fill(words.begin(), words.end(), 0); }
+
+  /// Words of row (GetWordsPerRow() of them; bits past the last cell are always 0)
+  const uint64_t * GetRow(size_t row) const { emp_assert(row < num_rows); return words.data() + row * words_per_row; }
+
+  /// Number of set bits in row
+  size_t CountRow(size_t row) const {
+    const uint64_t * row_words = GetRow(row);
+    size_t count = 0;
+    for (size_t w = 0; w < words_per_row; ++w) count += (size_t)__builtin_popcountll(row_words[w]);
+    return count;
+  }
+
+  /// Heap bytes held
+  size_t GetMemoryBytes() const { return words.capacity() * sizeof(uint64_t); }
+};
+
+/// Call fun(cell_id) for every set bit in the words_per_row words produced by
+/// get_word(w), in cell id order (e.g., get_word = active & sensing)
+template<typename GET_WORD, typename FUN>
+void ForEachSetBit(size_t words_per_row, GET_WORD && get_word, FUN && fun) {
+  for (size_t w = 0; w < words_per_row; ++w) {
+    uint64_t word = get_word(w);
+    while (word) {
+      fun(w * 64 + (size_t)__builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+}
+
+#endif
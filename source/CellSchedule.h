@@ -0,0 +1,197 @@
+/**
+ *  @date 2019
+ *
+ *  @file  CellSchedule.h
+ *
+ *  Strategies for ordering cell execution within a deme. Every CPU cycle, each
+ *  active cell in a deme executes once; the order matters because cells
+ *  interact (messages, division into neighboring cells, shared resources).
+ *
+ *  Strategies (cheapest last):
+ *    SHUFFLE            Fisher-Yates shuffle every cycle (one random draw per cell per cycle).
+ *    PERMUTATION_TABLE  Pick one of a fixed set of precomputed random permutations (one
+ *                       random draw per cycle). The table is shared by every deme.
+ *    ROTATE             Shuffle once per update; each cycle starts at a random offset
+ *                       into that permutation (one random draw per cycle).
+ *    FIXED              Cell id order (no random draws).
+ *
+ *  MeasureScheduleBias quantifies how far a strategy's orderings are from those
+ *  of a uniformly random permutation every cycle.
+ */
+
+#ifndef _CELL_SCHEDULE_H
+#define _CELL_SCHEDULE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "base/Ptr.h"
+#include "base/vector.h"
+#include "tools/Random.h"
+#include "tools/random_utils.h"
+
+enum class CellScheduleMode { SHUFFLE, PERMUTATION_TABLE, ROTATE, FIXED };
+
+/// Parse a CELL_SCHEDULE_MODE string. Returns false if mode_str isn't a known mode.
+bool ParseCellScheduleMode(const std::string & mode_str, CellScheduleMode & mode) {
+  if (mode_str == "shuffle") mode = CellScheduleMode::SHUFFLE;
+  else if (mode_str == "permutation-table") mode = CellScheduleMode::PERMUTATION_TABLE;
+  else if (mode_str == "rotate") mode = CellScheduleMode::ROTATE;
+  else if (mode_str == "fixed") mode = CellScheduleMode::FIXED;
+  else return false;
+  return true;
+}
+
+/// Precomputed random permutations of [0, num_cells) (immutable; shared by demes)
+class CellPermutationTable {
+protected:
+  size_t num_cells;
+  size_t num_perms;
+  emp::vector<uint32_t> perms;   ///< num_perms rows of num_cells cell ids
+
+public:
+  CellPermutationTable(emp::Random & rnd, size_t _num_cells, size_t _num_perms)
+    : num_cells(_num_cells), num_perms(_num_perms), perms(_num_cells * _num_perms)
+  {
+    emp_assert(num_perms > 0);
+    emp::vector<uint32_t> perm(num_cells);
+    for (size_t i = 0; i < num_cells; ++i) perm[i] = (uint32_t)i;
+    for (size_t p = 0; p < num_perms; ++p) {
+      emp::Shuffle(rnd, perm);
+      for (size_t i = 0; i < num_cells; ++i) perms[p * num_cells + i] = perm[i];
+    }
+  }
+
+  size_t GetNumCells() const { return num_cells; }
+  size_t GetNumPermutations() const { return num_perms; }
+
+  /// Get permutation p (num_cells entries)
+  const uint32_t * GetPermutation(size_t p) const { emp_assert(p < num_perms); return perms.data() + p * num_cells; }
+
+  /// Heap bytes held by the table
+  size_t GetMemoryBytes() const { return perms.capacity() * sizeof(uint32_t); }
+};
+
+/// Produces the order cells execute in, cycle by cycle
+class CellScheduler {
+protected:
+  CellScheduleMode mode = CellScheduleMode::SHUFFLE;
+  emp::Ptr<emp::Random> random_ptr;
+  emp::vector<size_t> order;                                ///< Current order (SHUFFLE, ROTATE, FIXED)
+  std::shared_ptr<const CellPermutationTable> perm_table;   ///< Permutations (PERMUTATION_TABLE)
+
+public:
+  CellScheduler(emp::Ptr<emp::Random> _rnd, size_t num_cells) : random_ptr(_rnd), order(num_cells) {
+    for (size_t i = 0; i < num_cells; ++i) order[i] = i;
+  }
+
+  CellScheduleMode GetMode() const { return mode; }
+  size_t GetNumCells() const { return order.size(); }
+
+  /// Set scheduling strategy. PERMUTATION_TABLE requires a table of permutations
+  /// over this scheduler's cells.
+  void SetMode(CellScheduleMode _mode, std::shared_ptr<const CellPermutationTable> table=nullptr) {
+    emp_assert(_mode != CellScheduleMode::PERMUTATION_TABLE || (table && table->GetNumCells() == order.size()));
+    mode = _mode;
+    perm_table = table;
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  }
+
+  /// Call at the start of every update (before that update's cycles)
+  void BeginUpdate() {
+    if (mode == CellScheduleMode::ROTATE) emp::Shuffle(*random_ptr, order);
+  }
+
+  /// Call fun(cell_id) for every cell, in this cycle's order
+  template<typename FUN>
+  void ForEachCell(FUN && fun) {
+    const size_t num_cells = order.size();
+    switch (mode) {
+      case CellScheduleMode::SHUFFLE:
+        emp::Shuffle(*random_ptr, order);
+        for (size_t id : order) fun(id);
+        break;
+      case CellScheduleMode::PERMUTATION_TABLE: {
+        const uint32_t * perm = perm_table->GetPermutation(random_ptr->GetUInt((uint32_t)perm_table->GetNumPermutations()));
+        for (size_t i = 0; i < num_cells; ++i) fun((size_t)perm[i]);
+        break;
+      }
+      case CellScheduleMode::ROTATE: {
+        const size_t start = random_ptr->GetUInt((uint32_t)num_cells);
+        for (size_t i = start; i < num_cells; ++i) fun(order[i]);
+        for (size_t i = 0; i < start; ++i) fun(order[i]);
+        break;
+      }
+      case CellScheduleMode::FIXED:
+        for (size_t id : order) fun(id);
+        break;
+    }
+  }
+
+  /// Heap bytes held by the scheduler (the shared permutation table isn't included)
+  size_t GetMemoryBytes() const { return order.capacity() * sizeof(size_t); }
+};
+
+/// How far a scheduler's orderings are from a fresh uniform permutation every cycle
+struct ScheduleBias {
+  /// Chi-square statistic (per degree of freedom) of the cell x position count
+  /// table against uniform. ~1 if every cell is equally likely at every position.
+  double position_chi2_per_dof = 0.0;
+  /// Largest deviation from 0.5 (over all cell pairs) of the fraction of cycles
+  /// where the lower-id cell runs before the higher-id cell.
+  double max_precedence_bias = 0.0;
+  /// Fraction of (pair, consecutive cycle) observations where a pair's relative
+  /// order is the same as it was on the previous cycle. 0.5 if cycles are independent.
+  double order_repeat_rate = 0.0;
+};
+
+/// Run the scheduler for updates x cycles_per_update cycles & measure its ordering bias
+ScheduleBias MeasureScheduleBias(CellScheduler & scheduler, size_t updates, size_t cycles_per_update) {
+  const size_t n = scheduler.GetNumCells();
+  const size_t num_cycles = updates * cycles_per_update;
+  emp::vector<size_t> position_counts(n * n, 0);  ///< [cell * n + position]
+  emp::vector<size_t> before_counts(n * n, 0);    ///< [i * n + j]: cycles where i ran before j (i < j)
+  emp::vector<size_t> position(n, 0);             ///< This cycle's position of each cell
+  emp::vector<bool> prev_before(n * n, false);
+  size_t repeats = 0;
+  size_t repeat_observations = 0;
+  for (size_t u = 0; u < updates; ++u) {
+    scheduler.BeginUpdate();
+    for (size_t c = 0; c < cycles_per_update; ++c) {
+      size_t pos = 0;
+      scheduler.ForEachCell([&](size_t id) { position[id] = pos++; });
+      emp_assert(pos == n);
+      const bool have_prev = (u || c);
+      for (size_t i = 0; i < n; ++i) {
+        ++position_counts[i * n + position[i]];
+        for (size_t j = i + 1; j < n; ++j) {
+          const bool before = position[i] < position[j];
+          before_counts[i * n + j] += (size_t)before;
+          if (have_prev) {
+            repeats += (size_t)(before == prev_before[i * n + j]);
+            ++repeat_observations;
+          }
+          prev_before[i * n + j] = before;
+        }
+      }
+    }
+  }
+  ScheduleBias bias;
+  if (n < 2 || num_cycles == 0) return bias;
+  const double expected = (double)num_cycles / (double)n;
+  double chi2 = 0.0;
+  for (size_t count : position_counts) chi2 += ((double)count - expected) * ((double)count - expected) / expected;
+  bias.position_chi2_per_dof = chi2 / (double)((n - 1) * (n - 1));
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = i + 1; j < n; ++j) {
+      const double frac = (double)before_counts[i * n + j] / (double)num_cycles;
+      const double dev = (frac > 0.5) ? frac - 0.5 : 0.5 - frac;
+      if (dev > bias.max_precedence_bias) bias.max_precedence_bias = dev;
+    }
+  }
+  bias.order_repeat_rate = (repeat_observations) ? (double)repeats / (double)repeat_observations : 0.0;
+  return bias;
+}
+
+#endif
@@ -11,8 +11,12 @@
 #ifndef _DOL_WORLD_H
 #define _DOL_WORLD_H
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <functional>
 #include <iostream>
+#include <memory>
 
 // Empirical includes
 #include "base/Ptr.h"
@@ -25,11 +29,19 @@
 
 // Local includes
 #include "DOLWorldConfig.h"
+#include "DecodedProgram.h"
 #include "DigitalOrganism.h"
 #include "Deme.h"
+#include "EventTrace.h"
+#include "GenomeIO.h"
+#include "GenomeTextParser.h"
+#include "MemoryUsage.h"
 #include "Mutator.h"
+#include "PhaseTimings.h"
 #include "Resource.h"
+#include "RunStatus.h"
 #include "Utilities.h"
+#include "WorkerPool.h"
 
 class DOLWorld : public emp::World<DigitalOrganism> {
 public:
@@ -48,8 +60,6 @@ public:
   using sgp_trait_ids_t = typename Deme::CellularHardware::SGPTraitIDs;
 
   using deme_seed_fun_t = std::function<void(Deme&, org_t&)>;
-  using consume_resource_fun_t = std::function<void(size_t,size_t,size_t)>;
-  using decay_resource_fun_t = std::function<void(size_t,size_t)>;
 
   using inst_attempt_cell_division_fun_t = std::function<void(size_t,size_t,const sgp_inst_t&)>;
 
@@ -76,8 +86,12 @@ protected:
   size_t CPU_CYCLES_PER_UPDATE;
   size_t INIT_POP_SIZE;
   size_t MAX_POP_SIZE;
+  size_t NUM_THREADS;
   std::string INIT_POP_MODE;
   std::string LOAD_ANCESTOR_INDIV_FPATH;
+  std::string LOAD_ANCESTOR_LIBRARY_FPATH;
+  std::string LOAD_POPULATION_FPATH;
+  std::string SAVE_POPULATION_FPATH;
   // RESOURCES Configuration Settings
   std::string RESOURCE_CONSUMPTION_MODE;
   std::string RESOURCE_DECAY_MODE;
@@ -100,6 +114,10 @@ protected:
   // DEME Configuration Settings
   size_t DEME_WIDTH;
   size_t DEME_HEIGHT;
+  std::string CELL_SCHEDULE_MODE;
+  size_t CELL_SCHEDULE_TABLE_SIZE;
+  std::string CELL_EXECUTION_MODE;
+  size_t CELL_BATCH_STEPS;
   // CELLULAR HARDWARE Configuration Settings
   size_t SGP_MAX_THREAD_CNT;
   size_t SGP_MAX_CALL_DEPTH;
@@ -125,30 +143,78 @@ protected:
   // REPRODUCTION Configuration Settings
   double DEME_REPRODUCTION_COST;
   double TISSUE_ACCRETION_COST;
+  // MONITORING Configuration Settings
+  bool TRACE_EVENTS;
+  std::string TRACE_FPATH;
+  size_t TRACE_KEYFRAME_INTERVAL;
+  size_t MEMORY_REPORT_INTERVAL;
+  std::string MEMORY_REPORT_FPATH;
+  bool MEMORY_REPORT_PER_DEME;
+  size_t STATUS_PORT;
+  std::string STATUS_SOCKET_FPATH;
+  bool PHASE_TIMING;
+  bool PHASE_TIMING_PER_UPDATE;
+  bool PHASE_TIMING_PER_DEME;
 
   // Non-configuration member variables
   bool setup = false;
 
   emp::Ptr<inst_lib_t> inst_lib;
   emp::Ptr<event_lib_t> event_lib;
+  emp::vector<DecodedProgram::BlockRole> inst_block_roles; ///< Block role of each instruction in inst_lib (used to decode programs)
 
   Mutator mutator;
+  org_t::genotype_store_t genotypes;   ///< Every living organism's genotype (interned on placement)
 
   emp::vector<Environment> environments;  ///< Each organism (and deme) is has a local environment
   emp::vector<tag_t> resource_tags;
   emp::vector<ResourceType> resource_types;
   size_t TOTAL_RESOURCES;
 
-  emp::vector<Deme> demes;
+  emp::vector<emp::Ptr<Deme>> demes; ///< Deme hardware for each population position (nullptr if unoccupied)
+  emp::vector<emp::Ptr<Deme>> deme_pool; ///< Deactivated deme hardware waiting to be reused
   emp::vector<size_t> birth_chamber; ///< IDs of organisms ready to reproduce!
+  emp::vector<emp::Ptr<org_t>> birth_offspring; ///< Offspring built for each birth chamber entry (see DoBirths)
+  emp::vector<org_t::genotype_t> birth_parent_genotypes; ///< Parent genotype each birth chamber entry's offspring was built from (see DoBirths)
+  emp::vector<int> birth_seeds;                 ///< Random seed for each birth chamber entry (see DoBirths)
+  emp::vector<emp::Random> birth_randoms;       ///< One random number generator per worker thread (see DoBirths)
+
+  CellScheduleMode cell_schedule_mode=CellScheduleMode::SHUFFLE;       ///< How do demes order cell execution? (CELL_SCHEDULE_MODE)
+  std::shared_ptr<const CellPermutationTable> cell_permutations;      ///< Permutations shared by every deme (permutation-table mode)
+  CellExecutionMode cell_execution_mode=CellExecutionMode::INTERLEAVED; ///< How do demes step cells through an update? (CELL_EXECUTION_MODE)
+
+  emp::Ptr<WorkerPool> worker_pool=nullptr;   ///< Threads demes are advanced on (NUM_THREADS)
+  /// Trace lane for events recorded outside AdvanceDemes: 0 before demes advance,
+  /// NUM_THREADS+1 after. While demes advance, each deme records to its worker
+  /// thread's lane (see GetTraceLane).
+  size_t trace_lane = 0;
+  bool advancing_demes = false;     ///< Are demes advancing on the worker pool? (see GetTraceLane)
 
   deme_seed_fun_t fun_seed_deme;
 
-  consume_resource_fun_t fun_consume_resource;
-  consume_resource_fun_t fun_consume_fail;
-  decay_resource_fun_t fun_decay_resource;
+  emp::Ptr<EventTrace> trace;       ///< Event trace recorder (nullptr if not tracing)
+  EventTrace::State trace_state;    ///< Scratch state used to write trace keyframes
+
+  std::ofstream memory_report_stream; ///< Memory report output (open only if reporting memory usage)
+  MemoryReport memory_report;         ///< Scratch report reused by every memory sample
+
+  using status_clock_t = std::chrono::steady_clock;
+  bool publish_status=false;          ///< Publish a RunStatus every update? (STATUS_PORT/STATUS_SOCKET_FPATH)
+  StatusBoard status_board;           ///< Latest published status (read by monitoring threads)
+  RunStatus run_status;               ///< Status being assembled for the next publish
+  status_clock_t::time_point status_start_time;    ///< When the world was set up
+  status_clock_t::time_point status_window_time;   ///< Start of the current updates/sec window
+  size_t status_window_update=0;                   ///< Update at the start of the current updates/sec window
+  PhaseTimings phase_timings;         ///< Time spent in each phase of RunStep (PHASE_TIMING, or for status)
+
+  ResourcePolicyType consumption_policy=ResourcePolicyType::FIXED; ///< How are resources consumed? (RESOURCE_CONSUMPTION_MODE)
+  ResourcePolicyType decay_policy=ResourcePolicyType::FIXED;       ///< How do periodic resources decay? (RESOURCE_DECAY_MODE)
+  emp::vector<double> resource_consume_amounts; ///< Amount (or proportion) of each resource collected by a successful metabolize
+  emp::vector<double> resource_failure_costs;   ///< Cost of attempting to metabolize each resource while it's unavailable
+  double periodic_decay_amount=0.0;             ///< Amount (or proportion) of an available periodic resource that decays each update
 
   inst_attempt_cell_division_fun_t fun_instruction_attempted_cell_division; ///< What an instruction calls when it attempts to trigger cell division
+  Deme::metabolize_fun_t fun_resolve_metabolism; ///< Resolves metabolize attempts buffered by cell-major demes (see Deme.h)
 
   sgp_event_handler_fun_t fun_handle_msg;
   sgp_event_dispatcher_fun_t fun_dispatch_broadcast_msg;
@@ -159,15 +225,87 @@ protected:
   void InitPop(DOLWorldConfig & config);
   void InitPop_Random(DOLWorldConfig & config);
   void InitPop_LoadIndividual(DOLWorldConfig & config);
+  void InitPop_LoadLibrary(DOLWorldConfig & config);
+  void InitPop_LoadPopulation(DOLWorldConfig & config);
+  void LoadGenomeFile(const std::string & path, emp::vector<org_t::Genome> & genomes);
 
   void SetupDemeHardware();
+  void SetupWorkerPool();
+  void SetupCellSchedule();
+  void ClearDemeHardware();
   void SetupInstructionSet();
   void SetupEventSet();
   void SetupEnvironment();
+  void SetupResourcePolicies();
+  void SetupTrace();
+  void SetupMemoryReport();
+  void SetupStatus();
+
+  /// Fill in the rest of run_status (phase timings are already set) and publish it
+  void PublishStatus();
+
+  /// Advance every deme on the worker pool (see RunStep)
+  void AdvanceDemes();
+
+  /// Reproduce every organism in the birth chamber, building offspring on the worker pool (see RunStep)
+  void DoBirths();
+
+  /// Prepare a new offspring for placement (mutate & reset phenotype), using the
+  /// given random number generator. Runs before any offspring-ready handler (see DoBirths).
+  void PrepareOffspring(org_t & offspring, emp::Random & rnd) {
+    mutator.Mutate(offspring, rnd);
+    offspring.GetPhenotype().Reset(TOTAL_RESOURCES);
+  }
+
+  /// Trace lane to record an event at population position pos to (only valid if
+  /// tracing). While demes advance, that's the lane of the worker thread advancing
+  /// pos (1+t), so lanes are flushed in population order.
+  EventTrace::Lane & GetTraceLane(size_t pos) {
+    emp_assert(trace != nullptr);
+    if (!advancing_demes) return trace->GetLane(trace_lane);
+    return trace->GetLane(1 + worker_pool->GetThreadFor(pos, pop.size()));
+  }
+
+  /// Build and configure deme hardware for the given population position
+  emp::Ptr<Deme> NewDeme(size_t deme_id);
+
+  /// Get deme hardware for the given population position (recycled if possible)
+  emp::Ptr<Deme> AcquireDeme(size_t deme_id);
+
+  /// Deactivate deme hardware at the given population position and return it to the pool
+  void ReleaseDeme(size_t deme_id);
+
+  /// Block instructions that jump using the executing deme's decoded program
+  /// (behave like sgp_hardware_t::Inst_If/Inst_While/Inst_Countdown)
+  void Inst_If(sgp_hardware_t & hw, const sgp_inst_t & inst);
+  void Inst_While(sgp_hardware_t & hw, const sgp_inst_t & inst);
+  void Inst_Countdown(sgp_hardware_t & hw, const sgp_inst_t & inst);
+
+  /// Add resource-specific instructions (metabolize & sensors) to the instruction
+  /// set, with metabolize instructions specialized on CONSUME_POLICY
+  template<typename CONSUME_POLICY>
+  void SetupResourceInstructions();
 
-  /// Attempt to metabolize resource
+  /// Get the end of the block opened by the instruction that hw is currently executing
+  size_t GetCurBlockEnd(sgp_hardware_t & hw) {
+    const size_t world_id = (size_t)hw.GetTrait(sgp_trait_ids_t::TRAIT_ID__DEME_ID);
+    const sgp_hardware_t::State & state = hw.GetCurState();
+    // Note: the instruction pointer has already advanced past the executing instruction.
+    emp_assert(state.GetIP() > 0);
+    return GetDeme(world_id).GetDecodedProgram().GetBlockEnd(state.GetFP(), state.GetIP() - 1);
+  }
+
+  /// Attempt to metabolize resource (consuming it according to CONSUME_POLICY).
+  /// Inside a cell-major batch, the attempt is buffered & resolved (by Metabolize)
+  /// at the end of the batch.
+  template<typename CONSUME_POLICY>
   void AttemptToMetabolize(size_t org_id, size_t cell_id, size_t resource_id);
 
+  /// Metabolize resource (consuming it according to CONSUME_POLICY). Collected
+  /// resources go to the cell's local reservoir only if credit_cell.
+  template<typename CONSUME_POLICY>
+  void Metabolize(size_t org_id, size_t cell_id, size_t resource_id, bool credit_cell=true);
+
   /// Helper function to set cell sensor
   void SetCellSensor(size_t org_id, size_t cell_id, size_t resource_id, bool value);
   bool IsCellSensing(size_t org_id, size_t cell_id, size_t resource_id);
@@ -188,6 +326,7 @@ protected:
     Resource & res = local_env.resources[res_id];
     // Replinish the pulsing resource!
     res.SetAmount(PERIODIC_RESOURCES__LEVEL);
+    if (trace) GetTraceLane(env_id).Pulse(env_id, res_id);
 
     // We only need to alert the organism/deme if this position of the population
     // is occupied
@@ -197,22 +336,25 @@ protected:
     org_t & org = GetOrg(env_id);
     Deme & deme = GetDeme(env_id);
 
-    // For any cells that are sensing, alert them!
-    for (size_t cell_id = 0; cell_id < deme.GetCellCapacity(); ++cell_id) {
-      // If cell isn't active, we don't need to worry about it
-      if (!deme.IsCellActive(cell_id)) continue;
-      // Cell is active, is it sensing for this resource?
-      if (!deme.IsCellSensingResource(cell_id, res_id)) continue;
-      // Cell is active & sensing for this resource! Alert!
-      // std::cout << "Spawning core on cell!" << std::endl;
+    // For any cells that are active & sensing for this resource, alert them!
+    deme.ForEachCellSensing(res_id, [this, &org, &deme, res_id](size_t cell_id) {
       deme.GetCell(cell_id).sgp_hw.SpawnCore(resource_tags[res_id], SGP_MIN_TAG_MATCH_THRESHOLD);
       // - cell_hw.sgp_hw.TriggerEvent(resource_alert, resource_tag)
       // Track that this organism received a signal for this resource!
       org.GetPhenotype().resource_alerts_received_by_type[res_id]++;
-    }
+    });
   }
 
   /// Advance the all environment states
+  void AdvanceEnvironment() {
+    switch (decay_policy) {
+      case ResourcePolicyType::FIXED: AdvanceEnvironment<FixedResourcePolicy>(); break;
+      case ResourcePolicyType::PROPORTIONAL: AdvanceEnvironment<ProportionalResourcePolicy>(); break;
+    }
+  }
+
+  /// Advance the all environment states (decaying periodic resources according to DECAY_POLICY)
+  template<typename DECAY_POLICY>
   void AdvanceEnvironment() {
     for (size_t env_id = 0; env_id < environments.size(); ++env_id) {
       // We only need to advance the environment for active organisms!
@@ -230,7 +372,7 @@ protected:
           if (res.IsAvailable()) {
             // If resource has been available for at least as long as the decay delay, decay the resource!
             if (res.GetTimeAvailable() >= PERIODIC_RESOURCES__DECAY_DELAY) {
-              fun_decay_resource(env_id, res_id);
+              DECAY_POLICY::Decay(res, periodic_decay_amount);
             }
           } else {
             // Pulse resource (maybe)!
@@ -247,12 +389,14 @@ protected:
   }
 
 public:
-
   DOLWorld() {}
   DOLWorld(emp::Random & r) : emp::World<org_t>(r) {}
 
   ~DOLWorld() {
+    CloseTrace();
+    if (worker_pool) worker_pool.Delete();
     if (setup) {
+      ClearDemeHardware();
       inst_lib.Delete();
       event_lib.Delete();
       on_death_sig.Clear(); // Weird design pattern issue => on death triggers stuff in the derived class, but derived class is deleted by the time base class destructor is run!
@@ -263,21 +407,70 @@ public:
   size_t GetDemeWidth() const { return DEME_WIDTH; };
   size_t GetDemeHeight() const { return DEME_HEIGHT; };
   size_t GetDemeCapacity() const { return DEME_WIDTH * DEME_HEIGHT; };
+  size_t GetNumResources() const { return TOTAL_RESOURCES; }
+  size_t GetNumStaticResources() const { return NUM_STATIC_RESOURCES; }
+
+  /// Does position ID have deme hardware? (hardware is allocated on first placement)
+  bool HasDeme(size_t id) const { return demes[id] != nullptr; }
 
   /// Get deme @ position ID
-  Deme & GetDeme(size_t id) { return demes[id]; }
-  const Deme & GetDeme(size_t id) const { return demes[id]; }
+  Deme & GetDeme(size_t id) { emp_assert(HasDeme(id)); return *demes[id]; }
+  const Deme & GetDeme(size_t id) const { emp_assert(HasDeme(id)); return *demes[id]; }
 
   /// Get local environment @ position ID
   Environment & GetEnvironment(size_t id) { return environments[id]; }
   const Environment & GetEnvironment(size_t id) const { return environments[id]; }
 
-  /// Just give 'em access to all da demes!
-  emp::vector<Deme> & GetDemes() { return demes; }
+  /// Get the SignalGP instruction library shared by all deme hardware
+  const inst_lib_t & GetInstLib() const { return *inst_lib; }
+
+  /// How many deactivated demes are waiting to be reused?
+  size_t GetDemePoolSize() const { return deme_pool.size(); }
+
+  /// Genotypes of the living population (with abundances)
+  const org_t::genotype_store_t & GetGenotypeStore() const { return genotypes; }
+
+  /// Just give 'em access to all da demes! (unoccupied positions may not have hardware)
+  emp::vector<emp::Ptr<Deme>> & GetDemes() { return demes; }
 
   void Reset(DOLWorldConfig & config);
   void Setup(DOLWorldConfig & config);
 
+  /// Is this world recording an event trace?
+  bool IsTracing() const { return trace != nullptr; }
+
+  /// Finish (flush & index) and close the event trace (if tracing)
+  void CloseTrace() {
+    if (trace == nullptr) return;
+    trace->Close();
+    trace.Delete();
+    trace = nullptr;
+  }
+
+  /// Save every living organism's genome (and position) to a binary population file
+  /// (see GenomeIO.h). Returns false on failure.
+  bool SavePopulation(const std::string & path) const;
+
+  /// Capture the trace-replayable state of the world (see EventTrace::State)
+  void CaptureTraceState(EventTrace::State & state) const;
+
+  /// Status published by the simulation thread after every update (only if
+  /// STATUS_PORT or STATUS_SOCKET_FPATH is set; see StatusServer.h)
+  const StatusBoard & GetStatusBoard() const { return status_board; }
+
+  /// Time spent in each phase of RunStep, last update & cumulative (kept if
+  /// PHASE_TIMING, PHASE_TIMING_PER_DEME, or publishing status)
+  const PhaseTimings & GetPhaseTimings() const { return phase_timings; }
+
+  /// Finish and close the memory report (if reporting memory usage)
+  void CloseMemoryReport() {
+    if (memory_report_stream.is_open()) memory_report_stream.close();
+  }
+
+  /// Measure bytes used by each deme (genome, phenotype, environment, & deme
+  /// hardware) and by the population as a whole (see MemoryUsage.h)
+  void MeasureMemory(MemoryReport & report);
+
   void RunStep();
   void Run();
 
@@ -289,32 +482,62 @@ public:
 //                          DOLWorld member definitions
 // =============================================================================
 
+template<typename CONSUME_POLICY>
 void DOLWorld::AttemptToMetabolize(size_t org_id, size_t cell_id, size_t resource_id) {
   emp_assert(org_id < GetSize());
   emp_assert(resource_id < TOTAL_RESOURCES);
   emp_assert(cell_id < DEME_WIDTH * DEME_HEIGHT);
   Deme & deme = GetDeme(org_id);
   Deme::CellularHardware & cell_hw = deme.GetCell(cell_id);
+  // Only allow one attempt per update?
+  if (cell_hw.HasMetabolized(resource_id)) return;
+  if (deme.IsBuffering()) {
+    deme.DeferMetabolism(cell_id, resource_id);
+  } else {
+    Metabolize<CONSUME_POLICY>(org_id, cell_id, resource_id);
+  }
+  // Mark that we've attempted to consume!
+  cell_hw.SetMetabolized(resource_id);
+}
+
+template<typename CONSUME_POLICY>
+void DOLWorld::Metabolize(size_t org_id, size_t cell_id, size_t resource_id, bool credit_cell) {
+  emp_assert(org_id < GetSize());
+  emp_assert(resource_id < TOTAL_RESOURCES);
+  Deme::CellularHardware & cell_hw = GetDeme(org_id).GetCell(cell_id);
   Environment & local_env = GetEnvironment(org_id);
   Resource & res_state = local_env.resources[resource_id];
-  // Only allow one attempt per update?
-  if (cell_hw.metabolized_on_advance[resource_id]) return;
+  org_t & org = GetOrg(org_id);
+  org_t::Phenotype & phen = org.GetPhenotype();
+  emp_assert(resource_id < phen.consumption_amount_by_type.size());
+  emp_assert(resource_id < phen.consumption_successes_by_type.size());
   // Attempt to consume!
   if (res_state.IsAvailable()) {
-    // Attempt to consume resource
-    fun_consume_resource(org_id, cell_id, resource_id);
+    // Collect those sweet delicious resources!
+    const double collected = CONSUME_POLICY::Consume(res_state, resource_consume_amounts[resource_id]);
+    if (credit_cell) cell_hw.local_resources += collected;
+    phen.total_resources_collected += collected;
+    // Track consumption info
+    phen.consumption_amount_by_type[resource_id] += collected;
+    phen.consumption_successes_by_type[resource_id] += 1;
+    if (trace) GetTraceLane(org_id).Metabolize(org_id, cell_id, resource_id, true, collected);
   } else {
     // Apply cost of attempting to metabolize unavailable resource
-    fun_consume_fail(org_id, cell_id, resource_id);
+    // (i.e., a misqueue? => attempted consumption when resource is unavailable)
+    phen.resource_pool -= resource_failure_costs[resource_id];
+    // Don't let organism get into resource debt!
+    if (phen.resource_pool < 0) phen.resource_pool = 0.0;
+    // Track consumption misqueue
+    phen.consumption_failures_by_type[resource_id]++;
+    if (trace) GetTraceLane(org_id).Metabolize(org_id, cell_id, resource_id, false, 0.0);
   }
-  // Mark that we've attempted to consume!
-  cell_hw.metabolized_on_advance[resource_id] = true;
 }
 
 void DOLWorld::SetCellSensor(size_t org_id, size_t cell_id, size_t resource_id, bool value) {
   Deme & deme = GetDeme(org_id);
   Deme::CellularHardware & cell_hw = deme.GetCell(cell_id);
   cell_hw.SetResourceSensor(resource_id, value);
+  if (trace) GetTraceLane(org_id).Sensor(org_id, cell_id, resource_id, value);
 }
 
 bool DOLWorld::IsCellSensing(size_t org_id, size_t cell_id, size_t resource_id) {
@@ -323,6 +546,55 @@ bool DOLWorld::IsCellSensing(size_t org_id, size_t cell_id, size_t resource_id)
   return cell_hw.IsSensingResource(resource_id);
 }
 
+/// If local memory Arg1 != 0, enter block; otherwise, skip to end of block.
+void DOLWorld::Inst_If(sgp_hardware_t & hw, const sgp_inst_t & inst) {
+  sgp_hardware_t::State & state = hw.GetCurState();
+  const size_t fp = state.GetFP();
+  const size_t eob = GetCurBlockEnd(hw);
+  if (state.AccessLocal(inst.args[0]) == 0.0) {
+    // Skip to EOB
+    state.SetIP(eob);
+    // Advance past the block close if not at end of function
+    if (hw.ValidPosition(fp, eob)) state.AdvanceIP();
+  } else {
+    // Open BLOCK
+    hw.OpenBlock(state.GetIP(), eob, sgp_hardware_t::BlockType::BASIC);
+  }
+}
+
+/// If local memory Arg1 != 0, loop; otherwise, skip to end of block.
+void DOLWorld::Inst_While(sgp_hardware_t & hw, const sgp_inst_t & inst) {
+  sgp_hardware_t::State & state = hw.GetCurState();
+  const size_t fp = state.GetFP();
+  const size_t eob = GetCurBlockEnd(hw);
+  if (state.AccessLocal(inst.args[0]) == 0.0) {
+    // Skip to EOB
+    state.SetIP(eob);
+    // Advance past the block close if not at end of function
+    if (hw.ValidPosition(fp, eob)) state.AdvanceIP();
+  } else {
+    // Open LOOP (begins at the While so that the condition is re-checked)
+    hw.OpenBlock(state.GetIP() - 1, eob, sgp_hardware_t::BlockType::LOOP);
+  }
+}
+
+/// Countdown local memory Arg1 to zero, looping over the block until it gets there.
+void DOLWorld::Inst_Countdown(sgp_hardware_t & hw, const sgp_inst_t & inst) {
+  sgp_hardware_t::State & state = hw.GetCurState();
+  const size_t fp = state.GetFP();
+  const size_t eob = GetCurBlockEnd(hw);
+  if (state.AccessLocal(inst.args[0]) == 0.0) {
+    // Skip to EOB
+    state.SetIP(eob);
+    // Advance past the block close if not at end of function
+    if (hw.ValidPosition(fp, eob)) state.AdvanceIP();
+  } else {
+    // Decrement Arg1 & open LOOP
+    --state.AccessLocal(inst.args[0]);
+    hw.OpenBlock(state.GetIP() - 1, eob, sgp_hardware_t::BlockType::LOOP);
+  }
+}
+
 /// Localize configuration settings.
 void DOLWorld::InitConfigs(DOLWorldConfig & config) {
   // MAIN Configuration Settings
@@ -330,8 +602,12 @@ void DOLWorld::InitConfigs(DOLWorldConfig & config) {
   CPU_CYCLES_PER_UPDATE = config.CPU_CYCLES_PER_UPDATE();
   INIT_POP_SIZE = config.INIT_POP_SIZE();
   MAX_POP_SIZE = config.MAX_POP_SIZE();
+  NUM_THREADS = config.NUM_THREADS();
   INIT_POP_MODE = config.INIT_POP_MODE();
   LOAD_ANCESTOR_INDIV_FPATH = config.LOAD_ANCESTOR_INDIV_FPATH();
+  LOAD_ANCESTOR_LIBRARY_FPATH = config.LOAD_ANCESTOR_LIBRARY_FPATH();
+  LOAD_POPULATION_FPATH = config.LOAD_POPULATION_FPATH();
+  SAVE_POPULATION_FPATH = config.SAVE_POPULATION_FPATH();
   // RESOURCES Configuration Settings
   NUM_PERIODIC_RESOURCES = config.NUM_PERIODIC_RESOURCES();
   NUM_STATIC_RESOURCES = config.NUM_STATIC_RESOURCES();
@@ -354,6 +630,10 @@ void DOLWorld::InitConfigs(DOLWorldConfig & config) {
   // DEME Configuration Settings
   DEME_WIDTH = config.DEME_WIDTH();
   DEME_HEIGHT = config.DEME_HEIGHT();
+  CELL_SCHEDULE_MODE = config.CELL_SCHEDULE_MODE();
+  CELL_SCHEDULE_TABLE_SIZE = config.CELL_SCHEDULE_TABLE_SIZE();
+  CELL_EXECUTION_MODE = config.CELL_EXECUTION_MODE();
+  CELL_BATCH_STEPS = config.CELL_BATCH_STEPS();
   // CELLULAR HARDWARE Configuration Settings
   SGP_MAX_THREAD_CNT = config.SGP_MAX_THREAD_CNT();
   SGP_MAX_CALL_DEPTH = config.SGP_MAX_CALL_DEPTH();
@@ -379,6 +659,18 @@ void DOLWorld::InitConfigs(DOLWorldConfig & config) {
   // REPRODUCTION Configuration Settings
   DEME_REPRODUCTION_COST = config.DEME_REPRODUCTION_COST();
   TISSUE_ACCRETION_COST = config.TISSUE_ACCRETION_COST();
+  // MONITORING Configuration Settings
+  TRACE_EVENTS = config.TRACE_EVENTS();
+  TRACE_FPATH = config.TRACE_FPATH();
+  TRACE_KEYFRAME_INTERVAL = config.TRACE_KEYFRAME_INTERVAL();
+  MEMORY_REPORT_INTERVAL = config.MEMORY_REPORT_INTERVAL();
+  MEMORY_REPORT_FPATH = config.MEMORY_REPORT_FPATH();
+  MEMORY_REPORT_PER_DEME = config.MEMORY_REPORT_PER_DEME();
+  STATUS_PORT = config.STATUS_PORT();
+  STATUS_SOCKET_FPATH = config.STATUS_SOCKET_FPATH();
+  PHASE_TIMING = config.PHASE_TIMING();
+  PHASE_TIMING_PER_UPDATE = config.PHASE_TIMING_PER_UPDATE();
+  PHASE_TIMING_PER_DEME = config.PHASE_TIMING_PER_DEME();
   // Various constants that depend on configuration parameters
   TOTAL_RESOURCES = NUM_PERIODIC_RESOURCES + NUM_STATIC_RESOURCES;
   // Verify some requirements
@@ -395,6 +687,10 @@ void DOLWorld::InitPop(DOLWorldConfig & config) {
     InitPop_Random(config);
   } else if (INIT_POP_MODE == "load-single") {
     InitPop_LoadIndividual(config);
+  } else if (INIT_POP_MODE == "load-library") {
+    InitPop_LoadLibrary(config);
+  } else if (INIT_POP_MODE == "load-population") {
+    InitPop_LoadPopulation(config);
   } else {
     emp_assert(false, "Invalid INIT_POP_MODE (", INIT_POP_MODE, "). Exiting.");
     exit(-1);
@@ -421,52 +717,23 @@ void DOLWorld::InitPop_Random(DOLWorldConfig & config) {
 void DOLWorld::InitPop_LoadIndividual(DOLWorldConfig & config) {
   std::cout << "Initializing population from single-ancestor file!" << std::endl;
 
-  // Configure the ancestor program.
-  sgp_program_t ancestor_prog(inst_lib);
-  tag_t birth_tag;
-  std::ifstream ancestor_fstream(LOAD_ANCESTOR_INDIV_FPATH);
-  if (!ancestor_fstream.is_open()) {
-    std::cout << "Failed to open ancestor program file(" << LOAD_ANCESTOR_INDIV_FPATH << "). Exiting..." << std::endl;
-    exit(-1);
+  // Load the ancestor (the first genome record in the file)
+  emp::vector<org_t::Genome> ancestors;
+  LoadGenomeFile(LOAD_ANCESTOR_INDIV_FPATH, ancestors);
+  if (ancestors.size() > 1) {
+    std::cout << "Ancestor file (" << LOAD_ANCESTOR_INDIV_FPATH << ") contains " << ancestors.size()
+              << " genomes; using the first." << std::endl;
   }
+  org_t::Genome & ancestor_genome = ancestors[0];
 
-  // Get the birth(day) tag!
-  std::string cur_line;
-  while (!ancestor_fstream.eof()) {
-    std::getline(ancestor_fstream, cur_line);
-    emp::remove_whitespace(cur_line);
-    if (cur_line == emp::empty_string()) continue;
-    // Are we looking at the BIRTH tag?
-    std::string birth_prefix = emp::to_lower(emp::string_get_range(cur_line, 0, 5));
-    if (birth_prefix == "birth") {
-      size_t tag_begin = cur_line.find_first_of('[');
-      size_t tag_end = cur_line.find_first_of(']');
-      if ((tag_begin != std::string::npos) && (tag_end != std::string::npos) && (tag_begin < tag_end)) {
-        // Found tag.
-        std::string tag_str = emp::string_get_range(cur_line, tag_begin+1, tag_end-(tag_begin+1));
-        for (size_t i = 0; i < tag_str.size(); ++i) {
-          if (i >= birth_tag.GetSize()) break;
-          if (tag_str[i] == '1') birth_tag.Set(birth_tag.GetSize() - i - 1, true);
-        }
-      }
-      break;
-    } else {
-      std::cout << "FAILED TO FIND BIRTH TAG! EXITING" << std::endl;
-      exit(-1);
-    }
-  }
   // Here's the birth tag:
   std::cout << " --- Ancestor birth tag: ---" << std::endl;
-  birth_tag.Print();
+  ancestor_genome.birth_tag.Print();
   std::cout << std::endl;
-
-  // Load the ancestor program
-  ancestor_prog.Load(ancestor_fstream);
   std::cout << " --- Ancestor program: ---" << std::endl;
-  ancestor_prog.PrintProgramFull();
+  ancestor_genome.program.PrintProgramFull();
   std::cout << " -------------------------" << std::endl;
 
-  DigitalOrganism::Genome ancestor_genome(ancestor_prog, birth_tag);
   emp_assert(ValidateDigitalOrganismGenome(config, ancestor_genome), "Loaded ancestor does not comply with configured requirements.");
   // todo - tie ancestry together!
 
@@ -476,23 +743,173 @@ void DOLWorld::InitPop_LoadIndividual(DOLWorldConfig & config) {
   }
 }
 
+/// Initialize the population from a library of ancestors (multi-genome text file).
+/// Ancestors are assigned to population positions [0, INIT_POP_SIZE) round-robin.
+void DOLWorld::InitPop_LoadLibrary(DOLWorldConfig & config) {
+  std::cout << "Initializing population from ancestor library!" << std::endl;
+  emp::vector<org_t::Genome> ancestors;
+  LoadGenomeFile(LOAD_ANCESTOR_LIBRARY_FPATH, ancestors);
+  std::cout << "Loaded " << ancestors.size() << " ancestors from " << LOAD_ANCESTOR_LIBRARY_FPATH << std::endl;
+  emp_assert(INIT_POP_SIZE <= MAX_POP_SIZE, "INIT_POP_SIZE (", INIT_POP_SIZE, ") cannot exceed MAX_POP_SIZE (", MAX_POP_SIZE, ")!");
+  for (size_t i = 0; i < INIT_POP_SIZE; ++i) {
+    const org_t::Genome & ancestor_genome = ancestors[i % ancestors.size()];
+    emp_assert(ValidateDigitalOrganismGenome(config, ancestor_genome), "Loaded ancestor does not comply with configured requirements.");
+    InjectAt(ancestor_genome, i);
+  }
+}
+
+/// Load every genome in a text genome file. Exits (reporting the offending line)
+/// if the file can't be parsed or holds no genomes.
+void DOLWorld::LoadGenomeFile(const std::string & path, emp::vector<org_t::Genome> & genomes) {
+  GenomeTextParser parser(*inst_lib);
+  if (!parser.ParseFile(path, genomes)) {
+    const GenomeTextParser::Error & err = parser.GetError();
+    std::cout << path;
+    if (err.line) std::cout << ":" << err.line;
+    std::cout << ": " << err.message << " Exiting..." << std::endl;
+    exit(-1);
+  }
+  if (genomes.empty()) {
+    std::cout << "Genome file (" << path << ") contains no genomes. Exiting..." << std::endl;
+    exit(-1);
+  }
+}
+
+/// Initialize the population from a (binary) population file
+void DOLWorld::InitPop_LoadPopulation(DOLWorldConfig & config) {
+  std::cout << "Initializing population from population file!" << std::endl;
+  GenomeIO::PopulationReader reader;
+  if (!reader.Load(LOAD_POPULATION_FPATH, *inst_lib, std::cout)) {
+    std::cout << "Failed to load population file (" << LOAD_POPULATION_FPATH << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  for (const GenomeIO::PopulationEntry & entry : reader.GetEntries()) {
+    if (entry.position >= MAX_POP_SIZE) {
+      std::cout << "Population file position (" << entry.position << ") exceeds MAX_POP_SIZE (" << MAX_POP_SIZE << "). Exiting..." << std::endl;
+      exit(-1);
+    }
+    if (IsOccupied(entry.position)) {
+      std::cout << "Population file has more than one organism at position " << entry.position << ". Exiting..." << std::endl;
+      exit(-1);
+    }
+    if (!ValidateDigitalOrganismGenome(config, entry.genome)) {
+      std::cout << "Population file organism at position " << entry.position << " does not comply with configured requirements. Exiting..." << std::endl;
+      exit(-1);
+    }
+    InjectAt(entry.genome, entry.position);
+  }
+  std::cout << "Loaded " << reader.GetSize() << " organisms from " << LOAD_POPULATION_FPATH << std::endl;
+}
+
+bool DOLWorld::SavePopulation(const std::string & path) const {
+  GenomeIO::PopulationWriter writer(*inst_lib);
+  for (size_t pos = 0; pos < pop.size(); ++pos) {
+    if (!IsOccupied(pos)) continue;
+    writer.Add(pos, GetOrg(pos).GetGenome());
+  }
+  return writer.Save(path);
+}
+
 /// Setup the Deme Hardware (only called by DOLWorld::Setup)
+/// - Deme hardware is not built here; each population position gets its hardware
+///   when an organism is placed there (see AcquireDeme) and gives it back to
+///   the deme pool when that organism dies (see ReleaseDeme).
 void DOLWorld::SetupDemeHardware() {
   std::cout << "DOLWorld - Setup - DemeHardware" << std::endl;
+  ClearDemeHardware();
+  demes.resize(MAX_POP_SIZE); // One (empty) slot for every possible member of the population
+  SetupCellSchedule();
+  SetupWorkerPool();
+}
+
+/// Start the threads demes are advanced on (reuses the current pool if it's the right size)
+void DOLWorld::SetupWorkerPool() {
+  if (NUM_THREADS == 0) {
+    std::cout << "NUM_THREADS must be > 0! Exiting." << std::endl;
+    exit(-1);
+  }
+  if (!worker_pool || worker_pool->GetNumThreads() != NUM_THREADS) {
+    if (worker_pool) worker_pool.Delete();
+    worker_pool = emp::NewPtr<WorkerPool>(NUM_THREADS);
+    if (worker_pool->GetNumThreads() != NUM_THREADS) {
+      std::cout << "Threads unavailable in this build; running demes on " << worker_pool->GetNumThreads() << " thread." << std::endl;
+    }
+  }
+  birth_randoms.resize(worker_pool->GetNumThreads());
+}
+
+/// Configure how demes order & step cell execution (applied as deme hardware is built)
+void DOLWorld::SetupCellSchedule() {
+  cell_permutations = nullptr;
+  if (!ParseCellExecutionMode(CELL_EXECUTION_MODE, cell_execution_mode)) {
+    std::cout << "Unrecognized CELL_EXECUTION_MODE (" << CELL_EXECUTION_MODE << ")! Exiting." << std::endl;
+    exit(-1);
+  }
+  if (cell_execution_mode == CellExecutionMode::CELL_MAJOR && CELL_BATCH_STEPS == 0) {
+    std::cout << "CELL_BATCH_STEPS must be > 0 for cell-major execution! Exiting." << std::endl;
+    exit(-1);
+  }
+  if (!ParseCellScheduleMode(CELL_SCHEDULE_MODE, cell_schedule_mode)) {
+    std::cout << "Unrecognized CELL_SCHEDULE_MODE (" << CELL_SCHEDULE_MODE << ")! Exiting." << std::endl;
+    exit(-1);
+  }
+  if (cell_schedule_mode == CellScheduleMode::PERMUTATION_TABLE) {
+    if (CELL_SCHEDULE_TABLE_SIZE == 0) {
+      std::cout << "CELL_SCHEDULE_TABLE_SIZE must be > 0 for permutation-table scheduling! Exiting." << std::endl;
+      exit(-1);
+    }
+    cell_permutations = std::make_shared<CellPermutationTable>(*random_ptr, DEME_WIDTH * DEME_HEIGHT, CELL_SCHEDULE_TABLE_SIZE);
+  }
+}
+
+/// Free all allocated deme hardware (including pooled hardware)
+void DOLWorld::ClearDemeHardware() {
+  for (emp::Ptr<Deme> deme : demes) {
+    if (deme != nullptr) deme.Delete();
+  }
+  for (emp::Ptr<Deme> deme : deme_pool) {
+    deme.Delete();
+  }
   demes.clear();
-  // Add one deme hardware unit for every possible member of the population
-  for (size_t i = 0; i < MAX_POP_SIZE; ++i) {
-    /*Deme(size_t _width, size_t _height, emp::Ptr<emp::Random> _rnd,
-           emp::Ptr<inst_lib_t> _inst_lib, emp::Ptr<event_lib_t> _event_lib)*/
-    demes.emplace_back(DEME_WIDTH, DEME_HEIGHT, random_ptr, inst_lib, event_lib);
-    demes.back().SetDemeID(i); // Associate deme with particular position in pop vector
-    demes.back().SetCellHardwareMaxThreads(SGP_MAX_THREAD_CNT);
-    demes.back().SetCellHardwareMaxCallDepth(SGP_MAX_CALL_DEPTH);
-    demes.back().SetCellHardwareMinTagMatchThreshold(SGP_MIN_TAG_MATCH_THRESHOLD);
-    demes.back().SetCellHardwareStochasticTieBreaks(false); // make tag-based referencing deterministic
-    demes.back().SetupCellMetabolism(TOTAL_RESOURCES);
-    // TODO - any non-constructor deme configuration
+  deme_pool.clear();
+}
+
+/// Build and configure deme hardware for the given population position
+emp::Ptr<Deme> DOLWorld::NewDeme(size_t deme_id) {
+  // Each deme draws from its own random stream (reseeded every update, see AdvanceDemes)
+  emp::Ptr<Deme> deme = emp::NewPtr<Deme>(DEME_WIDTH, DEME_HEIGHT, emp::NewPtr<emp::Random>(1), inst_lib, event_lib, true);
+  deme->SetDemeID(deme_id); // Associate deme with particular position in pop vector
+  deme->SetCellHardwareMaxThreads(SGP_MAX_THREAD_CNT);
+  deme->SetCellHardwareMaxCallDepth(SGP_MAX_CALL_DEPTH);
+  deme->SetCellHardwareMinTagMatchThreshold(SGP_MIN_TAG_MATCH_THRESHOLD);
+  deme->SetCellHardwareStochasticTieBreaks(false); // make tag-based referencing deterministic
+  deme->SetupCellMetabolism(TOTAL_RESOURCES);
+  deme->SetCellScheduleMode(cell_schedule_mode, cell_permutations);
+  if (cell_execution_mode == CellExecutionMode::CELL_MAJOR) {
+    deme->SetCellExecutionMode(cell_execution_mode, CELL_BATCH_STEPS, fun_resolve_metabolism);
   }
+  // TODO - any non-constructor deme configuration
+  return deme;
+}
+
+/// Get deme hardware for the given population position
+/// - Reuse deactivated hardware from the deme pool if there is any. Pooled
+///   hardware keeps its cell buffers (programs, cores, queues) allocated.
+emp::Ptr<Deme> DOLWorld::AcquireDeme(size_t deme_id) {
+  if (deme_pool.empty()) return NewDeme(deme_id);
+  emp::Ptr<Deme> deme = deme_pool.back();
+  deme_pool.pop_back();
+  emp_assert(!deme->IsActive());
+  deme->SetDemeID(deme_id);
+  return deme;
+}
+
+/// Deactivate deme hardware at the given population position and return it to the pool
+void DOLWorld::ReleaseDeme(size_t deme_id) {
+  emp_assert(HasDeme(deme_id));
+  demes[deme_id]->DeactivateDeme();
+  deme_pool.emplace_back(demes[deme_id]);
+  demes[deme_id] = nullptr;
 }
 
 /// Setup the signalgp event set
@@ -528,8 +945,8 @@ void DOLWorld::SetupEventSet() {
       // if neighboring cell == this cell (small deme=>wrap around), do not message
       if ( (!deme.IsCellActive(neighbor_cell_id)) || cell_id == neighbor_cell_id) continue;
       // pass that message!
-      Deme::CellularHardware & neighbor_cell = deme.GetCell(neighbor_cell_id);
-      neighbor_cell.sgp_hw.QueueEvent(event);
+      deme.SendEvent(neighbor_cell_id, event);
+      if (trace) GetTraceLane(world_id).Message(world_id, cell_id, neighbor_cell_id);
     }
   };
 
@@ -541,8 +958,8 @@ void DOLWorld::SetupEventSet() {
     const size_t neighbor_cell_id = deme.GetNeighboringCellID(cell_id, deme.GetCellFacing(cell_id));
     // Is neighbor active?
     if (deme.IsCellActive(neighbor_cell_id) && cell_id != neighbor_cell_id) {
-      Deme::CellularHardware & neighbor_cell = deme.GetCell(neighbor_cell_id);
-      neighbor_cell.sgp_hw.QueueEvent(event);
+      deme.SendEvent(neighbor_cell_id, event);
+      if (trace) GetTraceLane(world_id).Message(world_id, cell_id, neighbor_cell_id);
     }
   };
 
@@ -569,9 +986,16 @@ void DOLWorld::SetupInstructionSet() {
   inst_lib->AddInst("TestEqu", sgp_hardware_t::Inst_TestEqu, 3, "Local memory: Arg3 = (Arg1 == Arg2)");
   inst_lib->AddInst("TestNEqu", sgp_hardware_t::Inst_TestNEqu, 3, "Local memory: Arg3 = (Arg1 != Arg2)");
   inst_lib->AddInst("TestLess", sgp_hardware_t::Inst_TestLess, 3, "Local memory: Arg3 = (Arg1 < Arg2)");
-  inst_lib->AddInst("If", sgp_hardware_t::Inst_If, 1, "Local memory: If Arg1 != 0, proceed; else, skip block.", emp::ScopeType::BASIC, 0, {"block_def"});
-  inst_lib->AddInst("While", sgp_hardware_t::Inst_While, 1, "Local memory: If Arg1 != 0, loop; else, skip block.", emp::ScopeType::BASIC, 0, {"block_def"});
-  inst_lib->AddInst("Countdown", sgp_hardware_t::Inst_Countdown, 1, "Local memory: Countdown Arg1 to zero.", emp::ScopeType::BASIC, 0, {"block_def"});
+  // - Block instructions jump using the deme's decoded program instead of scanning for the end of their block
+  inst_lib->AddInst("If", [this](sgp_hardware_t & hw, const sgp_inst_t & inst) {
+    this->Inst_If(hw, inst);
+  }, 1, "Local memory: If Arg1 != 0, proceed; else, skip block.", emp::ScopeType::BASIC, 0, {"block_def"});
+  inst_lib->AddInst("While", [this](sgp_hardware_t & hw, const sgp_inst_t & inst) {
+    this->Inst_While(hw, inst);
+  }, 1, "Local memory: If Arg1 != 0, loop; else, skip block.", emp::ScopeType::BASIC, 0, {"block_def"});
+  inst_lib->AddInst("Countdown", [this](sgp_hardware_t & hw, const sgp_inst_t & inst) {
+    this->Inst_Countdown(hw, inst);
+  }, 1, "Local memory: Countdown Arg1 to zero.", emp::ScopeType::BASIC, 0, {"block_def"});
   inst_lib->AddInst("Close", sgp_hardware_t::Inst_Close, 0, "Close current block if there is a block to close.", emp::ScopeType::BASIC, 0, {"block_close"});
   inst_lib->AddInst("Break", sgp_hardware_t::Inst_Break, 0, "Break out of current block.");
   inst_lib->AddInst("Call", sgp_hardware_t::Inst_Call, 0, "Call function that best matches call affinity.", emp::ScopeType::BASIC, 0, {"affinity"});
@@ -661,8 +1085,8 @@ void DOLWorld::SetupInstructionSet() {
     const size_t cell_id = (size_t)hw.GetTrait(sgp_trait_ids_t::TRAIT_ID__CELL_ID);
     Deme & deme = GetDeme(world_id);
     Deme::CellularHardware & cell = deme.GetCell(cell_id);
-    if (!cell.repro_tag_locked) { // If cell's repro tag isn't locked, lock it in w/instruction's tag
-      deme.GetCell(cell_id).LockReproTag(inst.affinity);
+    if (!cell.IsReproTagLocked()) { // If cell's repro tag isn't locked, lock it in w/instruction's tag
+      cell.LockReproTag(inst.affinity);
     }
   });
 
@@ -675,7 +1099,34 @@ void DOLWorld::SetupInstructionSet() {
     this->DonateCellResourcesToOrganism(world_id, cell_id);
   }, 0, "Donate cell's local resources to deme-level organism.");
 
-  // Add resource-specific instructions to instruction set
+  // Add resource-specific instructions to instruction set (metabolize & sensors)
+  // - Metabolize instructions are specialized on the configured consumption policy
+  //   (as is resolving the metabolize attempts that cell-major demes buffer)
+  switch (consumption_policy) {
+    case ResourcePolicyType::FIXED:
+      SetupResourceInstructions<FixedResourcePolicy>();
+      fun_resolve_metabolism = [this](size_t org_id, size_t cell_id, size_t resource_id, bool credit_cell) {
+        Metabolize<FixedResourcePolicy>(org_id, cell_id, resource_id, credit_cell);
+      };
+      break;
+    case ResourcePolicyType::PROPORTIONAL:
+      SetupResourceInstructions<ProportionalResourcePolicy>();
+      fun_resolve_metabolism = [this](size_t org_id, size_t cell_id, size_t resource_id, bool credit_cell) {
+        Metabolize<ProportionalResourcePolicy>(org_id, cell_id, resource_id, credit_cell);
+      };
+      break;
+  }
+
+  // Classify instructions by their role in block structure (for decoding programs)
+  inst_block_roles = DecodedProgram::ClassifyInstructions(*inst_lib);
+  // Decode each genotype's program once, as it's interned
+  genotypes.SetDeriveFun([this](const org_t::Genome & genome, DecodedProgram & decoded) {
+    decoded.Decode(genome.program, inst_block_roles);
+  });
+}
+
+template<typename CONSUME_POLICY>
+void DOLWorld::SetupResourceInstructions() {
   for (size_t resource_id = 0; resource_id < TOTAL_RESOURCES; ++resource_id) {
     // - Add metabolize instructions for each resource
     inst_lib->AddInst("Express-" + emp::to_string(resource_id),
@@ -684,7 +1135,7 @@ void DOLWorld::SetupInstructionSet() {
         const size_t world_id = (size_t)hw.GetTrait(sgp_trait_ids_t::TRAIT_ID__DEME_ID);
         const size_t cell_id = (size_t)hw.GetTrait(sgp_trait_ids_t::TRAIT_ID__CELL_ID);
         // Attempt to consume resource
-        this->AttemptToMetabolize(world_id, cell_id, resource_id);
+        this->AttemptToMetabolize<CONSUME_POLICY>(world_id, cell_id, resource_id);
       }, 0, "Attempt to metabolize resource " + emp::to_string(resource_id));
 
     // - Add sensor activation instruction for each resource
@@ -790,6 +1241,195 @@ void DOLWorld::SetupEnvironment() {
   // todo - output a resource tag file
 }
 
+/// Resolve resource consumption/decay modes & precompute per-resource amounts
+/// (requires resource types to already be configured)
+void DOLWorld::SetupResourcePolicies() {
+  emp_assert(resource_types.size() == TOTAL_RESOURCES);
+  // How are resources consumed?
+  if (RESOURCE_CONSUMPTION_MODE == "fixed") {
+    consumption_policy = ResourcePolicyType::FIXED;
+  } else if (RESOURCE_CONSUMPTION_MODE == "proportional") {
+    consumption_policy = ResourcePolicyType::PROPORTIONAL;
+  } else {
+    std::cout << "Unrecognized RESOURCE_CONSUMPTION_MODE (" << RESOURCE_CONSUMPTION_MODE << ")! Exiting." << std::endl;
+    exit(-1);
+  }
+  // How do resources decay?
+  if (RESOURCE_DECAY_MODE == "fixed") {
+    decay_policy = ResourcePolicyType::FIXED;
+    periodic_decay_amount = PERIODIC_RESOURCES__DECAY_FIXED;
+  } else if (RESOURCE_DECAY_MODE == "proportional") {
+    decay_policy = ResourcePolicyType::PROPORTIONAL;
+    periodic_decay_amount = PERIODIC_RESOURCES__DECAY_PROPORTIONAL;
+  } else {
+    std::cout << "Unrecognized RESOURCE_DECAY_MODE (" << RESOURCE_DECAY_MODE << ")! Exiting." << std::endl;
+    exit(-1);
+  }
+  // How much of each resource is collected on success? What does failure cost?
+  const bool fixed = consumption_policy == ResourcePolicyType::FIXED;
+  resource_consume_amounts.resize(TOTAL_RESOURCES);
+  resource_failure_costs.resize(TOTAL_RESOURCES);
+  for (size_t res_id = 0; res_id < TOTAL_RESOURCES; ++res_id) {
+    if (resource_types[res_id] == ResourceType::STATIC) {
+      resource_consume_amounts[res_id] = (fixed) ? STATIC_RESOURCES__CONSUME_FIXED : STATIC_RESOURCES__CONSUME_PROPORTIONAL;
+      resource_failure_costs[res_id] = STATIC_RESOURCES__FAILURE_COST;
+    } else {
+      resource_consume_amounts[res_id] = (fixed) ? PERIODIC_RESOURCES__CONSUME_FIXED : PERIODIC_RESOURCES__CONSUME_PROPORTIONAL;
+      resource_failure_costs[res_id] = PERIODIC_RESOURCES__FAILURE_COST;
+    }
+  }
+}
+
+/// Open the event trace (if configured to trace events)
+void DOLWorld::SetupTrace() {
+  CloseTrace();
+  if (!TRACE_EVENTS) return;
+  EventTrace::Header header;
+  header.pop_size = MAX_POP_SIZE;
+  header.deme_width = DEME_WIDTH;
+  header.deme_height = DEME_HEIGHT;
+  header.num_resources = TOTAL_RESOURCES;
+  header.keyframe_interval = TRACE_KEYFRAME_INTERVAL;
+  // One lane per thread, plus lanes for events before/after demes advance; lanes
+  // are flushed in order, so records stay in population order (see GetTraceLane)
+  trace = emp::NewPtr<EventTrace>(header, NUM_THREADS + 2);
+  if (!trace->Open(TRACE_FPATH)) {
+    std::cout << "Failed to open event trace file (" << TRACE_FPATH << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  std::cout << "Recording event trace to " << TRACE_FPATH << std::endl;
+}
+
+/// Open the memory report (if configured to report memory usage)
+void DOLWorld::SetupMemoryReport() {
+  CloseMemoryReport();
+  if (!MEMORY_REPORT_INTERVAL) return;
+  memory_report_stream.open(MEMORY_REPORT_FPATH, std::ios::trunc);
+  if (!memory_report_stream.is_open()) {
+    std::cout << "Failed to open memory report file (" << MEMORY_REPORT_FPATH << "). Exiting..." << std::endl;
+    exit(-1);
+  }
+  MemoryReport::WriteCSVHeader(memory_report_stream);
+}
+
+/// Start timing the run (status is only published if something can serve it)
+void DOLWorld::SetupStatus() {
+  publish_status = STATUS_PORT || STATUS_SOCKET_FPATH != "";
+  phase_timings.Setup(PHASE_TIMING || PHASE_TIMING_PER_UPDATE || publish_status, PHASE_TIMING_PER_DEME, MAX_POP_SIZE, worker_pool->GetNumThreads());
+  run_status = RunStatus();
+  run_status.max_pop_size = MAX_POP_SIZE;
+  run_status.num_resources = std::min(TOTAL_RESOURCES, RunStatus::MAX_RESOURCES);
+  status_start_time = status_clock_t::now();
+  status_window_time = status_start_time;
+  status_window_update = update;
+}
+
+void DOLWorld::PublishStatus() {
+  const status_clock_t::time_point now = status_clock_t::now();
+  run_status.update = update;
+  run_status.num_orgs = GetNumOrgs();
+  for (size_t phase = 0; phase < RunStatus::NUM_PHASES; ++phase) {
+    run_status.phase_ms[phase] = phase_timings.GetUpdateMS(phase);
+    run_status.phase_total_ms[phase] = phase_timings.GetTotalMS(phase);
+  }
+  run_status.elapsed_sec = std::chrono::duration<double>(now - status_start_time).count();
+  // Updates/sec over a window of about a second (the first window reports as it goes)
+  const double window_sec = std::chrono::duration<double>(now - status_window_time).count();
+  if (window_sec > 0.0) run_status.updates_per_sec = (double)(update - status_window_update) / window_sec;
+  if (window_sec >= 1.0) {
+    status_window_time = now;
+    status_window_update = update;
+  }
+  // Consumption tallies (living population)
+  for (size_t res_id = 0; res_id < run_status.num_resources; ++res_id) {
+    run_status.consumed[res_id] = 0.0;
+    run_status.consumption_successes[res_id] = 0;
+    run_status.consumption_failures[res_id] = 0;
+  }
+  for (size_t oid = 0; oid < pop.size(); ++oid) {
+    if (!IsOccupied(oid)) continue;
+    const org_t::Phenotype & phen = GetOrg(oid).GetPhenotype();
+    for (size_t res_id = 0; res_id < run_status.num_resources; ++res_id) {
+      run_status.consumed[res_id] += phen.consumption_amount_by_type[res_id];
+      run_status.consumption_successes[res_id] += phen.consumption_successes_by_type[res_id];
+      run_status.consumption_failures[res_id] += phen.consumption_failures_by_type[res_id];
+    }
+  }
+  status_board.Publish(run_status);
+}
+
+void DOLWorld::MeasureMemory(MemoryReport & report) {
+  report.update = update;
+  report.demes.resize(pop.size());
+  report.totals.Clear();
+  for (size_t pos = 0; pos < pop.size(); ++pos) {
+    MemoryUsage & usage = report.demes[pos];
+    usage.Clear();
+    if (IsOccupied(pos)) {
+      const org_t & org = GetOrg(pos);
+      const org_t::Phenotype & phen = org.GetPhenotype();
+      // Genotypes are shared; each organism is charged an equal share of its genotype
+      usage.genomes = sizeof(org_t::genotype_t)
+                    + (sizeof(org_t::Genome) + MemoryAccounting::ProgramBytes(org.GetGenome().program)
+                       + org.GetGenotype().GetDerived().GetMemoryBytes()) / org.GetGenotype().GetAbundance();
+      usage.phenotypes = sizeof(org_t::Phenotype)
+                       + MemoryAccounting::VectorBytes(phen.consumption_amount_by_type)
+                       + MemoryAccounting::VectorBytes(phen.consumption_successes_by_type)
+                       + MemoryAccounting::VectorBytes(phen.consumption_failures_by_type)
+                       + MemoryAccounting::VectorBytes(phen.resource_alerts_received_by_type);
+    }
+    if (pos < environments.size()) {
+      usage.environments = sizeof(Environment) + MemoryAccounting::VectorBytes(environments[pos].resources);
+    }
+    if (HasDeme(pos)) demes[pos]->MeasureMemory(usage);
+    report.totals += usage;
+  }
+  // Population-level components
+  for (emp::Ptr<Deme> deme : deme_pool) {
+    MemoryUsage pooled;
+    deme->MeasureMemory(pooled);
+    report.totals.deme_pool += pooled.GetTotal();
+  }
+  report.totals.birth_chamber = MemoryAccounting::VectorBytes(birth_chamber);
+  report.totals.neighbor_tables = DemeTopology::Get(DEME_WIDTH, DEME_HEIGHT)->GetMemoryBytes(); // Shared by every deme
+  if (cell_permutations) report.totals.cell_state += cell_permutations->GetMemoryBytes();         // Shared by every deme
+}
+
+void DOLWorld::CaptureTraceState(EventTrace::State & state) const {
+  const size_t capacity = DEME_WIDTH * DEME_HEIGHT;
+  state.update = update;
+  state.orgs.resize(pop.size());
+  state.has_resource_levels = true;
+  state.resource_levels.assign(pop.size() * TOTAL_RESOURCES, 0.0);
+  for (size_t pos = 0; pos < pop.size(); ++pos) {
+    EventTrace::OrgState & org_state = state.orgs[pos];
+    org_state.active_cells.assign(capacity, false);
+    org_state.sensors.assign(capacity * TOTAL_RESOURCES, false);
+    org_state.consumption_successes.assign(TOTAL_RESOURCES, 0);
+    org_state.consumption_failures.assign(TOTAL_RESOURCES, 0);
+    org_state.total_resources_collected = 0.0;
+    org_state.occupied = IsOccupied(pos);
+    if (!org_state.occupied) continue;
+    const Deme & deme = GetDeme(pos);
+    for (size_t cell_id = 0; cell_id < capacity; ++cell_id) {
+      org_state.active_cells[cell_id] = deme.IsCellActive(cell_id);
+      for (size_t res_id = 0; res_id < TOTAL_RESOURCES; ++res_id) {
+        org_state.sensors[cell_id * TOTAL_RESOURCES + res_id] = deme.IsCellSensingResource(cell_id, res_id);
+      }
+    }
+    const org_t::Phenotype & phen = GetOrg(pos).GetPhenotype();
+    for (size_t res_id = 0; res_id < TOTAL_RESOURCES; ++res_id) {
+      org_state.consumption_successes[res_id] = phen.consumption_successes_by_type[res_id];
+      org_state.consumption_failures[res_id] = phen.consumption_failures_by_type[res_id];
+    }
+    org_state.total_resources_collected = phen.total_resources_collected;
+    const Environment & env = environments[pos];
+    for (size_t res_id = 0; res_id < TOTAL_RESOURCES; ++res_id) {
+      state.resource_levels[pos * TOTAL_RESOURCES + res_id] = env.resources[res_id].GetAmount();
+    }
+  }
+}
+
 void DOLWorld::Reset(DOLWorldConfig & config) {
   // --- Clear signals ---
   // OnOrgDeath
@@ -798,9 +1438,13 @@ void DOLWorld::Reset(DOLWorldConfig & config) {
   on_placement_sig.Clear();
   // OnOffspringReady
   offspring_ready_sig.Clear();
+  // --- Finish the event trace & memory report ---
+  CloseTrace();
+  CloseMemoryReport();
   // --- Clear the world! ---
   emp::World<DigitalOrganism>::Reset(); // clear world, update = 0
   // --- Clean up dynamic memory ---
+  ClearDemeHardware();
   inst_lib.Delete();
   event_lib.Delete();
   setup = false;
@@ -825,6 +1469,8 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
 
   // Setup the environment
   SetupEnvironment();
+  // Setup resource consumption/decay
+  SetupResourcePolicies();
   // Setup event set
   SetupEventSet();
   // Setup instruction set
@@ -834,12 +1480,16 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
 
   // Tell the emp::World how to be
   SetPopStruct_Mixed(false);  // Mixed population (at deme/organism-level), asynchronous generations
-  SetAutoMutate(); // Mutations happen automatically when organisms are born (offspring_ready_sig)
+  // Note: offspring are mutated (& their phenotypes reset) by PrepareOffspring (see DoBirths),
+  // not by offspring-ready handlers, so that offspring can be built on the worker pool.
 
   // Note, this is the function I would modify/parameterize if we wanted
   // to have single birth => multiple cells activated on placement
   // todo - move this functionality into deme?
   fun_seed_deme = [this](Deme & deme, org_t & org) {
+    // (0) point the deme at the organism's decoded program (decoded once per genotype, when interned)
+    emp_assert(org.GetGenotype().IsInterned());
+    deme.SetDecodedProgram(org.GetGenotype().GetDerived());
     // (1) select a random cell in the deme
     // const size_t cell_id = GetRandom().GetUInt(deme.GetCellCapacity());
     const size_t cell_id = (size_t)deme.GetCellCapacity()/2;
@@ -849,92 +1499,9 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
     //   entry point function main? = no, lock in entry point tag? = no
     cell_hw.ActivateCell(org.GetGenome().program, org.GetGenome().birth_tag, sgp_memory_t(), false, false);
     cell_hw.cell_facing = Deme::Facing::N;
+    if (trace) GetTraceLane(deme.GetDemeID()).Birth(deme.GetDemeID(), cell_id);
   };
 
-  // What happens when an organism consumes a resource?
-  if (RESOURCE_CONSUMPTION_MODE == "fixed") {
-    fun_consume_resource = [this](size_t org_id, size_t cell_id, size_t resource_id) {
-      org_t & org = GetOrg(org_id);
-      Deme & deme = GetDeme(org_id);
-      Deme::CellularHardware & cell = deme.GetCell(cell_id);
-      Environment & local_env = environments[org_id];
-      Resource & res_state = local_env.resources[resource_id];
-      double collected = res_state.ConsumeFixed((res_state.GetType() == ResourceType::STATIC) ? STATIC_RESOURCES__CONSUME_FIXED : PERIODIC_RESOURCES__CONSUME_FIXED);
-      // Collect those sweet delicious resources!
-      // org.GetPhenotype().resource_pool += collected;
-      cell.local_resources += collected;
-      org.GetPhenotype().total_resources_collected += collected;
-      // Track consumption info
-      emp_assert(resource_id < org.GetPhenotype().consumption_amount_by_type.size());
-      emp_assert(resource_id < org.GetPhenotype().consumption_successes_by_type.size());
-      org.GetPhenotype().consumption_amount_by_type[resource_id] += collected;
-      org.GetPhenotype().consumption_successes_by_type[resource_id] += 1;
-    };
-  } else if (RESOURCE_CONSUMPTION_MODE == "proportional") {
-    fun_consume_resource = [this](size_t org_id, size_t cell_id, size_t resource_id) {
-      org_t & org = GetOrg(org_id);
-      Deme & deme = GetDeme(org_id);
-      Deme::CellularHardware & cell = deme.GetCell(cell_id);
-      Environment & local_env = environments[org_id];
-      Resource & res_state = local_env.resources[resource_id];
-      double collected = res_state.ConsumeProportion((res_state.GetType() == ResourceType::STATIC) ? STATIC_RESOURCES__CONSUME_PROPORTIONAL : PERIODIC_RESOURCES__CONSUME_PROPORTIONAL);
-      // Collect those sweet delicious resources!
-      // org.GetPhenotype().resource_pool += collected;
-      cell.local_resources += collected;
-      org.GetPhenotype().total_resources_collected += collected;
-      // Track consumption info
-      emp_assert(resource_id < org.GetPhenotype().consumption_amount_by_type.size());
-      emp_assert(resource_id < org.GetPhenotype().consumption_successes_by_type.size());
-      org.GetPhenotype().consumption_amount_by_type[resource_id] += collected;
-      org.GetPhenotype().consumption_successes_by_type[resource_id] += 1;
-    };
-  } else {
-    std::cout << "Unrecognized RESOURCE_CONSUMPTION_MODE (" << RESOURCE_CONSUMPTION_MODE << ")! Exiting." << std::endl;
-    exit(-1);
-  }
-
-  // What happens when a resource consumption fails?
-  // (i.e., a misqueue? => attempted consumption when resource is unavailable)
-  fun_consume_fail = [this](size_t org_id, size_t cell_id, size_t resource_id) {
-    org_t & org = GetOrg(org_id);
-    Environment & local_env = environments[org_id];
-    Resource & res_state = local_env.resources[resource_id];
-    switch (res_state.GetType()) {
-      case ResourceType::STATIC: {
-        org.GetPhenotype().resource_pool -= STATIC_RESOURCES__FAILURE_COST;
-        break;
-      }
-      case ResourceType::PERIODIC: {
-        org.GetPhenotype().resource_pool -= PERIODIC_RESOURCES__FAILURE_COST;
-        break;
-      }
-      default: {
-        emp_assert(false, "Trying to penalize organism for consuming unrecognized resource type!");
-      }
-    }
-    // Don't let organism get into resource debt!
-    if (org.GetPhenotype().resource_pool < 0) org.GetPhenotype().resource_pool = 0.0;
-    // Track consumption misqueue
-    org.GetPhenotype().consumption_failures_by_type[resource_id]++;
-  };
-
-  if (RESOURCE_DECAY_MODE == "fixed") {
-    fun_decay_resource = [this](size_t env_id, size_t resource_id) {
-      Environment & local_env = environments[env_id];
-      Resource & res_state = local_env.resources[resource_id];
-      res_state.DecayFixed(PERIODIC_RESOURCES__DECAY_FIXED);
-    };
-  } else if (RESOURCE_DECAY_MODE == "proportional") {
-    fun_decay_resource = [this](size_t env_id, size_t resource_id) {
-      Environment & local_env = environments[env_id];
-      Resource & res_state = local_env.resources[resource_id];
-      res_state.DecayProportion(PERIODIC_RESOURCES__DECAY_PROPORTIONAL);
-    };
-  } else {
-    std::cout << "Unrecognized RESOURCE_DECAY_MODE (" << RESOURCE_DECAY_MODE << ")! Exiting." << std::endl;
-    exit(-1);
-  }
-
   // Setup instruction-triggered cellular division (within-deme reproduction)
   fun_instruction_attempted_cell_division = [this](size_t world_id,
                                                    size_t cell_id,
@@ -976,9 +1543,10 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
                                                  cell.repro_tag,                // What tag should we use to trigger init function with?
                                                  sgp_memory_t(),                // What should input memory of init function call be?
                                                  false,                         // Should init function be a 'main'?
-                                                 cell.repro_tag_locked);        // Should offspring's repro tag be locked?
+                                                 cell.IsReproTagLocked());      // Should offspring's repro tag be locked?
     // mark cell as new born
-    deme.GetCell(offspring_cell_id).new_born = true;
+    deme.GetCell(offspring_cell_id).SetNewBorn(true);
+    if (trace) GetTraceLane(world_id).Division(world_id, cell_id, offspring_cell_id);
     // rotate cell to face parent
     const size_t child_dir = (size_t)emp::Mod((int)(cell.cell_facing + 4), (int)Deme::NUM_DIRECTIONS);
     deme.GetCell(offspring_cell_id).cell_facing = Deme::Dir[child_dir];
@@ -990,11 +1558,12 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
   };
 
   // What to do when an organism dies?
-  // - deactivate the deme hardware
+  // - deactivate the deme hardware & return it to the deme pool
   OnOrgDeath([this](size_t pos) {
     // Clean up deme hardware @ position
     emp_assert(pos < demes.size());
-    demes[pos].DeactivateDeme();
+    ReleaseDeme(pos);
+    if (trace) GetTraceLane(pos).Death(pos);
   });
 
   // What happens when a new organism is placed?
@@ -1002,9 +1571,13 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
     // Load organism into deme hardware
     emp_assert(pos < demes.size());
     emp_assert(pos < environments.size());
-    Deme & focal_deme = demes[pos];
+    // Give this position deme hardware (recycled from the deme pool if possible)
+    emp_assert(!HasDeme(pos));
+    demes[pos] = AcquireDeme(pos);
+    Deme & focal_deme = *demes[pos];
     org_t & placed_org = GetOrg(pos);
     placed_org.SetOrgID(pos);
+    placed_org.SetGenotype(genotypes.Intern(placed_org.GetGenotype())); // No-op for un-mutated offspring
     fun_seed_deme(focal_deme, placed_org);
     focal_deme.ActivateDeme();
     // Reset the local environment
@@ -1012,14 +1585,9 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
     local_env.Reset();
   });
 
-  // Todo
-  OnOffspringReady([this](org_t & org, size_t parent_pos) {
-    org.GetPhenotype().Reset(TOTAL_RESOURCES);
-  });
-
   // Setup mutate function
   SetMutFun([this](org_t & org, emp::Random & r) {
-    return mutator.Mutate(org, r);
+    return mutator.Mutate(org, r).num_mutations;
   });
 
   // todo - setup systematics
@@ -1032,6 +1600,11 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
     GetOrg(i).GetPhenotype().Reset(TOTAL_RESOURCES);
   }
 
+  // Start recording (after the initial population is in place; first update records a keyframe)
+  SetupTrace();
+  SetupMemoryReport();
+  SetupStatus();
+
   setup = true;
   emp_assert(pop.size() == demes.size(), "SETUP ERROR! Population vector size (", pop.size(), ")", "does not match deme vector size (", demes.size(), ").");
   emp_assert(pop.size() == environments.size(), "SETUP ERROR! Population vector size (", pop.size(), ")", "does not match environments vector size (", environments.size(), ").");
@@ -1039,18 +1612,30 @@ void DOLWorld::Setup(DOLWorldConfig & config) {
 
 void DOLWorld::RunStep() {
   std::cout << "Update: " << update << "; NumOrgs: " << GetNumOrgs() << std::endl;
+  trace_lane = 0;
+  // Phase timings (see PhaseTimings.h)
+  phase_timings.BeginUpdate();
+  auto end_phase = [this](RunStatus::Phase phase) { phase_timings.EndPhase(phase); };
+  // () Mark the update (and maybe write a keyframe) in the event trace
+  if (trace) {
+    trace->BeginUpdate(update);
+    if (trace->IsKeyframeUpdate(update)) {
+      CaptureTraceState(trace_state);
+      trace->WriteKeyframe(trace_state);
+    }
+  }
+  end_phase(RunStatus::TRACE);
   // Reminder, 1 update = CPU_CYCLES_PER_UPDATE distributed to every CPU thread across all demes
   // () Update the environment
   // std::cout << "ADVANCE ENVIRONMENT" << std::endl;
   AdvanceEnvironment();
+  end_phase(RunStatus::ENVIRONMENT);
   // () Evaluate all organisms (demes)
   // std::cout << "EXECUTION" << std::endl;
+  AdvanceDemes();
   for (size_t oid = 0; oid < pop.size(); ++oid) {
     if (!IsOccupied(oid)) continue;
-    // Distribute CPU cycles to DEME
-    Deme & deme = demes[oid];
-    emp_assert(deme.IsActive());
-    deme.Advance(CPU_CYCLES_PER_UPDATE);
+    emp_assert(GetDeme(oid).IsActive());
     org_t & org = GetOrg(oid);
     // This organism lived through yet another trying update...
     org.GetPhenotype().age++;
@@ -1069,29 +1654,113 @@ void DOLWorld::RunStep() {
       birth_chamber.emplace_back(oid);
     }
   }
+  end_phase(RunStatus::DEMES);
   // () Do organism-level (deme-level) reproduction
   emp::Shuffle(*random_ptr, birth_chamber); // Randomize birth chamber priority
   // std::cout << "REPRODUCTION?" << std::endl;
-  for (size_t oid : birth_chamber) {
-    emp_assert(IsOccupied(oid), "Reproducing organism no longer exists?");
-    // We have to check if this organism is _still_ reproducing?
-    // - In the unfortunate case where this potential parent was overwritten by
-    //   a new baby organism, we don't want to replicate the new organism.
-    org_t & org = GetOrg(oid);
-    if (org.GetPhenotype().trigger_repro) {
-      // Birth!
-      org.GetPhenotype().trigger_repro = false;
-      org.GetPhenotype().offspring_cnt++;
-      DoBirth(org.GetGenome(), oid);
-      // WARNING (to future me): org could be an invalid reference now!!!!
-      // todo - OnBirth! and OnOffspringReady
-    }
-  }
+  DoBirths();
   // Empty the birth chamber
   birth_chamber.clear();
   // birth_chamber.resize(0);
+  end_phase(RunStatus::REPRODUCTION);
+  // Flush this update's trace records
+  if (trace) trace->EndUpdate();
+  // Sample memory usage
+  if (MEMORY_REPORT_INTERVAL && update % MEMORY_REPORT_INTERVAL == 0) {
+    MeasureMemory(memory_report);
+    memory_report.WriteCSV(memory_report_stream, MEMORY_REPORT_PER_DEME);
+    run_status.estimated_memory_bytes = memory_report.totals.GetTotal();
+    run_status.estimated_memory_update = update;
+  }
+  end_phase(RunStatus::REPORTING);
   // For each organism in the population, run its deme forward!
   Update(); // Update!
+  end_phase(RunStatus::WORLD_UPDATE);
+  phase_timings.EndUpdate();
+  if (PHASE_TIMING_PER_UPDATE) phase_timings.WriteUpdate(std::cout);
+  if (publish_status) PublishStatus();
+}
+
+/// Demes only touch their own cells, organism, and local environment while
+/// advancing, so they can advance concurrently. Each deme's random stream is
+/// reseeded from the world's (in population order) first, so results don't
+/// depend on the number of threads (including one) or how demes are split
+/// between them.
+void DOLWorld::AdvanceDemes() {
+  for (size_t oid = 0; oid < pop.size(); ++oid) {
+    if (IsOccupied(oid)) GetDeme(oid).GetRandom().ResetSeed((int)random_ptr->GetUInt(1, 0x7FFFFFFF));
+  }
+  advancing_demes = true;
+  worker_pool->ParallelFor(pop.size(), [this](size_t oid, size_t thread_id) {
+    if (!IsOccupied(oid)) return;
+    Deme & deme = GetDeme(oid);
+    phase_timings.TimeDeme(oid, thread_id, [&deme, this]() { deme.Advance(CPU_CYCLES_PER_UPDATE); });
+  });
+  advancing_demes = false;
+  trace_lane = NUM_THREADS + 1;
+}
+
+/// Births happen in two phases (for any number of threads, including one):
+/// (1) Build an offspring for every birth chamber entry on the worker pool and
+///     prepare it (PrepareOffspring: mutate & reset phenotype). Each entry gets
+///     its own random stream, seeded from the world's (in birth chamber order),
+///     so offspring don't depend on how entries are split between threads.
+///     Parents are only read during this phase.
+/// (2) In (shuffled) birth chamber order, for every parent that is still
+///     reproducing, fire DoBirth's signals in DoBirth's order: before-repro (the
+///     parent), offspring-ready (the prepared offspring; every registered handler
+///     runs), find a birth position, and place (placement & death use the world's
+///     random stream, serially). Offspring of parents that were overwritten before
+///     their turn are discarded. If a before-repro handler changed the parent's
+///     genotype, the offspring is rebuilt from the new genotype (same random seed).
+/// Relative to emp::World::DoBirth, the only difference is that preparing the
+/// offspring is not an offspring-ready handler: it always runs before them.
+/// Mutation only reads the mutator's configuration, so the shared mutator is
+/// safe to use from every thread. Offspring share their parent's genotype until
+/// they mutate (genotype handle counts are atomic; parents stay alive through
+/// phase 1, so no genotype leaves the store until phase 2). Mutated offspring
+/// are interned when they're placed.
+void DOLWorld::DoBirths() {
+  const size_t num_births = birth_chamber.size();
+  birth_offspring.resize(num_births);
+  birth_parent_genotypes.resize(num_births);
+  birth_seeds.resize(num_births);
+  for (size_t i = 0; i < num_births; ++i) birth_seeds[i] = (int)random_ptr->GetUInt(1, 0x7FFFFFFF);
+  worker_pool->ParallelFor(num_births, [this](size_t i, size_t thread_id) {
+    emp::Random & rnd = birth_randoms[thread_id];
+    rnd.ResetSeed(birth_seeds[i]);
+    birth_parent_genotypes[i] = GetOrg(birth_chamber[i]).GetGenotype();
+    birth_offspring[i] = emp::NewPtr<org_t>(birth_parent_genotypes[i]);
+    PrepareOffspring(*birth_offspring[i], rnd);
+  });
+  for (size_t i = 0; i < num_births; ++i) {
+    const size_t oid = birth_chamber[i];
+    emp_assert(IsOccupied(oid), "Reproducing organism no longer exists?");
+    org_t & org = GetOrg(oid);
+    // We have to check if this organism is _still_ reproducing: if this parent
+    // was overwritten by an earlier birth, we don't want to replicate the new organism.
+    if (!org.GetPhenotype().trigger_repro) {
+      birth_offspring[i].Delete();
+      continue;
+    }
+    org.GetPhenotype().trigger_repro = false;
+    org.GetPhenotype().offspring_cnt++;
+    before_repro_sig.Trigger(oid);
+    if (GetOrg(oid).GetGenotype() != birth_parent_genotypes[i]) {
+      emp::Random & rnd = birth_randoms[0];
+      rnd.ResetSeed(birth_seeds[i]);
+      birth_offspring[i].Delete();
+      birth_offspring[i] = emp::NewPtr<org_t>(GetOrg(oid).GetGenotype());
+      PrepareOffspring(*birth_offspring[i], rnd);
+    }
+    offspring_ready_sig.Trigger(*birth_offspring[i], oid);
+    const emp::WorldPosition pos = fun_find_birth_pos(birth_offspring[i], oid);
+    if (pos.IsValid()) AddOrgAt(birth_offspring[i], pos, oid);
+    else birth_offspring[i].Delete();
+    // WARNING (to future me): org could be an invalid reference now!!!!
+  }
+  birth_offspring.clear();
+  birth_parent_genotypes.clear();
 }
 
 void DOLWorld::Run() {
@@ -1099,6 +1768,16 @@ void DOLWorld::Run() {
     RunStep();
   }
   // Todo - end of run snapshotting/analyses!
+  CloseTrace();
+  CloseMemoryReport();
+  if (PHASE_TIMING || PHASE_TIMING_PER_UPDATE || PHASE_TIMING_PER_DEME) phase_timings.WriteSummary(std::cout);
+  if (SAVE_POPULATION_FPATH != "") {
+    if (SavePopulation(SAVE_POPULATION_FPATH)) {
+      std::cout << "Saved population to " << SAVE_POPULATION_FPATH << std::endl;
+    } else {
+      std::cout << "Failed to save population to " << SAVE_POPULATION_FPATH << std::endl;
+    }
+  }
   std::cout << "Done running!" << std::endl;
 }
 
@@ -16,8 +16,12 @@ EMP_BUILD_CONFIG( DOLWorldConfig,
   VALUE(CPU_CYCLES_PER_UPDATE, size_t, 30, "Number of CPU cycles to distribute to each cell every update."),
   VALUE(INIT_POP_SIZE, size_t, 1, "How many organisms should we seed the world with?"),
   VALUE(MAX_POP_SIZE, size_t, 1000, "What is the maximum size of the population?"),
-  VALUE(INIT_POP_MODE, std::string, "random", "How should the population be initialized? Options:\n\t'random': generate initial population randomly\n\t'load-single': seed population with a single loaded program"),
+  VALUE(NUM_THREADS, size_t, 1, "How many threads should demes be advanced (and offspring built) on each update? Each deme (and each birth) draws from its own random stream, so results are identical for any number of threads."),
+  VALUE(INIT_POP_MODE, std::string, "random", "How should the population be initialized? Options:\n\t'random': generate initial population randomly\n\t'load-single': seed population with a single loaded program\n\t'load-library': seed population with the programs in an ancestor library file\n\t'load-population': load a population file (see SAVE_POPULATION_FPATH)"),
   VALUE(LOAD_ANCESTOR_INDIV_FPATH, std::string, "configs/single-static-task.gp", "From what file should we load an individual ancestor from?"),
+  VALUE(LOAD_ANCESTOR_LIBRARY_FPATH, std::string, "ancestors.gp", "From what (multi-genome) file should we load ancestors from (INIT_POP_MODE=load-library)?"),
+  VALUE(LOAD_POPULATION_FPATH, std::string, "population.dolpop", "From what (binary) population file should we load the initial population (INIT_POP_MODE=load-population)?"),
+  VALUE(SAVE_POPULATION_FPATH, std::string, "", "Where should the final population be saved (binary population file)? Leave empty to skip saving."),
 
   GROUP(RESOURCES, "Resource Settings"),
   VALUE(RESOURCE_CONSUMPTION_MODE, std::string, "fixed", "How are resources consumed? Options:\n\t(1) 'fixed'\n\t(2) 'proportional'"),
@@ -46,6 +50,10 @@ EMP_BUILD_CONFIG( DOLWorldConfig,
   GROUP(DEME, "Deme Settings"),
   VALUE(DEME_WIDTH, size_t, 5, "What is the maximum cell-width of a deme?"),
   VALUE(DEME_HEIGHT, size_t, 5, "What is the maximum cell-height of a deme?"),
+  VALUE(CELL_SCHEDULE_MODE, std::string, "shuffle", "In what order do a deme's cells execute each CPU cycle? Options:\n\t'shuffle': fresh random order every cycle\n\t'permutation-table': random pick from a precomputed table of random orders\n\t'rotate': random starting point in an order shuffled once per update\n\t'fixed': cell id order"),
+  VALUE(CELL_SCHEDULE_TABLE_SIZE, size_t, 4096, "How many precomputed orders are there to pick from (CELL_SCHEDULE_MODE=permutation-table)? Small tables bias cell order (see schedule_bias benchmark)."),
+  VALUE(CELL_EXECUTION_MODE, std::string, "interleaved", "How do a deme's cells spend an update's CPU cycles? Options:\n\t'interleaved': every cycle, each cell executes one step\n\t'cell-major': each cell executes CELL_BATCH_STEPS steps at a time; messages & metabolism are buffered until the batch ends (see Deme.h)"),
+  VALUE(CELL_BATCH_STEPS, size_t, 8, "How many steps does each cell execute at a time (CELL_EXECUTION_MODE=cell-major)?"),
 
   GROUP(CELLULAR_HARDWARE, "Within-deme cellular hardware unit settings (SignalGP CPUs + extras)"),
   VALUE(SGP_MAX_THREAD_CNT, size_t, 4, "What is the maximum number of concurrently running threads allowed on a SignalGP CPU?"),
@@ -71,11 +79,25 @@ EMP_BUILD_CONFIG( DOLWorldConfig,
   VALUE(PROGRAM_FUNC_DEL__PER_FUN, double, 0.05, "Program whole-function deletion rate (per-function)"),
   VALUE(PROGRAM_TAG_BIT_FLIP__PER_BIT, double, 0.0025, "Program tags bit flip rate (per-bit)"),
   VALUE(BIRTH_TAG_BIT_FLIP__PER_BIT, double, 0.0025, "Birth tag bit flip rate (per-bit)"),
+  VALUE(MUTATION_ENGINE, std::string, "signalgp", "How are mutation sites sampled? Options:\n\t'signalgp': Empirical's SignalGPMutator operators, drawn per site\n\t'per-site': one random draw per site\n\t'skip-ahead': draw the gap to the next mutated site (same distribution as 'per-site', far fewer draws)"),
 
   GROUP(REPRODUCTION, "Organism Reproduction Settings"),
   VALUE(DEME_REPRODUCTION_COST, double, 100.0, "How many resources does it cost for an organism (deme) to reproduce? I.e., propagule cost?"),
   VALUE(TISSUE_ACCRETION_COST, double, 10.0, "How many resources does it cost for a cell to reproduce (within-deme)? I.e., soma production cost?"),
 
+  GROUP(MONITORING, "Run Monitoring Settings"),
+  VALUE(TRACE_EVENTS, bool, false, "Record a binary event trace (pulses, metabolism, divisions, messages, sensors, births, deaths)?"),
+  VALUE(TRACE_FPATH, std::string, "trace.dol", "Where should the event trace be written?"),
+  VALUE(TRACE_KEYFRAME_INTERVAL, size_t, 100, "How often (in updates) should the event trace record a full keyframe (for fast replay)?"),
+  VALUE(MEMORY_REPORT_INTERVAL, size_t, 0, "How often (in updates) should memory usage be sampled? (0 = never)"),
+  VALUE(MEMORY_REPORT_FPATH, std::string, "memory.csv", "Where should memory usage samples be written (csv)?"),
+  VALUE(MEMORY_REPORT_PER_DEME, bool, false, "Should memory usage samples include one row per deme (in addition to population totals)?"),
+  VALUE(STATUS_PORT, size_t, 0, "Serve run status (JSON) over HTTP on this localhost port (native only; 0 = off)"),
+  VALUE(STATUS_SOCKET_FPATH, std::string, "", "Serve run status (JSON) on this Unix domain socket (native only; empty = off)"),
+  VALUE(PHASE_TIMING, bool, true, "Time each phase of every update (environment, demes, reproduction, etc.)? Timings are summed & printed at the end of the run."),
+  VALUE(PHASE_TIMING_PER_UPDATE, bool, false, "Also print every update's phase timings (one extra line per update)?"),
+  VALUE(PHASE_TIMING_PER_DEME, bool, false, "Also time every deme's execution each update (to show load imbalance between demes & threads)?"),
+
 
 )
 
@@ -0,0 +1,103 @@
+/**
+ *  @date 2019
+ *
+ *  @file  DecodedProgram.h
+ *
+ *  Pre-decoded control-flow structure of a SignalGP program. SignalGP's built-in
+ *  block instructions (If, While, Countdown) find the end of the block they open
+ *  by scanning forward through the function every time they execute. Genomes
+ *  never change, so we resolve every block-opening instruction's end-of-block
+ *  position once per genotype (when it's interned; see GenotypeStore) and let
+ *  block instructions jump straight to it.
+ */
+
+#ifndef _DECODED_PROGRAM_H
+#define _DECODED_PROGRAM_H
+
+#include <cstdint>
+
+#include "base/vector.h"
+#include "hardware/EventDrivenGP.h"
+
+#include "DOLWorldConfig.h"
+
+class DecodedProgram {
+public:
+  using sgp_hardware_t = emp::EventDrivenGP_AW<DOLWorldConstants::TAG_WIDTH>;
+  using program_t = typename sgp_hardware_t::Program;
+  using inst_lib_t = typename sgp_hardware_t::inst_lib_t;
+
+  /// What role does an instruction play in block structure?
+  enum BlockRole : uint8_t { NONE=0, BLOCK_DEF=1, BLOCK_CLOSE=2 };
+
+protected:
+  emp::vector<uint32_t> function_offsets; ///< Where each function's instructions begin in block_ends
+  emp::vector<uint32_t> block_ends;       ///< End-of-block position for each instruction (only meaningful for block-opening instructions)
+
+public:
+  /// Classify every instruction in an instruction library by its block role
+  /// (uses the same 'block_def'/'block_close' properties as SignalGP).
+  static emp::vector<BlockRole> ClassifyInstructions(const inst_lib_t & inst_lib);
+
+  /// Decode the given program (replacing any previously decoded program).
+  void Decode(const program_t & program, const emp::vector<BlockRole> & roles);
+
+  /// Forget the currently decoded program (keeps buffers)
+  void Clear() { function_offsets.clear(); block_ends.clear(); }
+
+  /// Heap bytes held by the decoded program's buffers
+  size_t GetMemoryBytes() const {
+    return (function_offsets.capacity() + block_ends.capacity()) * sizeof(uint32_t);
+  }
+
+  /// How many functions are in the decoded program?
+  size_t GetFunctionCnt() const { return function_offsets.empty() ? 0 : function_offsets.size() - 1; }
+
+  /// How many instructions does function fp have?
+  size_t GetFunctionSize(size_t fp) const { return function_offsets[fp+1] - function_offsets[fp]; }
+
+  /// Given the position of a block-opening instruction, return the position of
+  /// the Close that ends its block (or the function's length if the block is
+  /// never closed). Equivalent to sgp_hardware_t::FindEndOfBlock(fp, ip+1).
+  size_t GetBlockEnd(size_t fp, size_t ip) const {
+    emp_assert(fp < GetFunctionCnt());
+    emp_assert(ip < GetFunctionSize(fp));
+    return block_ends[function_offsets[fp] + ip];
+  }
+};
+
+emp::vector<DecodedProgram::BlockRole> DecodedProgram::ClassifyInstructions(const inst_lib_t & inst_lib) {
+  emp::vector<BlockRole> roles(inst_lib.GetSize(), BlockRole::NONE);
+  for (size_t id = 0; id < inst_lib.GetSize(); ++id) {
+    if (inst_lib.HasProperty(id, "block_def")) roles[id] = BlockRole::BLOCK_DEF;
+    else if (inst_lib.HasProperty(id, "block_close")) roles[id] = BlockRole::BLOCK_CLOSE;
+  }
+  return roles;
+}
+
+void DecodedProgram::Decode(const program_t & program, const emp::vector<BlockRole> & roles) {
+  Clear();
+  emp::vector<uint32_t> open_blocks;
+  function_offsets.emplace_back(0);
+  for (size_t fp = 0; fp < program.GetSize(); ++fp) {
+    const size_t offset = block_ends.size();
+    const size_t func_size = program[fp].GetSize();
+    block_ends.resize(offset + func_size, (uint32_t)func_size);
+    // Match block-opening instructions with their closes using a stack. A close
+    // with nothing open is ignored; anything left open ends at the end of the function.
+    open_blocks.clear();
+    for (size_t ip = 0; ip < func_size; ++ip) {
+      const size_t inst_id = program[fp][ip].id;
+      emp_assert(inst_id < roles.size());
+      if (roles[inst_id] == BlockRole::BLOCK_DEF) {
+        open_blocks.emplace_back((uint32_t)ip);
+      } else if (roles[inst_id] == BlockRole::BLOCK_CLOSE && open_blocks.size()) {
+        block_ends[offset + open_blocks.back()] = (uint32_t)ip;
+        open_blocks.pop_back();
+      }
+    }
+    function_offsets.emplace_back((uint32_t)block_ends.size());
+  }
+}
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef _DEME_H
 #define _DEME_H
 
+#include <algorithm>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
 
 // Empirical includes
 #include "base/Ptr.h"
@@ -15,7 +18,12 @@
 
 // Local includes
 #include "DOLWorldConfig.h"
+#include "CellBits.h"
+#include "CellSchedule.h"
+#include "DecodedProgram.h"
+#include "DemeTopology.h"
 #include "DigitalOrganism.h"
+#include "MemoryUsage.h"
 
 /*
   Deme Indexing (e.g., 3x3):
@@ -24,6 +32,42 @@
     0 1 2
 */
 
+/*
+  Cell execution modes (how Deme::Advance spends an update's CPU cycles):
+  - INTERLEAVED: every cycle, each cell (in schedule order) executes one step.
+    Messages are queued on the receiver immediately & metabolism happens
+    immediately.
+  - CELL_MAJOR: cycles are split into batches of (up to) k steps. Each batch,
+    each cell (in the batch's schedule order) executes all of the batch's steps
+    before the next cell runs, so a cell's hardware stays in cache for k steps.
+    To keep cells from seeing the effects of steps that (in deme time) haven't
+    happened yet, interactions between cells are buffered until the batch ends:
+    - Messages are delivered at the end of the batch, in the order they were
+      sent. Receivers see them from the next batch on (latency <= k steps, vs.
+      <= 1 cycle interleaved).
+    - Metabolize attempts are resolved at the end of the batch in interleaved
+      order (by step, then by the cell's position in the batch's schedule), so
+      cells compete for shared resources as they would if interleaved. The cell
+      learns nothing at attempt time either way; collected resources reach the
+      cell (e.g., for DonateResources or CellDivide) at the end of the batch.
+    - Messages & resources bound for a cell that was replaced (by division)
+      later in the batch are dropped, as they would have been interleaved.
+    Division isn't buffered: a cell replaced by a neighbor's offspring stops
+    for the rest of the update, so it can lose steps that, interleaved, would
+    have run before the division.
+    The schedule is drawn once per batch (not once per cycle). With k=1 the only
+    differences from interleaved are the end-of-cycle delivery above.
+*/
+enum class CellExecutionMode { INTERLEAVED, CELL_MAJOR };
+
+/// Parse a CELL_EXECUTION_MODE string. Returns false if mode_str isn't a known mode.
+bool ParseCellExecutionMode(const std::string & mode_str, CellExecutionMode & mode) {
+  if (mode_str == "interleaved") mode = CellExecutionMode::INTERLEAVED;
+  else if (mode_str == "cell-major") mode = CellExecutionMode::CELL_MAJOR;
+  else return false;
+  return true;
+}
+
 /// A 'deme' of CellularHardware.
 class Deme {
 public:
@@ -35,11 +79,25 @@ public:
   using tag_t = typename sgp_hardware_t::affinity_t;
   using inst_lib_t = typename sgp_hardware_t::inst_lib_t;
   using event_lib_t = typename sgp_hardware_t::event_lib_t;
+  using event_t = typename sgp_hardware_t::event_t;
+  /// Resolves a buffered metabolize attempt: fun(deme_id, cell_id, resource_id, credit_cell);
+  /// credit_cell is false if the attempting cell has since been replaced
+  using metabolize_fun_t = std::function<void(size_t, size_t, size_t, bool)>;
 
   enum Facing { N=0, NE=1, E=2, SE=3, S=4, SW=5, W=6, NW=7 };                   ///< All possible directions
   static constexpr Facing Dir[] {Facing::N, Facing::NE, Facing::E, Facing::SE,  ///< Array of possible directions
                                 Facing::S, Facing::SW, Facing::W, Facing::NW};
   static constexpr size_t NUM_DIRECTIONS = 8;                                   ///< Number of neighbors each board space has.
+  static_assert(NUM_DIRECTIONS == DemeTopology::NUM_DIRECTIONS, "Deme and DemeTopology disagree on neighborhood size.");
+
+  /// Cell state that's checked/reset across the whole deme, packed one bit per
+  /// cell (see CellBits.h). Each CellularHardware reads & writes its own bits.
+  struct CellState {
+    enum Flag { ACTIVE=0, NEW_BORN, REPRO_TAG_LOCKED, NUM_FLAGS };
+    CellBitRows flags;          ///< One row per Flag
+    CellBitRows sensors;        ///< One row per resource: is cell sensing resource?
+    CellBitRows metabolized;    ///< One row per resource: has cell attempted to metabolize resource this update?
+  };
 
   /// Hardware unit that each cell in a deme 'runs' on
   /// Note, CellularHardware can't extend SGP hardware because SGP programs
@@ -51,36 +109,32 @@ public:
     enum SGPTraitIDs { TRAIT_ID__DEME_ID=0, TRAIT_ID__CELL_ID=1 };
 
     size_t cell_id = 0;
-    bool active = false;
+    emp::Ptr<CellState> state;                  ///< Deme's packed cell state (active, new born, sensors, etc.)
     Facing cell_facing = Facing::N;
     tag_t repro_tag = tag_t();
-    bool repro_tag_locked = false;
-    bool new_born = false;
     sgp_hardware_t sgp_hw;
 
-    emp::vector<bool> resource_sensors;         ///< One sensor per resource
-    emp::vector<bool> metabolized_on_advance;   ///< Which resources is cell attempting to metabolize?
     double local_resources=0.0;                 ///< Reservoir of resources local to this cell
+    size_t queued_event_bytes=0;                ///< Bytes held by events queued since this cell last executed
+    size_t activations=0;                       ///< Times this cell has been activated (identifies its occupant)
 
     CellularHardware(emp::Ptr<emp::Random> _rnd, emp::Ptr<inst_lib_t> _inst_lib,
-                     emp::Ptr<event_lib_t> _event_lib)
-      : sgp_hw(_inst_lib, _event_lib, _rnd) { sgp_hw.ResetHardware(); }
+                     emp::Ptr<event_lib_t> _event_lib, emp::Ptr<CellState> _state, size_t _cell_id)
+      : cell_id(_cell_id), state(_state), sgp_hw(_inst_lib, _event_lib, _rnd) { sgp_hw.ResetHardware(); }
 
     /// On reset:
-    /// - reset signalgp hardware & program
+    /// - reset signalgp hardware (cores, shared memory, event queue)
+    /// - the program is left in place (inactive cells never execute); the next
+    ///   ActivateCell copies over it, reusing its instruction buffers
     /// - todo - clear out traits (non-permanent ones)
     void Reset() {
-      emp_assert(resource_sensors.size() == metabolized_on_advance.size());
-      sgp_hw.ResetProgram();
-      active = false;
-      new_born = false;
+      sgp_hw.ResetHardware();
+      state->flags.ClearCell(cell_id);   // Inactive, not new born, repro tag unlocked
+      state->sensors.ClearCell(cell_id);
+      state->metabolized.ClearCell(cell_id);
       repro_tag.Clear();
-      repro_tag_locked = false;
-      for (size_t i = 0; i < resource_sensors.size(); ++i) {
-        resource_sensors[i] = false;
-        metabolized_on_advance[i] = false;
-      }
       local_resources=0.0;
+      queued_event_bytes=0;
     }
 
     void ActivateCell(const sgp_program_t & program,
@@ -90,26 +144,41 @@ public:
                       bool lock_repro_tag = false) {
       sgp_hw.SetProgram(program);
       sgp_hw.SpawnCore(init_tag, sgp_hw.GetMinBindThresh(), init_mem, init_main);
-      active = true;
+      SetActive(true);
+      ++activations;
       repro_tag = init_tag;
-      repro_tag_locked = lock_repro_tag; // Should we lock this repro tag in?
+      SetReproTagLocked(lock_repro_tag); // Should we lock this repro tag in?
     }
 
     void AdvanceStep() {
       sgp_hw.SingleProcess();
+      queued_event_bytes=0; // SingleProcess handles every queued event
     }
 
-    bool IsSensingResource(size_t res_id) const {
-      emp_assert(res_id < resource_sensors.size());
-      return resource_sensors[res_id];
+    /// Queue an event on this cell's hardware
+    void QueueEvent(const event_t & event) {
+      sgp_hw.QueueEvent(event);
+      queued_event_bytes += MemoryAccounting::EventBytes(event);
     }
 
-    void SetResourceSensor(size_t sensor_id, bool on) {
-      emp_assert(sensor_id < resource_sensors.size());
-      resource_sensors[sensor_id] = on;
-    }
+    bool IsActive() const { return state->flags.Get(CellState::ACTIVE, cell_id); }
+    void SetActive(bool on) { state->flags.Set(CellState::ACTIVE, cell_id, on); }
+
+    /// New born cells don't execute until the update after they're born
+    bool IsNewBorn() const { return state->flags.Get(CellState::NEW_BORN, cell_id); }
+    void SetNewBorn(bool on) { state->flags.Set(CellState::NEW_BORN, cell_id, on); }
 
-    void LockReproTag(const tag_t & tag) { repro_tag_locked = true; repro_tag = tag; }
+    bool IsReproTagLocked() const { return state->flags.Get(CellState::REPRO_TAG_LOCKED, cell_id); }
+    void SetReproTagLocked(bool on) { state->flags.Set(CellState::REPRO_TAG_LOCKED, cell_id, on); }
+
+    bool IsSensingResource(size_t res_id) const { return state->sensors.Get(res_id, cell_id); }
+    void SetResourceSensor(size_t sensor_id, bool on) { state->sensors.Set(sensor_id, cell_id, on); }
+
+    /// Has this cell attempted to metabolize res_id this update?
+    bool HasMetabolized(size_t res_id) const { return state->metabolized.Get(res_id, cell_id); }
+    void SetMetabolized(size_t res_id, bool on=true) { state->metabolized.Set(res_id, cell_id, on); }
+
+    void LockReproTag(const tag_t & tag) { SetReproTagLocked(true); repro_tag = tag; }
 
     /// Rotate cell clockwise a given number of steps
     void RotateCW(int rot=1) {
@@ -142,31 +211,76 @@ private:
   size_t width;                        ///< Width of grid
   size_t height;                       ///< Height of grid
   emp::Ptr<emp::Random> random_ptr;
-  emp::vector<size_t> neighbor_lookup; ///< Lookup table for neighbors
+  bool owns_random = false;            ///< Does this deme own (and delete) random_ptr?
+  std::shared_ptr<const DemeTopology> topology; ///< Neighbor lookup (shared by all demes with these dimensions)
+  CellState cell_state;                ///< Packed state of every cell (see CellState)
   emp::vector<CellularHardware> cells; ///< Toroidal grid of CellularHardware units
-  emp::vector<size_t> cell_schedule;   ///< Order to execute cells
+  CellScheduler scheduler;             ///< Order to execute cells (see CellSchedule.h)
+  emp::Ptr<const DecodedProgram> decoded_program=nullptr; ///< Pre-decoded block structure of the program this deme's cells run (owned by the organism's genotype)
+
+  /// Message sent during a cell-major batch (delivered when the batch ends)
+  struct PendingMessage {
+    size_t cell_id;
+    size_t activations;    ///< Receiver's activation count when sent
+    event_t event;
+  };
+
+  /// Metabolize attempt made during a cell-major batch (resolved when the batch ends)
+  struct PendingMetabolism {
+    size_t step;           ///< Cycle (within the update) of the attempt
+    size_t rank;           ///< Attempting cell's position in the batch's schedule
+    size_t cell_id;
+    size_t activations;    ///< Attempting cell's activation count at the attempt
+    size_t resource_id;
+
+    bool operator<(const PendingMetabolism & in) const {
+      return (step != in.step) ? step < in.step : rank < in.rank;
+    }
+  };
 
-  /// Build neighbor lookup (according to current width and height)
-  void BuildNeighborLookup();
+  CellExecutionMode execution_mode = CellExecutionMode::INTERLEAVED;
+  size_t batch_steps = 1;              ///< Steps per cell per batch (CELL_MAJOR)
+  bool buffering = false;              ///< Inside a cell-major batch? (buffer messages & metabolism)
+  size_t cur_step = 0;                 ///< Cycle the executing cell is on (CELL_MAJOR)
+  size_t cur_rank = 0;                 ///< Executing cell's position in the batch's schedule (CELL_MAJOR)
+  emp::vector<PendingMessage> pending_messages;
+  emp::vector<PendingMetabolism> pending_metabolism;
+  metabolize_fun_t fun_metabolize;     ///< Resolves buffered metabolize attempts
 
-  /// Calculate the neighbor ID of the cell (specified by id) in the specified direction.
-  size_t CalcNeighbor(size_t id, Facing dir) const;
+  /// Advance in cell-major batches (see CellExecutionMode)
+  void AdvanceCellMajor(size_t steps);
+
+  /// Deliver buffered messages & resolve buffered metabolize attempts
+  void EndBatch();
 
 public:
+  /// If _owns_random, the deme takes ownership of _rnd (deleted with the deme).
   Deme(size_t _width, size_t _height, emp::Ptr<emp::Random> _rnd,
-      emp::Ptr<inst_lib_t> _inst_lib, emp::Ptr<event_lib_t> _event_lib)
-    : width(_width), height(_height), random_ptr(_rnd)
+      emp::Ptr<inst_lib_t> _inst_lib, emp::Ptr<event_lib_t> _event_lib, bool _owns_random=false)
+    : width(_width), height(_height), random_ptr(_rnd), owns_random(_owns_random), topology(DemeTopology::Get(_width, _height)),
+      scheduler(_rnd, _width*_height)
   {
+    cell_state.flags.Resize(width*height, CellState::NUM_FLAGS);
+    cell_state.sensors.Resize(width*height, 0);       // (resources are added by SetupCellMetabolism)
+    cell_state.metabolized.Resize(width*height, 0);
     for (size_t i = 0; i < width*height; ++i) {
-      cells.emplace_back(_rnd, _inst_lib, _event_lib);
-      cells.back().cell_id = i; // Cell id corresponds to position in cells vector
+      // Cell id corresponds to position in cells vector
+      cells.emplace_back(_rnd, _inst_lib, _event_lib, emp::Ptr<CellState>(&cell_state), i);
       cells.back().sgp_hw.SetTrait(CellularHardware::SGPTraitIDs::TRAIT_ID__CELL_ID, i);
       cells.back().sgp_hw.SetTrait(CellularHardware::SGPTraitIDs::TRAIT_ID__DEME_ID, deme_id);
-      cell_schedule.emplace_back(i);
     }
-    BuildNeighborLookup();
   }
 
+  Deme(const Deme &) = delete;
+  Deme & operator=(const Deme &) = delete;
+
+  ~Deme() {
+    if (owns_random) random_ptr.Delete();
+  }
+
+  /// Get the random number generator this deme's cells draw from
+  emp::Random & GetRandom() { return *random_ptr; }
+
   /// Setup cell metabolisms
   void SetupCellMetabolism(size_t num_resources);
 
@@ -194,17 +308,45 @@ public:
   /// Get const cell at position ID (outsource bounds checking to emp::vector)
   const CellularHardware & GetCell(size_t id) const { return cells[id]; }
 
+  /// Get the pre-decoded form of the program running on this deme's cells
+  const DecodedProgram & GetDecodedProgram() const { emp_assert(decoded_program); return *decoded_program; }
+
+  /// Run this deme's cells against a program decoded elsewhere (which must outlive
+  /// its use here; e.g., the genotype of the organism loaded onto this deme)
+  void SetDecodedProgram(const DecodedProgram & program) { decoded_program = &program; }
+
   /// Get cell ID's current facing
   Facing GetCellFacing(size_t id) const { return cells[id].cell_facing; }
 
   /// Is cell @ ID active?
-  bool IsCellActive(size_t id) const { return cells[id].active; }
+  bool IsCellActive(size_t id) const { return cell_state.flags.Get(CellState::ACTIVE, id); }
+
+  /// Is cell @ ID active & not new born (i.e., does it execute this update)?
+  bool IsCellRunnable(size_t id) const {
+    const size_t w = CellBitRows::WordID(id);
+    const uint64_t runnable = cell_state.flags.GetRow(CellState::ACTIVE)[w] & ~cell_state.flags.GetRow(CellState::NEW_BORN)[w];
+    return runnable & CellBitRows::BitMask(id);
+  }
+
+  /// Number of active cells
+  size_t GetNumActiveCells() const { return cell_state.flags.CountRow(CellState::ACTIVE); }
+
+  /// Call fun(cell_id) for every active cell sensing resource res_id (in cell id order)
+  template<typename FUN>
+  void ForEachCellSensing(size_t res_id, FUN && fun) const {
+    const uint64_t * active = cell_state.flags.GetRow(CellState::ACTIVE);
+    const uint64_t * sensing = cell_state.sensors.GetRow(res_id);
+    ForEachSetBit(cell_state.flags.GetWordsPerRow(), [active, sensing](size_t w) { return active[w] & sensing[w]; }, fun);
+  }
 
   /// Is cell @ ID sensing the specified resource?
   bool IsCellSensingResource(size_t id, size_t res_id) const { return cells[id].IsSensingResource(res_id); }
 
   /// Given a cell ID and facing (of that cell), return the appropriate neighboring cell ID
-  size_t GetNeighboringCellID(size_t id, Facing dir) const { return neighbor_lookup[id*NUM_DIRECTIONS + (size_t)dir]; }
+  size_t GetNeighboringCellID(size_t id, Facing dir) const { return topology->GetNeighbor(id, (size_t)dir); }
+
+  /// Get this deme's (shared) topology
+  const DemeTopology & GetTopology() const { return *topology; }
 
   /// Set this deme's ID
   void SetDemeID(size_t id);
@@ -221,6 +363,40 @@ public:
   /// Set SignalGP hardware (on cellular hardware) tie break procedure
   void SetCellHardwareStochasticTieBreaks(bool val);
 
+  /// Set cell scheduling strategy (PERMUTATION_TABLE requires a table over this deme's cells)
+  void SetCellScheduleMode(CellScheduleMode mode, std::shared_ptr<const CellPermutationTable> table=nullptr) {
+    scheduler.SetMode(mode, table);
+  }
+
+  /// Set how cells execute each update (see CellExecutionMode). CELL_MAJOR
+  /// needs a metabolize function to resolve buffered metabolize attempts.
+  void SetCellExecutionMode(CellExecutionMode mode, size_t _batch_steps=1, const metabolize_fun_t & _fun_metabolize=nullptr) {
+    emp_assert(_batch_steps > 0);
+    emp_assert(mode == CellExecutionMode::INTERLEAVED || _fun_metabolize);
+    execution_mode = mode;
+    batch_steps = _batch_steps;
+    fun_metabolize = _fun_metabolize;
+  }
+
+  CellExecutionMode GetCellExecutionMode() const { return execution_mode; }
+
+  /// Are cell interactions currently being buffered (inside a cell-major batch)?
+  bool IsBuffering() const { return buffering; }
+
+  /// Send event to a cell: queued immediately, or at the end of the current
+  /// batch if buffering
+  void SendEvent(size_t cell_id, const event_t & event) {
+    if (buffering) pending_messages.push_back({cell_id, cells[cell_id].activations, event});
+    else cells[cell_id].QueueEvent(event);
+  }
+
+  /// Buffer the executing cell's attempt to metabolize resource_id (only while
+  /// buffering; resolved at the end of the batch)
+  void DeferMetabolism(size_t cell_id, size_t resource_id) {
+    emp_assert(buffering);
+    pending_metabolism.push_back({cur_step, cur_rank, cell_id, cells[cell_id].activations, resource_id});
+  }
+
   /// Set cell facing
   void SetCellFacing(size_t id, Facing facing) { cells[id].cell_facing = facing; }
 
@@ -243,36 +419,38 @@ public:
     for (CellularHardware & cell : cells) {
       cell.Reset(); // Reset cell
     }
+    decoded_program = nullptr;
     deme_active = false;
   }
 
   void Advance(size_t steps) {
-    // Reset each cell's metabolism tracker
-    for (CellularHardware & cell : cells) {
-      for (size_t m = 0; m < cell.metabolized_on_advance.size(); ++m) {
-        cell.metabolized_on_advance[m] = false;
-        cell.new_born = false; // If cell was new born prior to this, it isn't anymore
-      }
-    }
+    // Reset every cell's metabolism tracker; cells born last update aren't new born anymore
+    cell_state.metabolized.ClearAll();
+    cell_state.flags.ClearRow(CellState::NEW_BORN);
     // Advance the deme hardware!
+    scheduler.BeginUpdate();
+    if (execution_mode == CellExecutionMode::CELL_MAJOR) {
+      AdvanceCellMajor(steps);
+      return;
+    }
     for (size_t i = 0; i < steps; ++i) {
       SingleAdvance();
     }
   }
 
   void SingleAdvance() {
-    // Advance cells in random order
-    emp::Shuffle(*random_ptr, cell_schedule);
-    for (size_t id : cell_schedule) {
-      if (!cells[id].active || cells[id].new_born) {
-        continue;
-      }
-      CellularHardware & cell = cells[id];
-      cell.AdvanceStep(); // Advance cell by one step
+    // Advance cells in scheduled order
+    scheduler.ForEachCell([this](size_t id) {
+      if (!IsCellRunnable(id)) return;
+      cells[id].AdvanceStep(); // Advance cell by one step
       // todo - if no threads and no sensors => mark as deactivated! => Maybe not?
-    }
+    });
   }
 
+  /// Add the bytes held by this deme's hardware (cells, programs, SignalGP state,
+  /// event queues) to usage. The shared neighbor table isn't included (see DemeTopology).
+  void MeasureMemory(MemoryUsage & usage);
+
   /// Return a string representation of the given facing direction (useful for debugging)
   std::string FacingStr(Facing dir) const;
 
@@ -280,62 +458,45 @@ public:
   void PrintNeighborMap(std::ostream & os = std::cout) const;
 };
 
-void Deme::BuildNeighborLookup()  {
-  const size_t num_cells = width * height;
-  neighbor_lookup.resize(num_cells * NUM_DIRECTIONS);
-  for (size_t i = 0; i < num_cells; ++i) {
-    for (size_t d = 0; d < NUM_DIRECTIONS; ++d) {
-      neighbor_lookup[i*NUM_DIRECTIONS + d] = CalcNeighbor(i, Dir[d]);
-    }
+void Deme::AdvanceCellMajor(size_t steps) {
+  emp_assert(fun_metabolize);
+  for (size_t batch_start = 0; batch_start < steps; batch_start += batch_steps) {
+    const size_t batch_end = std::min(steps, batch_start + batch_steps);
+    buffering = true;
+    cur_rank = 0;
+    scheduler.ForEachCell([this, batch_start, batch_end](size_t id) {
+      CellularHardware & cell = cells[id];
+      for (cur_step = batch_start; cur_step < batch_end; ++cur_step) {
+        // Cells can be replaced mid-batch (new borns don't run until next update)
+        if (!IsCellRunnable(id)) break;
+        cell.AdvanceStep();
+      }
+      ++cur_rank;
+    });
+    buffering = false;
+    EndBatch();
   }
 }
 
-size_t Deme::CalcNeighbor(size_t id, Facing dir) const {
-  int facing_y = (int)GetCellY(id);
-  int facing_x = (int)GetCellX(id);
-  switch (dir) {
-    case Facing::N:
-      facing_y = emp::Mod(facing_y + 1, (int)height);
-      break;
-    case Facing::NE:
-      facing_x = emp::Mod(facing_x + 1, (int)width);
-      facing_y = emp::Mod(facing_y + 1, (int)height);
-      break;
-    case Facing::E:
-      facing_x = emp::Mod(facing_x + 1, (int)width);
-      break;
-    case Facing::SE:
-      facing_x = emp::Mod(facing_x + 1, (int)width);
-      facing_y = emp::Mod(facing_y - 1, (int)height);
-      break;
-    case Facing::S:
-      facing_y = emp::Mod(facing_y - 1, (int)height);
-      break;
-    case Facing::SW:
-      facing_x = emp::Mod(facing_x - 1, (int)width);
-      facing_y = emp::Mod(facing_y - 1, (int)height);
-      break;
-    case Facing::W:
-      facing_x = emp::Mod(facing_x - 1, (int)width);
-      break;
-    case Facing::NW:
-      facing_x = emp::Mod(facing_x - 1, (int)width);
-      facing_y = emp::Mod(facing_y + 1, (int)height);
-      break;
-    default:
-      emp_assert(false, "Invalid direction!");
-      break;
+void Deme::EndBatch() {
+  // Messages, in the order they were sent (dropped if the receiver was replaced)
+  for (const PendingMessage & msg : pending_messages) {
+    CellularHardware & cell = cells[msg.cell_id];
+    if (cell.IsActive() && cell.activations == msg.activations) cell.QueueEvent(msg.event);
   }
-  return GetCellID(facing_x, facing_y);
+  pending_messages.clear();
+  // Metabolism, in interleaved order (stable: a cell's attempts in one step stay in order)
+  std::stable_sort(pending_metabolism.begin(), pending_metabolism.end());
+  for (const PendingMetabolism & attempt : pending_metabolism) {
+    const bool credit_cell = cells[attempt.cell_id].activations == attempt.activations;
+    fun_metabolize(deme_id, attempt.cell_id, attempt.resource_id, credit_cell);
+  }
+  pending_metabolism.clear();
 }
 
 void Deme::SetupCellMetabolism(size_t num_resources) {
-  for (CellularHardware & cell : cells) {
-    cell.metabolized_on_advance.clear();
-    cell.resource_sensors.clear();
-    cell.metabolized_on_advance.resize(num_resources, false);
-    cell.resource_sensors.resize(num_resources, false);
-  }
+  cell_state.sensors.Resize(cells.size(), num_resources);
+  cell_state.metabolized.Resize(cells.size(), num_resources);
 }
 
 void Deme::SetDemeID(size_t id) {
@@ -388,6 +549,22 @@ void Deme::RotateCellCCW(size_t cell_id, int rot /* = 1*/) {
   cell.RotateCCW(rot);
 }
 
+void Deme::MeasureMemory(MemoryUsage & usage) {
+  usage.cell_state += sizeof(Deme)
+                    + MemoryAccounting::VectorBytes(cells)
+                    + scheduler.GetMemoryBytes()
+                    + MemoryAccounting::VectorBytes(pending_metabolism)
+                    + cell_state.flags.GetMemoryBytes()
+                    + cell_state.sensors.GetMemoryBytes()
+                    + cell_state.metabolized.GetMemoryBytes();
+  usage.event_queues += MemoryAccounting::VectorBytes(pending_messages);
+  for (CellularHardware & cell : cells) {
+    usage.cell_programs += MemoryAccounting::ProgramBytes(cell.sgp_hw.GetProgram());
+    usage.event_queues += cell.queued_event_bytes;
+    MemoryAccounting::AddHardwareBytes(cell.sgp_hw, usage);
+  }
+}
+
 /// Given a Facing direction, return a representative string (useful for debugging)
 std::string Deme::FacingStr(Facing dir) const {
   switch (dir) {
@@ -411,7 +588,7 @@ void Deme::PrintNeighborMap(std::ostream & os /*= std::cout*/) const {
   for (size_t i = 0; i < num_cells; ++i) {
     os << i << " (" << GetCellX(i) << ", " << GetCellY(i) << "): " << std::endl;
     for (size_t d = 0; d < NUM_DIRECTIONS; ++d) {
-      const size_t neighbor_id = neighbor_lookup[i*NUM_DIRECTIONS + d];
+      const size_t neighbor_id = GetNeighboringCellID(i, Dir[d]);
       os << "  " << FacingStr(Dir[d]) << "(" << d << "): " << neighbor_id << "(" << GetCellX(neighbor_id) << ", " << GetCellY(neighbor_id) << ")" << std::endl;
     }
   }
@@ -0,0 +1,116 @@
+/**
+ *  @date 2019
+ *
+ *  @file  DemeTopology.h
+ *
+ *  Neighbor lookup tables for toroidal deme grids. Every deme of a given width
+ *  and height has the same neighborhood structure, so tables are built once per
+ *  (width, height) and shared (read-only) by every deme that uses them. Neighbor
+ *  ids are stored in the narrowest unsigned integer type that can hold every
+ *  cell id (uint8_t for demes of up to 256 cells, etc.).
+ *
+ *  Directions are indexed in Deme::Facing order: N, NE, E, SE, S, SW, W, NW.
+ */
+
+#ifndef _DEME_TOPOLOGY_H
+#define _DEME_TOPOLOGY_H
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "base/vector.h"
+#include "tools/math.h"
+
+class DemeTopology {
+public:
+  static constexpr size_t NUM_DIRECTIONS = 8;
+
+protected:
+  size_t width;
+  size_t height;
+  size_t id_bytes;                ///< Bytes per stored neighbor id (1, 2, or 4)
+  emp::vector<uint8_t> table8;    ///< Neighbor table (if id_bytes == 1)
+  emp::vector<uint16_t> table16;  ///< Neighbor table (if id_bytes == 2)
+  emp::vector<uint32_t> table32;  ///< Neighbor table (if id_bytes == 4)
+
+  /// Fill the given table: entry [id*NUM_DIRECTIONS + dir] = neighbor of id in direction dir
+  template<typename T>
+  void BuildTable(emp::vector<T> & table) {
+    static constexpr int dx[NUM_DIRECTIONS] = { 0,  1, 1,  1,  0, -1, -1, -1 };
+    static constexpr int dy[NUM_DIRECTIONS] = { 1,  1, 0, -1, -1, -1,  0,  1 };
+    const size_t num_cells = width * height;
+    table.resize(num_cells * NUM_DIRECTIONS);
+    for (size_t id = 0; id < num_cells; ++id) {
+      const int x = (int)(id % width);
+      const int y = (int)(id / width);
+      for (size_t d = 0; d < NUM_DIRECTIONS; ++d) {
+        const size_t nx = (size_t)emp::Mod(x + dx[d], (int)width);
+        const size_t ny = (size_t)emp::Mod(y + dy[d], (int)height);
+        table[id * NUM_DIRECTIONS + d] = (T)(ny * width + nx);
+      }
+    }
+  }
+
+public:
+  /// Prefer DemeTopology::Get (shares tables between demes).
+  DemeTopology(size_t _width, size_t _height) : width(_width), height(_height) {
+    const size_t num_cells = width * height;
+    emp_assert(num_cells > 0);
+    emp_assert(num_cells - 1 <= std::numeric_limits<uint32_t>::max(), "Deme too large for neighbor table.");
+    if (num_cells - 1 <= std::numeric_limits<uint8_t>::max()) {
+      id_bytes = 1;
+      BuildTable(table8);
+    } else if (num_cells - 1 <= std::numeric_limits<uint16_t>::max()) {
+      id_bytes = 2;
+      BuildTable(table16);
+    } else {
+      id_bytes = 4;
+      BuildTable(table32);
+    }
+  }
+
+  /// Get the shared topology for demes of the given dimensions (built on first
+  /// use; freed once no deme references it)
+  static std::shared_ptr<const DemeTopology> Get(size_t width, size_t height) {
+    static std::mutex registry_mutex;
+    static std::map<std::pair<size_t,size_t>, std::weak_ptr<const DemeTopology>> registry;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::weak_ptr<const DemeTopology> & entry = registry[{width, height}];
+    std::shared_ptr<const DemeTopology> topology = entry.lock();
+    if (!topology) {
+      topology = std::make_shared<DemeTopology>(width, height);
+      entry = topology;
+    }
+    return topology;
+  }
+
+  size_t GetWidth() const { return width; }
+  size_t GetHeight() const { return height; }
+  size_t GetNumCells() const { return width * height; }
+
+  /// Bytes used to store each neighbor id
+  size_t GetIDBytes() const { return id_bytes; }
+
+  /// Given a cell id and direction (Deme::Facing order), return the neighboring cell id
+  size_t GetNeighbor(size_t id, size_t dir) const {
+    emp_assert(id < GetNumCells() && dir < NUM_DIRECTIONS);
+    const size_t i = id * NUM_DIRECTIONS + dir;
+    switch (id_bytes) {
+      case 1: return table8[i];
+      case 2: return table16[i];
+      default: return table32[i];
+    }
+  }
+
+  /// Heap bytes held by the neighbor table
+  size_t GetMemoryBytes() const {
+    return table8.capacity() * sizeof(uint8_t) + table16.capacity() * sizeof(uint16_t)
+         + table32.capacity() * sizeof(uint32_t);
+  }
+};
+
+#endif
@@ -4,7 +4,8 @@
  *  @file  DigitalOrganism.h
  *
  *  The DigitalOrganism class represents a digital organism. A digital organism
- *  has a phenotype and a genotype.
+ *  has a phenotype and a genotype. Genotypes are shared (see GenotypeStore.h):
+ *  an organism holds a handle to its genome, not a copy.
  */
 
 #ifndef _DIGITAL_ORGANISM_H
@@ -14,6 +15,8 @@
 #include "hardware/signalgp_utils.h"
 
 #include "DOLWorldConfig.h"
+#include "DecodedProgram.h"
+#include "GenotypeStore.h"
 
 class DigitalOrganism {
 public:
@@ -32,8 +35,67 @@ public:
 
     Genome(const program_t & _program)
       : program(_program) {}
+
+    bool operator==(const Genome & in) const { return birth_tag == in.birth_tag && program == in.program; }
+    bool operator!=(const Genome & in) const { return !(*this == in); }
+  };
+
+  /// Merkle-style genome hash: one hash per function, combined (with the birth
+  /// tag) into the genome's hash. A mutated genome's digest can be updated by
+  /// rehashing only the functions that changed (see MutationDelta in Mutator.h).
+  struct GenomeDigest {
+    emp::vector<size_t> function_hashes;
+    size_t hash=0;
+  };
+
+  /// Content hash of a genome (see GenotypeStore.h)
+  struct GenomeHash {
+    using digest_t = GenomeDigest;
+
+    static size_t HashTag(size_t seed, const tag_t & tag) {
+      for (size_t w = 0; w < (DOLWorldConstants::TAG_WIDTH + 31) / 32; ++w) seed = CombineHash(seed, tag.GetUInt(w));
+      return seed;
+    }
+
+    /// Function tag, then each instruction's operation, arguments, & tag
+    template<typename FUNCTION>
+    static size_t HashFunction(const FUNCTION & function) {
+      size_t hash = HashTag(function.GetSize(), function.affinity);
+      for (const auto & inst : function.inst_seq) {
+        hash = CombineHash(hash, inst.id);
+        for (const auto & arg : inst.args) hash = CombineHash(hash, (size_t)arg);
+        hash = HashTag(hash, inst.affinity);
+      }
+      return hash;
+    }
+
+    /// Combine function hashes (in program order) & the birth tag
+    static size_t HashGenome(const emp::vector<size_t> & function_hashes, const tag_t & birth_tag) {
+      size_t hash = HashTag(function_hashes.size(), birth_tag);
+      for (size_t function_hash : function_hashes) hash = CombineHash(hash, function_hash);
+      return hash;
+    }
+
+    static void Digest(const Genome & genome, GenomeDigest & digest) {
+      digest.function_hashes.resize(genome.program.GetSize());
+      for (size_t fID = 0; fID < genome.program.GetSize(); ++fID) {
+        digest.function_hashes[fID] = HashFunction(genome.program[fID]);
+      }
+      digest.hash = HashGenome(digest.function_hashes, genome.birth_tag);
+    }
+
+    static size_t GetHash(const GenomeDigest & digest) { return digest.hash; }
+
+    size_t operator()(const Genome & genome) const {
+      GenomeDigest digest;
+      Digest(genome, digest);
+      return digest.hash;
+    }
   };
 
+  using genotype_store_t = GenotypeStore<Genome, GenomeHash, DecodedProgram>;  ///< Genotypes keep their decoded program
+  using genotype_t = typename genotype_store_t::Handle;
+
   struct Phenotype {
     size_t age=0;                     ///< How many updates has this organism been alive?
     bool trigger_repro=false;         ///< Trigger reproduction?
@@ -67,20 +129,35 @@ public:
 
 protected:
   size_t org_id = 0;
-  Genome genome;
+  genotype_t genotype;
   Phenotype phenotype;
 
 public:
-  DigitalOrganism(const Genome & _genome) : genome(_genome) {}
+  /// New organism with its own (standalone) copy of a genome
+  DigitalOrganism(const Genome & _genome) : genotype(genotype_store_t::NewStandalone(_genome)) {}
+
+  /// New organism sharing an existing genotype (O(1))
+  DigitalOrganism(const genotype_t & _genotype) : genotype(_genotype) {}
 
   /// Get organism id
   size_t GetOrgID() const { return org_id; }
 
-  /// Get reference to digital organism genome.
-  Genome & GetGenome() { return genome; }
+  /// Get const reference to digital organism genome (may be shared with other organisms).
+  const Genome & GetGenome() const { return genotype.GetGenome(); }
+
+  /// Get digital organism's genotype handle.
+  const genotype_t & GetGenotype() const { return genotype; }
 
-  /// Get const reference to digital organism genome.
-  const Genome & GetGenome() const { return genome; }
+  /// Switch to a different (e.g., interned) genotype.
+  void SetGenotype(const genotype_t & _genotype) { genotype = _genotype; }
+
+  /// Replace this organism's genome (with a new standalone genotype).
+  void SetGenome(Genome && _genome) { genotype = genotype_store_t::NewStandalone(std::move(_genome)); }
+
+  /// Replace this organism's genome, whose digest is already known.
+  void SetGenome(Genome && _genome, GenomeDigest && _digest) {
+    genotype = genotype_store_t::NewStandalone(std::move(_genome), std::move(_digest));
+  }
 
   /// Get reference to digital organism's phenotype.
   Phenotype & GetPhenotype() { return phenotype; }
@@ -0,0 +1,639 @@
+/**
+ *  @date 2019
+ *
+ *  @file  EventTrace.h
+ *
+ *  Compact binary event trace (+ deterministic replay).
+ *
+ *  A trace is a header followed by a stream of records. Each record is a one-byte
+ *  record type followed by LEB128 varint fields. Population positions are
+ *  zigzag-delta encoded against the previous record's position (events from the
+ *  same deme cluster together, so most deltas fit in a single byte).
+ *
+ *  Events are recorded into per-lane buffers (e.g., one lane per thread of
+ *  execution) and flushed to the trace file, in lane order, at the
+ *  end of every update. Every TRACE_KEYFRAME_INTERVAL updates, the trace also
+ *  stores a keyframe: a full snapshot of the replayable State. Replay seeks to
+ *  the nearest keyframe at or before the requested update and applies recorded
+ *  events from there, which is much cheaper than re-simulating.
+ *
+ *  Replayable state (see EventTrace::State): which population positions are
+ *  occupied, which cells in each deme are active, cell resource sensors, and each
+ *  organism's consumption tracking (successes/failures per resource, total
+ *  collected). Pulses and messages are recorded as events but don't change
+ *  replayable state.
+ *
+ *  Environment resource levels change every update (pulses, decay, and
+ *  consumption), and only some of that is recorded as events, so they're stored
+ *  in keyframes only: a rebuilt state has them only at keyframe updates (see
+ *  Seek). Replay can't go past the last recorded update, either.
+ *
+ *  File layout:
+ *    header:  "DOLTRACE" version pop_size deme_width deme_height num_resources keyframe_interval
+ *    records: ...
+ *    footer:  INDEX record (keyframe update/offset pairs), 8-byte index offset, "DOLTRACE"
+ */
+
+#ifndef _EVENT_TRACE_H
+#define _EVENT_TRACE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "base/vector.h"
+
+#include "BinaryIO.h"
+
+class EventTrace {
+public:
+  static constexpr const char * MAGIC = "DOLTRACE";
+  static constexpr size_t MAGIC_SIZE = 8;
+  static constexpr uint64_t VERSION = 2;
+
+  /// Record types
+  enum RecordType : uint8_t {
+    UPDATE=1,     ///< update
+    LANE,         ///< (start of a lane's records; resets position deltas)
+    PULSE,        ///< pos resource
+    METABOLIZE,   ///< pos cell (resource<<1 | success) [collected]
+    DIVISION,     ///< pos parent_cell offspring_cell
+    MESSAGE,      ///< pos from_cell to_cell
+    SENSOR,       ///< pos cell (resource<<1 | on)
+    BIRTH,        ///< pos seed_cell
+    DEATH,        ///< pos
+    KEYFRAME,     ///< update State (incl. resource levels)
+    INDEX         ///< count (update offset)*
+  };
+
+  /// Trace-wide settings
+  struct Header {
+    size_t pop_size=0;
+    size_t deme_width=0;
+    size_t deme_height=0;
+    size_t num_resources=0;
+    size_t keyframe_interval=0;
+
+    size_t GetDemeCapacity() const { return deme_width * deme_height; }
+  };
+
+  /// Replayable state of a single population position
+  struct OrgState {
+    bool occupied=false;
+    emp::vector<bool> active_cells;           ///< Per cell
+    emp::vector<bool> sensors;                ///< Per cell * num_resources + resource
+    emp::vector<size_t> consumption_successes; ///< Per resource
+    emp::vector<size_t> consumption_failures;  ///< Per resource
+    double total_resources_collected=0.0;
+
+    void Reset(const Header & header) {
+      occupied = false;
+      active_cells.assign(header.GetDemeCapacity(), false);
+      sensors.assign(header.GetDemeCapacity() * header.num_resources, false);
+      consumption_successes.assign(header.num_resources, 0);
+      consumption_failures.assign(header.num_resources, 0);
+      total_resources_collected = 0.0;
+    }
+
+    bool operator==(const OrgState & other) const {
+      return occupied == other.occupied && active_cells == other.active_cells
+             && sensors == other.sensors && consumption_successes == other.consumption_successes
+             && consumption_failures == other.consumption_failures
+             && total_resources_collected == other.total_resources_collected;
+    }
+  };
+
+  /// Replayable state of the whole population (at the beginning of an update)
+  struct State {
+    size_t update=0;
+    emp::vector<OrgState> orgs;
+    bool has_resource_levels=false;       ///< Are resource levels known? (keyframe updates only)
+    emp::vector<double> resource_levels;  ///< Per position * num_resources + resource (occupied positions' environments)
+
+    void Reset(const Header & header) {
+      update = 0;
+      orgs.resize(header.pop_size);
+      for (OrgState & org : orgs) org.Reset(header);
+      has_resource_levels = false;
+      resource_levels.assign(header.pop_size * header.num_resources, 0.0);
+    }
+  };
+
+  using Buffer = BinaryBuffer;
+  using Cursor = BinaryCursor;
+
+  /// Per-thread record buffer
+  class Lane {
+  protected:
+    Buffer buffer;
+    size_t prev_pos=0;  ///< Position of previous record (for delta encoding)
+
+    void PutPos(size_t pos) {
+      buffer.PutZigzag((int64_t)pos - (int64_t)prev_pos);
+      prev_pos = pos;
+    }
+
+  public:
+    Buffer & GetBuffer() { return buffer; }
+    void Clear() { buffer.Clear(); prev_pos = 0; }
+
+    void Pulse(size_t pos, size_t res_id) {
+      buffer.PutByte(RecordType::PULSE); PutPos(pos); buffer.PutVarint(res_id);
+    }
+
+    void Metabolize(size_t pos, size_t cell_id, size_t res_id, bool success, double collected) {
+      buffer.PutByte(RecordType::METABOLIZE); PutPos(pos); buffer.PutVarint(cell_id);
+      buffer.PutVarint((res_id << 1) | (size_t)success);
+      if (success) buffer.PutDouble(collected);
+    }
+
+    void Division(size_t pos, size_t parent_cell_id, size_t offspring_cell_id) {
+      buffer.PutByte(RecordType::DIVISION); PutPos(pos);
+      buffer.PutVarint(parent_cell_id); buffer.PutVarint(offspring_cell_id);
+    }
+
+    void Message(size_t pos, size_t from_cell_id, size_t to_cell_id) {
+      buffer.PutByte(RecordType::MESSAGE); PutPos(pos);
+      buffer.PutVarint(from_cell_id); buffer.PutVarint(to_cell_id);
+    }
+
+    void Sensor(size_t pos, size_t cell_id, size_t res_id, bool on) {
+      buffer.PutByte(RecordType::SENSOR); PutPos(pos); buffer.PutVarint(cell_id);
+      buffer.PutVarint((res_id << 1) | (size_t)on);
+    }
+
+    void Birth(size_t pos, size_t seed_cell_id) {
+      buffer.PutByte(RecordType::BIRTH); PutPos(pos); buffer.PutVarint(seed_cell_id);
+    }
+
+    void Death(size_t pos) {
+      buffer.PutByte(RecordType::DEATH); PutPos(pos);
+    }
+  };
+
+protected:
+  Header header;
+  std::ofstream out;
+  emp::vector<Lane> lanes;
+  Buffer scratch;                             ///< Update markers, keyframes, footer
+  emp::vector<std::pair<size_t,size_t>> keyframe_index; ///< (update, file offset of update marker) for every keyframe
+  size_t file_offset=0;
+  size_t update_offset=0;                     ///< File offset of the current update's marker
+
+  void Write(Buffer & buffer) {
+    out.write((const char *)buffer.bytes.data(), (std::streamsize)buffer.bytes.size());
+    file_offset += buffer.bytes.size();
+    buffer.Clear();
+  }
+
+  static void PutHeader(Buffer & buffer, const Header & header) {
+    for (size_t i = 0; i < MAGIC_SIZE; ++i) buffer.PutByte((uint8_t)MAGIC[i]);
+    buffer.PutVarint(VERSION);
+    buffer.PutVarint(header.pop_size);
+    buffer.PutVarint(header.deme_width);
+    buffer.PutVarint(header.deme_height);
+    buffer.PutVarint(header.num_resources);
+    buffer.PutVarint(header.keyframe_interval);
+  }
+
+public:
+  EventTrace(const Header & _header, size_t num_lanes=1)
+    : header(_header), lanes(num_lanes) { emp_assert(num_lanes > 0); }
+
+  ~EventTrace() { Close(); }
+
+  const Header & GetHeader() const { return header; }
+  size_t GetNumLanes() const { return lanes.size(); }
+  Lane & GetLane(size_t id) { return lanes[id]; }
+  bool IsOpen() const { return out.is_open(); }
+
+  /// Should a keyframe be recorded at the beginning of the given update?
+  bool IsKeyframeUpdate(size_t update) const {
+    return header.keyframe_interval && (update % header.keyframe_interval == 0);
+  }
+
+  /// Open trace file & write header. Returns false on failure.
+  bool Open(const std::string & path);
+
+  /// Mark the beginning of an update
+  void BeginUpdate(size_t update);
+
+  /// Record a keyframe (should be called right after BeginUpdate)
+  void WriteKeyframe(const State & state);
+
+  /// Flush every lane (in lane order) to the trace file
+  void EndUpdate();
+
+  /// Flush, write the keyframe index footer, and close the trace file
+  void Close();
+
+  /// Encode a keyframe
+  static void PutKeyframe(Buffer & buffer, const Header & header, const State & state);
+};
+
+/// Read (entire) trace into memory and replay it
+class EventTraceReader {
+public:
+  using Header = EventTrace::Header;
+  using State = EventTrace::State;
+  using Cursor = EventTrace::Cursor;
+
+  /// Decoded record (for event listings)
+  struct Record {
+    EventTrace::RecordType type;
+    size_t pos=0;
+    size_t a=0;             ///< cell (or resource for PULSE, update for UPDATE)
+    size_t b=0;             ///< resource/offspring cell/receiving cell
+    bool flag=false;        ///< success/sensor on
+    double amount=0.0;      ///< collected
+  };
+
+protected:
+  Header header;
+  emp::vector<uint8_t> data;
+  size_t records_begin=0;
+  size_t records_end=0;
+  bool complete=false;    ///< Was the trace closed cleanly? (if not, the last update's records may be cut short)
+  emp::vector<std::pair<size_t,size_t>> keyframe_index;
+
+  /// Decode a keyframe body into state
+  void GetKeyframe(Cursor & cursor, State & state) const;
+
+  /// Decode next record (cursor is positioned at record type). Keyframes are decoded into state.
+  /// Returns false at the end of the records; truncated or out-of-range records also fail the cursor.
+  bool NextRecord(Cursor & cursor, size_t & prev_pos, Record & record, State & state) const;
+
+  /// Apply a decoded record to state
+  void Apply(const Record & record, State & state) const;
+
+public:
+  /// Load a trace file. Returns false (with error message) on failure.
+  bool Load(const std::string & path, std::ostream & err=std::cerr);
+
+  const Header & GetHeader() const { return header; }
+  const emp::vector<std::pair<size_t,size_t>> & GetKeyframeIndex() const { return keyframe_index; }
+
+  /// Rebuild state at the beginning of the given update (i.e., after update-1 finished).
+  /// Resource levels are only known if update is a keyframe update (see State::has_resource_levels).
+  /// Returns false if the trace has no keyframe at or before update, the trace ends before
+  /// update, a record on the way is malformed, or need_resource_levels and they aren't known.
+  bool Seek(size_t update, State & state, bool need_resource_levels=false) const;
+
+  /// Collect every record from the given update. Returns false if the update
+  /// isn't in the trace or a record on the way is malformed.
+  bool GetUpdateRecords(size_t update, emp::vector<Record> & records) const;
+
+  /// Human-readable name of a record type
+  static std::string RecordName(EventTrace::RecordType type);
+};
+
+// =============================================================================
+//                          EventTrace member definitions
+// =============================================================================
+
+bool EventTrace::Open(const std::string & path) {
+  out.open(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) return false;
+  file_offset = 0;
+  keyframe_index.clear();
+  PutHeader(scratch, header);
+  Write(scratch);
+  return true;
+}
+
+void EventTrace::BeginUpdate(size_t update) {
+  update_offset = file_offset;
+  scratch.PutByte(RecordType::UPDATE);
+  scratch.PutVarint(update);
+  Write(scratch);
+}
+
+void EventTrace::WriteKeyframe(const State & state) {
+  emp_assert(state.resource_levels.size() == header.pop_size * header.num_resources);
+  keyframe_index.emplace_back(state.update, update_offset);
+  scratch.PutByte(RecordType::KEYFRAME);
+  PutKeyframe(scratch, header, state);
+  Write(scratch);
+}
+
+void EventTrace::EndUpdate() {
+  for (Lane & lane : lanes) {
+    if (!lane.GetBuffer().GetSize()) continue;
+    scratch.PutByte(RecordType::LANE);
+    Write(scratch);
+    Write(lane.GetBuffer());
+    lane.Clear();
+  }
+}
+
+void EventTrace::Close() {
+  if (!out.is_open()) return;
+  EndUpdate();
+  const size_t index_offset = file_offset;
+  scratch.PutByte(RecordType::INDEX);
+  scratch.PutVarint(keyframe_index.size());
+  for (const auto & entry : keyframe_index) {
+    scratch.PutVarint(entry.first);
+    scratch.PutVarint(entry.second);
+  }
+  for (size_t i = 0; i < 8; ++i) scratch.PutByte((uint8_t)((uint64_t)index_offset >> (8*i)));
+  for (size_t i = 0; i < MAGIC_SIZE; ++i) scratch.PutByte((uint8_t)MAGIC[i]);
+  Write(scratch);
+  out.close();
+}
+
+void EventTrace::PutKeyframe(Buffer & buffer, const Header & header, const State & state) {
+  buffer.PutVarint(state.update);
+  size_t num_occupied = 0;
+  for (const OrgState & org : state.orgs) num_occupied += (size_t)org.occupied;
+  buffer.PutVarint(num_occupied);
+  size_t prev_pos = 0;
+  for (size_t pos = 0; pos < state.orgs.size(); ++pos) {
+    const OrgState & org = state.orgs[pos];
+    if (!org.occupied) continue;
+    buffer.PutVarint(pos - prev_pos);
+    prev_pos = pos;
+    buffer.PutBits(org.active_cells);
+    buffer.PutBits(org.sensors);
+    for (size_t r = 0; r < header.num_resources; ++r) {
+      buffer.PutVarint(org.consumption_successes[r]);
+      buffer.PutVarint(org.consumption_failures[r]);
+    }
+    buffer.PutDouble(org.total_resources_collected);
+    for (size_t r = 0; r < header.num_resources; ++r) {
+      buffer.PutDouble(state.resource_levels[pos * header.num_resources + r]);
+    }
+  }
+}
+
+// =============================================================================
+//                       EventTraceReader member definitions
+// =============================================================================
+
+bool EventTraceReader::Load(const std::string & path, std::ostream & err) {
+  if (!ReadWholeFile(path, data)) { err << "Failed to read trace file (" << path << ")" << std::endl; return false; }
+  const size_t magic_size = EventTrace::MAGIC_SIZE;
+  if (data.size() < magic_size || std::memcmp(data.data(), EventTrace::MAGIC, magic_size) != 0) {
+    err << "Not a trace file (" << path << ")" << std::endl;
+    return false;
+  }
+  Cursor cursor{data.data(), data.size(), magic_size};
+  const uint64_t version = cursor.GetVarint();
+  if (version != EventTrace::VERSION) {
+    err << "Unsupported trace version (" << version << ")" << std::endl;
+    return false;
+  }
+  header.pop_size = cursor.GetVarint();
+  header.deme_width = cursor.GetVarint();
+  header.deme_height = cursor.GetVarint();
+  header.num_resources = cursor.GetVarint();
+  header.keyframe_interval = cursor.GetVarint();
+  records_begin = cursor.pos;
+  records_end = data.size();
+  complete = false;
+  keyframe_index.clear();
+  // Use the footer index if the trace was closed cleanly; otherwise, scan for keyframes.
+  const size_t footer_size = 8 + magic_size;
+  if (data.size() >= records_begin + footer_size
+      && std::memcmp(data.data() + data.size() - magic_size, EventTrace::MAGIC, magic_size) == 0) {
+    uint64_t index_offset = 0;
+    for (size_t i = 0; i < 8; ++i) index_offset |= (uint64_t)data[data.size() - footer_size + i] << (8*i);
+    Cursor index{data.data(), data.size() - footer_size, (size_t)index_offset};
+    if (index_offset >= records_begin && !index.AtEnd() && index.GetByte() == EventTrace::RecordType::INDEX) {
+      const size_t count = index.GetVarint();
+      for (size_t i = 0; i < count; ++i) {
+        const size_t update = index.GetVarint();
+        const size_t offset = index.GetVarint();
+        keyframe_index.emplace_back(update, offset);
+      }
+      records_end = (size_t)index_offset;
+      complete = true;
+      return true;
+    }
+  }
+  err << "Trace has no index (run didn't finish?); scanning for keyframes." << std::endl;
+  State state;
+  state.Reset(header);
+  Record record;
+  size_t prev_pos = 0;
+  size_t update_offset = records_begin;
+  size_t offset = cursor.pos;
+  while (!cursor.AtEnd()) {
+    offset = cursor.pos;
+    if (!NextRecord(cursor, prev_pos, record, state)) break;
+    if (record.type == EventTrace::RecordType::UPDATE) update_offset = offset;
+    if (record.type == EventTrace::RecordType::KEYFRAME) keyframe_index.emplace_back(state.update, update_offset);
+  }
+  // Drop a truncated (or malformed) last record
+  records_end = cursor.IsOK() ? cursor.pos : offset;
+  return true;
+}
+
+void EventTraceReader::GetKeyframe(Cursor & cursor, State & state) const {
+  state.Reset(header);
+  state.update = cursor.GetVarint();
+  const size_t num_occupied = cursor.GetVarint();
+  size_t pos = 0;
+  for (size_t i = 0; i < num_occupied; ++i) {
+    pos += cursor.GetVarint();
+    if (pos >= state.orgs.size()) { cursor.failed = true; return; }
+    EventTrace::OrgState & org = state.orgs[pos];
+    org.occupied = true;
+    cursor.GetBits(org.active_cells);
+    cursor.GetBits(org.sensors);
+    for (size_t r = 0; r < header.num_resources; ++r) {
+      org.consumption_successes[r] = cursor.GetVarint();
+      org.consumption_failures[r] = cursor.GetVarint();
+    }
+    org.total_resources_collected = cursor.GetDouble();
+    for (size_t r = 0; r < header.num_resources; ++r) {
+      state.resource_levels[pos * header.num_resources + r] = cursor.GetDouble();
+    }
+  }
+  state.has_resource_levels = true;
+}
+
+bool EventTraceReader::NextRecord(Cursor & cursor, size_t & prev_pos, Record & record, State & state) const {
+  if (cursor.pos >= records_end) return false;
+  record = Record();
+  record.type = (EventTrace::RecordType)cursor.GetByte();
+  auto get_pos = [&cursor, &prev_pos]() {
+    prev_pos = (size_t)((int64_t)prev_pos + cursor.GetZigzag());
+    return prev_pos;
+  };
+  const size_t num_cells = header.GetDemeCapacity();
+  const size_t num_res = header.num_resources;
+  bool in_range = true;   // Positions, cells & resources must fit the header (Apply indexes state with them)
+  switch (record.type) {
+    case EventTrace::RecordType::UPDATE:
+      record.a = cursor.GetVarint();
+      break;
+    case EventTrace::RecordType::LANE:
+      prev_pos = 0;
+      break;
+    case EventTrace::RecordType::PULSE:
+      record.pos = get_pos(); record.a = cursor.GetVarint();
+      in_range = record.pos < header.pop_size && record.a < num_res;
+      break;
+    case EventTrace::RecordType::METABOLIZE: {
+      record.pos = get_pos(); record.a = cursor.GetVarint();
+      const size_t res_success = cursor.GetVarint();
+      record.b = res_success >> 1; record.flag = res_success & 1;
+      if (record.flag) record.amount = cursor.GetDouble();
+      in_range = record.pos < header.pop_size && record.a < num_cells && record.b < num_res;
+      break;
+    }
+    case EventTrace::RecordType::DIVISION:
+    case EventTrace::RecordType::MESSAGE:
+      record.pos = get_pos(); record.a = cursor.GetVarint(); record.b = cursor.GetVarint();
+      in_range = record.pos < header.pop_size && record.a < num_cells && record.b < num_cells;
+      break;
+    case EventTrace::RecordType::SENSOR: {
+      record.pos = get_pos(); record.a = cursor.GetVarint();
+      const size_t res_on = cursor.GetVarint();
+      record.b = res_on >> 1; record.flag = res_on & 1;
+      in_range = record.pos < header.pop_size && record.a < num_cells && record.b < num_res;
+      break;
+    }
+    case EventTrace::RecordType::BIRTH:
+      record.pos = get_pos(); record.a = cursor.GetVarint();
+      in_range = record.pos < header.pop_size && record.a < num_cells;
+      break;
+    case EventTrace::RecordType::DEATH:
+      record.pos = get_pos();
+      in_range = record.pos < header.pop_size;
+      break;
+    case EventTrace::RecordType::KEYFRAME:
+      GetKeyframe(cursor, state);
+      break;
+    default:
+      // Unknown record (or INDEX) => stop reading.
+      return false;
+  }
+  if (!in_range) cursor.failed = true;
+  return cursor.IsOK();
+}
+
+void EventTraceReader::Apply(const Record & record, State & state) const {
+  const size_t num_res = header.num_resources;
+  switch (record.type) {
+    case EventTrace::RecordType::METABOLIZE: {
+      EventTrace::OrgState & org = state.orgs[record.pos];
+      if (record.flag) {
+        org.consumption_successes[record.b] += 1;
+        org.total_resources_collected += record.amount;
+      } else {
+        org.consumption_failures[record.b] += 1;
+      }
+      break;
+    }
+    case EventTrace::RecordType::DIVISION: {
+      // Offspring cell is (re)activated with fresh sensors
+      EventTrace::OrgState & org = state.orgs[record.pos];
+      org.active_cells[record.b] = true;
+      for (size_t r = 0; r < num_res; ++r) org.sensors[record.b * num_res + r] = false;
+      break;
+    }
+    case EventTrace::RecordType::SENSOR:
+      state.orgs[record.pos].sensors[record.a * num_res + record.b] = record.flag;
+      break;
+    case EventTrace::RecordType::BIRTH: {
+      EventTrace::OrgState & org = state.orgs[record.pos];
+      org.Reset(header);
+      org.occupied = true;
+      org.active_cells[record.a] = true;
+      break;
+    }
+    case EventTrace::RecordType::DEATH:
+      state.orgs[record.pos].Reset(header);
+      break;
+    default:
+      break;
+  }
+}
+
+bool EventTraceReader::Seek(size_t update, State & state, bool need_resource_levels) const {
+  // Find the last keyframe at or before update
+  size_t kf = keyframe_index.size();
+  for (size_t i = 0; i < keyframe_index.size(); ++i) {
+    if (keyframe_index[i].first > update) break;
+    kf = i;
+  }
+  if (kf == keyframe_index.size()) return false;
+  // Resource levels are only recorded in keyframes
+  if (need_resource_levels && keyframe_index[kf].first != update) return false;
+  Cursor cursor{data.data(), records_end, keyframe_index[kf].second};
+  Record record;
+  size_t prev_pos = 0;
+  bool loaded = false;
+  bool reached = false;     // Did we get to the beginning of the requested update?
+  size_t last_update = 0;   // Last update marker read
+  // Load the keyframe, then apply events until we reach the requested update
+  while (NextRecord(cursor, prev_pos, record, state)) {
+    if (record.type == EventTrace::RecordType::KEYFRAME) {
+      loaded = true;
+      if (state.update >= update) { reached = true; break; }
+    } else if (record.type == EventTrace::RecordType::UPDATE) {
+      last_update = record.a;
+      if (loaded && record.a >= update) { reached = true; break; }
+    } else if (loaded) {
+      Apply(record, state);
+    }
+  }
+  if (!cursor.IsOK()) return false;   // Malformed trace
+  // Records ran out: fine only if the trace ends right where update begins
+  // (i.e., its last update, which must be complete, was update-1)
+  if (!reached && !(loaded && complete && last_update + 1 == update)) return false;
+  emp_assert(loaded);
+  if (state.update != update) state.has_resource_levels = false;
+  state.update = update;
+  return loaded;
+}
+
+bool EventTraceReader::GetUpdateRecords(size_t update, emp::vector<Record> & records) const {
+  records.clear();
+  // Start from the last keyframe at or before update (records can only be found by scanning)
+  size_t begin = records_begin;
+  for (const auto & entry : keyframe_index) {
+    if (entry.first > update) break;
+    begin = entry.second;
+  }
+  Cursor cursor{data.data(), records_end, begin};
+  State scratch;
+  scratch.Reset(header);
+  Record record;
+  size_t prev_pos = 0;
+  bool in_update = false;
+  while (NextRecord(cursor, prev_pos, record, scratch)) {
+    if (record.type == EventTrace::RecordType::UPDATE) {
+      if (in_update) break;
+      in_update = (record.a == update);
+      continue;
+    }
+    if (!in_update || record.type == EventTrace::RecordType::LANE
+                   || record.type == EventTrace::RecordType::KEYFRAME) continue;
+    records.emplace_back(record);
+  }
+  return in_update && cursor.IsOK();
+}
+
+std::string EventTraceReader::RecordName(EventTrace::RecordType type) {
+  switch (type) {
+    case EventTrace::RecordType::UPDATE: return "UPDATE";
+    case EventTrace::RecordType::LANE: return "LANE";
+    case EventTrace::RecordType::PULSE: return "PULSE";
+    case EventTrace::RecordType::METABOLIZE: return "METABOLIZE";
+    case EventTrace::RecordType::DIVISION: return "DIVISION";
+    case EventTrace::RecordType::MESSAGE: return "MESSAGE";
+    case EventTrace::RecordType::SENSOR: return "SENSOR";
+    case EventTrace::RecordType::BIRTH: return "BIRTH";
+    case EventTrace::RecordType::DEATH: return "DEATH";
+    case EventTrace::RecordType::KEYFRAME: return "KEYFRAME";
+    case EventTrace::RecordType::INDEX: return "INDEX";
+  }
+  return "UNKNOWN";
+}
+
+#endif
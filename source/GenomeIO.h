@@ -0,0 +1,248 @@
+/**
+ *  @date 2019
+ *
+ *  @file  GenomeIO.h
+ *
+ *  Compact binary genome encoding & population files.
+ *
+ *  Genome encoding (all integers are LEB128 varints unless noted):
+ *    birth_tag                  raw little-endian 32-bit tag words
+ *    function count
+ *    per function: tag (raw words), instruction count,
+ *      per instruction: instruction index, args (zigzag), tag (raw words)
+ *
+ *  Instruction indices refer to the file's instruction name table (not to an
+ *  instruction library directly), so population files stay loadable when the
+ *  instruction set is reordered or extended.
+ *
+ *  Population file:
+ *    "DOLPOP\0\0" version tag_width
+ *    instruction name count, names (length-prefixed)
+ *    genome count
+ *    index: per genome (population position, byte offset into genome data)
+ *    genome data byte count, genome data
+ *
+ *  A population file is read into memory with one read and decoded from there.
+ */
+
+#ifndef _GENOME_IO_H
+#define _GENOME_IO_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "base/vector.h"
+#include "hardware/EventDrivenGP.h"
+
+#include "BinaryIO.h"
+#include "DOLWorldConfig.h"
+#include "DigitalOrganism.h"
+
+class GenomeIO {
+public:
+  using genome_t = DigitalOrganism::Genome;
+  using sgp_hardware_t = DigitalOrganism::sgp_hardware_t;
+  using program_t = DigitalOrganism::program_t;
+  using tag_t = DigitalOrganism::tag_t;
+  using inst_lib_t = typename sgp_hardware_t::inst_lib_t;
+  using function_t = typename sgp_hardware_t::Function;
+  using inst_t = typename sgp_hardware_t::inst_t;
+
+  static constexpr const char * MAGIC = "DOLPOP\0\0";
+  static constexpr size_t MAGIC_SIZE = 8;
+  static constexpr uint64_t VERSION = 1;
+  static constexpr size_t TAG_WIDTH = DOLWorldConstants::TAG_WIDTH;
+  static constexpr size_t TAG_WORDS = (TAG_WIDTH + 31) / 32;   ///< 32-bit words per tag
+
+  /// Population member (as stored in a population file)
+  struct PopulationEntry {
+    size_t position;
+    genome_t genome;
+  };
+
+  static void PutTag(BinaryBuffer & buffer, const tag_t & tag) {
+    for (size_t w = 0; w < TAG_WORDS; ++w) buffer.PutUInt32(tag.GetUInt(w));
+  }
+
+  static void GetTag(BinaryCursor & cursor, tag_t & tag) {
+    for (size_t w = 0; w < TAG_WORDS; ++w) tag.SetUInt(w, cursor.GetUInt32());
+  }
+
+  /// Encode genome. inst_index maps instruction library ids => file instruction indices.
+  static void EncodeGenome(BinaryBuffer & buffer, const genome_t & genome, const emp::vector<size_t> & inst_index);
+
+  /// Decode genome. inst_ids maps file instruction indices => instruction library ids.
+  /// Returns false (leaving genome in an unspecified state) if the encoding is malformed.
+  static bool DecodeGenome(BinaryCursor & cursor, genome_t & genome, const emp::vector<size_t> & inst_ids);
+
+  /// Accumulates genomes & writes them as a population file
+  class PopulationWriter {
+  protected:
+    const inst_lib_t & inst_lib;
+    emp::vector<size_t> inst_index;  ///< Identity mapping (file name table == instruction library)
+    emp::vector<std::pair<size_t,size_t>> index;
+    BinaryBuffer genome_data;
+
+  public:
+    PopulationWriter(const inst_lib_t & _inst_lib) : inst_lib(_inst_lib), inst_index(_inst_lib.GetSize()) {
+      for (size_t i = 0; i < inst_index.size(); ++i) inst_index[i] = i;
+    }
+
+    size_t GetSize() const { return index.size(); }
+
+    /// Add genome at the given population position
+    void Add(size_t position, const genome_t & genome) {
+      index.emplace_back(position, genome_data.GetSize());
+      EncodeGenome(genome_data, genome, inst_index);
+    }
+
+    /// Write population file. Returns false on failure.
+    bool Save(const std::string & path) const;
+  };
+
+  /// Reads a population file
+  class PopulationReader {
+  protected:
+    emp::vector<PopulationEntry> entries;
+
+  public:
+    /// Load population file (genomes are built against inst_lib). Returns false
+    /// (with an error message) on failure.
+    bool Load(const std::string & path, const inst_lib_t & inst_lib, std::ostream & err=std::cerr);
+
+    size_t GetSize() const { return entries.size(); }
+    const emp::vector<PopulationEntry> & GetEntries() const { return entries; }
+    emp::vector<PopulationEntry> & GetEntries() { return entries; }
+  };
+};
+
+void GenomeIO::EncodeGenome(BinaryBuffer & buffer, const genome_t & genome, const emp::vector<size_t> & inst_index) {
+  const program_t & program = genome.program;
+  PutTag(buffer, genome.birth_tag);
+  buffer.PutVarint(program.GetSize());
+  for (size_t fp = 0; fp < program.GetSize(); ++fp) {
+    const function_t & function = program[fp];
+    PutTag(buffer, function.affinity);
+    buffer.PutVarint(function.GetSize());
+    for (size_t ip = 0; ip < function.GetSize(); ++ip) {
+      const inst_t & inst = function[ip];
+      emp_assert(inst.id < inst_index.size());
+      buffer.PutVarint(inst_index[inst.id]);
+      for (size_t k = 0; k < sgp_hardware_t::MAX_INST_ARGS; ++k) buffer.PutZigzag(inst.args[k]);
+      PutTag(buffer, inst.affinity);
+    }
+  }
+}
+
+bool GenomeIO::DecodeGenome(BinaryCursor & cursor, genome_t & genome, const emp::vector<size_t> & inst_ids) {
+  program_t & program = genome.program;
+  program.Clear();
+  GetTag(cursor, genome.birth_tag);
+  const size_t num_functions = (size_t)cursor.GetVarint();
+  for (size_t fp = 0; fp < num_functions && cursor.IsOK(); ++fp) {
+    tag_t fun_tag;
+    GetTag(cursor, fun_tag);
+    program.PushFunction(function_t(fun_tag));
+    const size_t num_insts = (size_t)cursor.GetVarint();
+    for (size_t ip = 0; ip < num_insts && cursor.IsOK(); ++ip) {
+      const size_t index = (size_t)cursor.GetVarint();
+      if (index >= inst_ids.size()) return false;
+      int args[sgp_hardware_t::MAX_INST_ARGS];
+      for (size_t k = 0; k < sgp_hardware_t::MAX_INST_ARGS; ++k) args[k] = (int)cursor.GetZigzag();
+      tag_t inst_tag;
+      GetTag(cursor, inst_tag);
+      program.PushInst(inst_ids[index], args[0], args[1], args[2], inst_tag);
+    }
+  }
+  return cursor.IsOK();
+}
+
+bool GenomeIO::PopulationWriter::Save(const std::string & path) const {
+  BinaryBuffer header;
+  header.PutBytes(MAGIC, MAGIC_SIZE);
+  header.PutVarint(VERSION);
+  header.PutVarint(TAG_WIDTH);
+  header.PutVarint(inst_lib.GetSize());
+  for (size_t id = 0; id < inst_lib.GetSize(); ++id) header.PutString(inst_lib.GetName(id));
+  header.PutVarint(index.size());
+  for (const auto & entry : index) {
+    header.PutVarint(entry.first);
+    header.PutVarint(entry.second);
+  }
+  header.PutVarint(genome_data.GetSize());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) return false;
+  header.Write(out);
+  genome_data.Write(out);
+  return (bool)out;
+}
+
+bool GenomeIO::PopulationReader::Load(const std::string & path, const inst_lib_t & inst_lib, std::ostream & err) {
+  entries.clear();
+  emp::vector<uint8_t> data;
+  if (!ReadWholeFile(path, data)) {
+    err << "Failed to read population file (" << path << ")." << std::endl;
+    return false;
+  }
+  BinaryCursor cursor{data.data(), data.size(), 0};
+  const uint8_t * magic = cursor.GetBytes(MAGIC_SIZE);
+  if (magic == nullptr || std::memcmp(magic, MAGIC, MAGIC_SIZE) != 0) {
+    err << "Not a population file (" << path << ")." << std::endl;
+    return false;
+  }
+  const uint64_t version = cursor.GetVarint();
+  if (version != VERSION) {
+    err << "Unsupported population file version (" << version << ")." << std::endl;
+    return false;
+  }
+  const uint64_t tag_width = cursor.GetVarint();
+  if (tag_width != TAG_WIDTH) {
+    err << "Population file tag width (" << tag_width << ") does not match TAG_WIDTH (" << TAG_WIDTH << ")." << std::endl;
+    return false;
+  }
+  // Map file instruction names onto the instruction library
+  const size_t num_insts = (size_t)cursor.GetVarint();
+  emp::vector<size_t> inst_ids;
+  for (size_t i = 0; i < num_insts && cursor.IsOK(); ++i) {
+    const std::string name = cursor.GetString();
+    if (!cursor.IsOK()) break;
+    bool found = false;
+    for (size_t id = 0; id < inst_lib.GetSize() && !found; ++id) {
+      if (inst_lib.GetName(id) == name) { inst_ids.emplace_back(id); found = true; }
+    }
+    if (!found) {
+      err << "Population file uses an instruction (" << name << ") that is not in the instruction set." << std::endl;
+      return false;
+    }
+  }
+  // Read the index
+  const size_t num_genomes = (size_t)cursor.GetVarint();
+  emp::vector<std::pair<size_t,size_t>> index;
+  for (size_t i = 0; i < num_genomes && cursor.IsOK(); ++i) {
+    const size_t position = (size_t)cursor.GetVarint();
+    const size_t offset = (size_t)cursor.GetVarint();
+    index.emplace_back(position, offset);
+  }
+  const size_t data_size = (size_t)cursor.GetVarint();
+  const uint8_t * genome_data = cursor.GetBytes(data_size);
+  if (!cursor.IsOK() || genome_data == nullptr) {
+    err << "Population file (" << path << ") is truncated." << std::endl;
+    return false;
+  }
+  // Decode genomes
+  entries.reserve(index.size());
+  for (size_t i = 0; i < index.size(); ++i) {
+    BinaryCursor genome_cursor{genome_data, data_size, index[i].second};
+    entries.push_back({index[i].first, genome_t(program_t(&inst_lib))});
+    if (index[i].second >= data_size || !DecodeGenome(genome_cursor, entries.back().genome, inst_ids)) {
+      err << "Population file (" << path << ") has a malformed genome (entry " << i << ")." << std::endl;
+      entries.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ *  @date 2019
+ *
+ *  @file  GenomeTextParser.h
+ *
+ *  Streaming parser for text genome (.gp) files. A file holds any number of
+ *  genome records; each record is a BIRTH line followed by a SignalGP program:
+ *
+ *    BIRTH-[0000000000000000]
+ *    Fn-0000000000000000:
+ *      Inc(0,0,0)
+ *      Nop[0000000000000000](0,0,0)
+ *      Express-0
+ *    BIRTH-[1000000000000000]
+ *    ...
+ *
+ *  Tags are written most-significant bit first; missing instruction tags/arguments
+ *  default to zero. The whole file is read with a single read and tokenized in
+ *  place (no per-line string allocations). Parse errors are reported with the
+ *  offending line number rather than aborting.
+ */
+
+#ifndef _GENOME_TEXT_PARSER_H
+#define _GENOME_TEXT_PARSER_H
+
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "base/vector.h"
+#include "hardware/EventDrivenGP.h"
+
+#include "BinaryIO.h"
+#include "DigitalOrganism.h"
+
+class GenomeTextParser {
+public:
+  using genome_t = DigitalOrganism::Genome;
+  using sgp_hardware_t = DigitalOrganism::sgp_hardware_t;
+  using program_t = DigitalOrganism::program_t;
+  using tag_t = DigitalOrganism::tag_t;
+  using inst_lib_t = typename sgp_hardware_t::inst_lib_t;
+  using function_t = typename sgp_hardware_t::Function;
+
+  /// Description of the first parse error encountered
+  struct Error {
+    size_t line=0;          ///< 1-indexed line number (0 if the error isn't tied to a line)
+    std::string message;
+  };
+
+protected:
+  const inst_lib_t & inst_lib;
+  emp::vector<std::string> inst_names;                     ///< Owned copies of instruction names
+  std::unordered_map<std::string_view, size_t> inst_ids;   ///< Views into inst_names => instruction ids
+  Error error;
+
+  static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; }
+
+  static void SkipSpace(std::string_view & str) {
+    size_t i = 0;
+    while (i < str.size() && IsSpace(str[i])) ++i;
+    str.remove_prefix(i);
+  }
+
+  static bool StartsWithNoCase(std::string_view str, std::string_view prefix) {
+    if (str.size() < prefix.size()) return false;
+    for (size_t i = 0; i < prefix.size(); ++i) {
+      if (std::tolower((unsigned char)str[i]) != prefix[i]) return false;
+    }
+    return true;
+  }
+
+  bool Fail(size_t line, const std::string & message) {
+    error.line = line;
+    error.message = message;
+    return false;
+  }
+
+  /// Parse tag bits (most-significant first) from the front of str. Bits beyond
+  /// the tag width are ignored.
+  static void ParseTagBits(std::string_view & str, tag_t & tag) {
+    size_t i = 0;
+    for (; i < str.size() && (str[i] == '0' || str[i] == '1'); ++i) {
+      if (i < tag.GetSize() && str[i] == '1') tag.Set(tag.GetSize() - i - 1, true);
+    }
+    str.remove_prefix(i);
+  }
+
+  /// Parse a bracketed tag ("[0101...]") from the front of str.
+  bool ParseBracketTag(std::string_view & str, tag_t & tag, size_t line) {
+    str.remove_prefix(1); // '['
+    SkipSpace(str);
+    ParseTagBits(str, tag);
+    SkipSpace(str);
+    if (str.empty() || str[0] != ']') return Fail(line, "Expected ']' to close tag.");
+    str.remove_prefix(1);
+    return true;
+  }
+
+  bool ParseBirth(std::string_view str, tag_t & birth_tag, size_t line);
+  bool ParseFunction(std::string_view str, program_t & program, size_t line);
+  bool ParseInst(std::string_view str, program_t & program, size_t line);
+
+public:
+  /// The instruction library must outlive the parser.
+  GenomeTextParser(const inst_lib_t & _inst_lib) : inst_lib(_inst_lib) {
+    inst_names.reserve(inst_lib.GetSize());
+    for (size_t id = 0; id < inst_lib.GetSize(); ++id) inst_names.emplace_back(inst_lib.GetName(id));
+    for (size_t id = 0; id < inst_names.size(); ++id) inst_ids.emplace(std::string_view(inst_names[id]), id);
+  }
+
+  const Error & GetError() const { return error; }
+
+  /// Parse every genome record in text, appending genomes. On failure, returns
+  /// false, leaves genomes unchanged, and records the error (see GetError).
+  bool Parse(std::string_view text, emp::vector<genome_t> & genomes);
+
+  /// Parse every genome record in the file at path (see Parse).
+  bool ParseFile(const std::string & path, emp::vector<genome_t> & genomes) {
+    emp::vector<uint8_t> data;
+    if (!ReadWholeFile(path, data)) return Fail(0, "Failed to read genome file (" + path + ").");
+    return Parse(std::string_view((const char *)data.data(), data.size()), genomes);
+  }
+};
+
+bool GenomeTextParser::Parse(std::string_view text, emp::vector<genome_t> & genomes) {
+  const size_t start_size = genomes.size();
+  error = Error();
+  size_t line_num = 0;
+  bool ok = true;
+  while (ok && !text.empty()) {
+    ++line_num;
+    const size_t line_end = text.find('\n');
+    std::string_view line = text.substr(0, line_end);
+    text.remove_prefix((line_end == std::string_view::npos) ? text.size() : line_end + 1);
+    SkipSpace(line);
+    if (line.empty()) continue;
+    if (StartsWithNoCase(line, "birth")) {
+      genomes.emplace_back(program_t(&inst_lib));
+      ok = ParseBirth(line.substr(5), genomes.back().birth_tag, line_num);
+    } else if (genomes.size() == start_size) {
+      ok = Fail(line_num, "Expected a BIRTH line before the first program.");
+    } else if (StartsWithNoCase(line, "fn-")) {
+      ok = ParseFunction(line.substr(3), genomes.back().program, line_num);
+    } else {
+      ok = ParseInst(line, genomes.back().program, line_num);
+    }
+  }
+  if (!ok) {
+    while (genomes.size() > start_size) genomes.pop_back();
+  }
+  return ok;
+}
+
+/// BIRTH[-][tag]
+bool GenomeTextParser::ParseBirth(std::string_view str, tag_t & birth_tag, size_t line) {
+  SkipSpace(str);
+  if (!str.empty() && str[0] == '-') str.remove_prefix(1);
+  SkipSpace(str);
+  if (!str.empty() && str[0] == '[' && !ParseBracketTag(str, birth_tag, line)) return false;
+  SkipSpace(str);
+  if (!str.empty()) return Fail(line, "Unexpected characters after BIRTH tag.");
+  return true;
+}
+
+/// Fn-<tag>:
+bool GenomeTextParser::ParseFunction(std::string_view str, program_t & program, size_t line) {
+  tag_t fun_tag;
+  SkipSpace(str);
+  ParseTagBits(str, fun_tag);
+  SkipSpace(str);
+  if (!str.empty() && str[0] == ':') str.remove_prefix(1);
+  SkipSpace(str);
+  if (!str.empty()) return Fail(line, "Malformed function definition.");
+  program.PushFunction(function_t(fun_tag));
+  return true;
+}
+
+/// Name[tag](arg, arg, arg) - tag & arguments are optional
+bool GenomeTextParser::ParseInst(std::string_view str, program_t & program, size_t line) {
+  if (program.GetSize() == 0) return Fail(line, "Instruction outside of a function.");
+  size_t name_len = 0;
+  while (name_len < str.size() && str[name_len] != '[' && str[name_len] != '(' && !IsSpace(str[name_len])) ++name_len;
+  const std::string_view name = str.substr(0, name_len);
+  const auto id_it = inst_ids.find(name);
+  if (id_it == inst_ids.end()) return Fail(line, "Unknown instruction (" + std::string(name) + ").");
+  str.remove_prefix(name_len);
+  SkipSpace(str);
+  // Tag
+  tag_t inst_tag;
+  if (!str.empty() && str[0] == '[' && !ParseBracketTag(str, inst_tag, line)) return false;
+  SkipSpace(str);
+  // Arguments
+  int args[sgp_hardware_t::MAX_INST_ARGS] = {};
+  if (!str.empty() && str[0] == '(') {
+    str.remove_prefix(1);
+    SkipSpace(str);
+    size_t arg_cnt = 0;
+    while (!str.empty() && str[0] != ')') {
+      if (arg_cnt >= sgp_hardware_t::MAX_INST_ARGS) return Fail(line, "Too many instruction arguments.");
+      if (str[0] == '+') str.remove_prefix(1);
+      const auto result = std::from_chars(str.data(), str.data() + str.size(), args[arg_cnt]);
+      if (result.ec != std::errc()) return Fail(line, "Malformed instruction argument.");
+      str.remove_prefix((size_t)(result.ptr - str.data()));
+      ++arg_cnt;
+      SkipSpace(str);
+      if (!str.empty() && str[0] == ',') {
+        str.remove_prefix(1);
+        SkipSpace(str);
+      } else if (str.empty() || str[0] != ')') {
+        return Fail(line, "Expected ',' or ')' in instruction arguments.");
+      }
+    }
+    if (str.empty()) return Fail(line, "Expected ')' to close instruction arguments.");
+    str.remove_prefix(1);
+    SkipSpace(str);
+  }
+  if (!str.empty()) return Fail(line, "Unexpected characters after instruction.");
+  program.PushInst(id_it->second, args[0], args[1], args[2], inst_tag);
+  return true;
+}
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ *  @date 2019
+ *
+ *  @file  GenotypeStore.h
+ *
+ *  Hash-consed genotypes. Most births at our mutation rates copy the parent
+ *  exactly, so rather than each organism owning a copy of its genome, organisms
+ *  hold a Handle to a shared genotype:
+ *  - Copying a handle (e.g., giving an un-mutated offspring its parent's
+ *    genotype) is O(1).
+ *  - A GenotypeStore interns genomes by content hash: interning a genome equal
+ *    to one already in the store returns a handle to the existing genotype.
+ *  - Every genotype counts the handles to it, so genotype abundances are
+ *    available without scanning the population. A genotype leaves its store
+ *    when its last handle goes away.
+ *
+ *  Hashes come from a digest of the genome (HASHER::Digest), kept with each
+ *  interned genotype. Whoever builds a new genome from an interned one can
+ *  often update the old digest much faster than digesting from scratch (e.g.,
+ *  mutation; see Mutator.h); digests handed over with a standalone genotype are
+ *  used as-is.
+ *
+ *  A store can also keep data derived from each genome (e.g., a decoded
+ *  program) with its genotype: it's computed once, when the genotype is
+ *  interned (see SetDeriveFun), and shared read-only by every handle.
+ *
+ *  Genomes can also live outside any store (standalone), e.g., a freshly
+ *  mutated genome that hasn't been placed in the population yet. Interning a
+ *  standalone genotype that isn't already in the store moves it into the store
+ *  (no copy), so every handle to it becomes a handle to the interned genotype.
+ *
+ *  Handles may be copied & destroyed from several threads at once (counts are
+ *  atomic), as long as no thread drops the last handle to an interned
+ *  genotype while another thread is using the store. Interning & everything
+ *  else that touches the store itself is single-threaded.
+ */
+
+#ifndef _GENOTYPE_STORE_H
+#define _GENOTYPE_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "base/Ptr.h"
+#include "base/assert.h"
+
+/// Mix value into a running hash
+inline size_t CombineHash(size_t seed, size_t value) {
+  uint64_t x = (uint64_t)seed ^ ((uint64_t)value + 0x9e3779b97f4a7c15ULL + ((uint64_t)seed << 6) + ((uint64_t)seed >> 2));
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return (size_t)x;
+}
+
+/// Derived data for stores that don't keep any
+struct NoDerivedData { };
+
+/// GENOME must be copyable & equality comparable. HASHER must provide:
+/// - digest_t (default constructible)
+/// - static void Digest(const GENOME &, digest_t &)
+/// - static size_t GetHash(const digest_t &)
+/// DERIVED (default constructible) is kept with every genotype (see SetDeriveFun).
+template<typename GENOME, typename HASHER, typename DERIVED=NoDerivedData>
+class GenotypeStore {
+public:
+  using genome_t = GENOME;
+  using digest_t = typename HASHER::digest_t;
+  using derived_t = DERIVED;
+  using derive_fun_t = std::function<void(const genome_t &, derived_t &)>;
+  class Handle;
+
+protected:
+  /// One distinct genome (shared by every handle to it)
+  struct Genotype {
+    genome_t genome;
+    digest_t digest;                        ///< (valid if has_digest; always valid once interned)
+    bool has_digest=false;
+    derived_t derived;                      ///< Computed from genome when interned (if the store has a derive function)
+    emp::Ptr<GenotypeStore> store=nullptr;  ///< Store this genotype is interned in (nullptr if standalone)
+    std::atomic<size_t> num_handles{0};
+
+    Genotype(const genome_t & _genome) : genome(_genome) { }
+    Genotype(genome_t && _genome) : genome(std::move(_genome)) { }
+    Genotype(genome_t && _genome, digest_t && _digest)
+      : genome(std::move(_genome)), digest(std::move(_digest)), has_digest(true) { }
+
+    size_t GetHash() const { return HASHER::GetHash(digest); }
+  };
+
+  std::unordered_multimap<size_t, emp::Ptr<Genotype>> genotypes;   ///< Content hash => genotype
+  derive_fun_t fun_derive;                                         ///< Computes derived data for newly interned genotypes
+
+  /// Last handle to an interned genotype went away
+  void Remove(emp::Ptr<Genotype> genotype) {
+    auto range = genotypes.equal_range(genotype->GetHash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == genotype) {
+        genotypes.erase(it);
+        break;
+      }
+    }
+    genotype.Delete();
+  }
+
+public:
+  /// Reference-counted handle to a genotype (null by default)
+  class Handle {
+  protected:
+    friend class GenotypeStore;
+    emp::Ptr<Genotype> genotype=nullptr;
+
+    explicit Handle(emp::Ptr<Genotype> _genotype) : genotype(_genotype) { Acquire(); }
+
+    void Acquire() {
+      if (genotype) genotype->num_handles.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release() {
+      if (!genotype) return;
+      if (genotype->num_handles.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (genotype->store) genotype->store->Remove(genotype);
+        else genotype.Delete();
+      }
+      genotype = nullptr;
+    }
+
+  public:
+    Handle() { }
+    Handle(const Handle & in) : genotype(in.genotype) { Acquire(); }
+    Handle(Handle && in) : genotype(in.genotype) { in.genotype = nullptr; }
+    ~Handle() { Release(); }
+
+    Handle & operator=(const Handle & in) {
+      if (genotype != in.genotype) {
+        Release();
+        genotype = in.genotype;
+        Acquire();
+      }
+      return *this;
+    }
+
+    Handle & operator=(Handle && in) {
+      if (this != &in) {
+        Release();
+        genotype = in.genotype;
+        in.genotype = nullptr;
+      }
+      return *this;
+    }
+
+    bool IsNull() const { return genotype == nullptr; }
+
+    /// Is this genotype interned in a store?
+    bool IsInterned() const { emp_assert(genotype); return genotype->store != nullptr; }
+
+    const genome_t & GetGenome() const { emp_assert(genotype); return genotype->genome; }
+    const genome_t & operator*() const { return GetGenome(); }
+    const genome_t * operator->() const { return &GetGenome(); }
+
+    /// Number of handles to this genotype (i.e., how many organisms share it)
+    size_t GetAbundance() const { emp_assert(genotype); return genotype->num_handles.load(std::memory_order_relaxed); }
+
+    /// Does this genotype know its digest? (interned genotypes always do)
+    bool HasDigest() const { emp_assert(genotype); return genotype->has_digest; }
+    const digest_t & GetDigest() const { emp_assert(genotype && genotype->has_digest); return genotype->digest; }
+
+    /// Data derived from the genome when it was interned (see SetDeriveFun)
+    const derived_t & GetDerived() const { emp_assert(genotype && genotype->store); return genotype->derived; }
+
+    /// Content hash (only if HasDigest)
+    size_t GetHash() const { emp_assert(genotype && genotype->has_digest); return genotype->GetHash(); }
+
+    /// Do both handles refer to the same genotype?
+    bool operator==(const Handle & in) const { return genotype == in.genotype; }
+    bool operator!=(const Handle & in) const { return genotype != in.genotype; }
+  };
+
+  GenotypeStore() { }
+  GenotypeStore(const GenotypeStore &) = delete;
+  GenotypeStore & operator=(const GenotypeStore &) = delete;
+
+  /// Genotypes that still have handles outlive the store (as standalone genotypes)
+  ~GenotypeStore() {
+    for (auto & entry : genotypes) entry.second->store = nullptr;
+  }
+
+  /// Wrap genome in a standalone genotype (see Intern)
+  static Handle NewStandalone(const genome_t & genome) { return Handle(emp::NewPtr<Genotype>(genome)); }
+  static Handle NewStandalone(genome_t && genome) { return Handle(emp::NewPtr<Genotype>(std::move(genome))); }
+
+  /// Wrap genome in a standalone genotype, along with its (already computed) digest
+  static Handle NewStandalone(genome_t && genome, digest_t && digest) {
+    return Handle(emp::NewPtr<Genotype>(std::move(genome), std::move(digest)));
+  }
+
+  /// Compute each genotype's derived data with fun(genome, derived) when it's
+  /// interned. Genotypes already in the store are derived again.
+  void SetDeriveFun(const derive_fun_t & fun) {
+    fun_derive = fun;
+    if (!fun_derive) return;
+    for (auto & entry : genotypes) fun_derive(entry.second->genome, entry.second->derived);
+  }
+
+  /// Number of distinct genotypes in the store
+  size_t GetNumGenotypes() const { return genotypes.size(); }
+
+  /// Get the interned version of a genotype: handles to this store's genotypes
+  /// are returned as-is; otherwise, an equal genotype already in the store if
+  /// there is one, or else this genotype (moved into the store).
+  Handle Intern(const Handle & handle) {
+    emp_assert(!handle.IsNull());
+    emp::Ptr<Genotype> genotype = handle.genotype;
+    if (genotype->store == this) return handle;
+    if (!genotype->has_digest) {
+      HASHER::Digest(genotype->genome, genotype->digest);
+      genotype->has_digest = true;
+    }
+    const size_t hash = genotype->GetHash();
+    auto range = genotypes.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second->genome == genotype->genome) return Handle(it->second);
+    }
+    if (genotype->store != nullptr) { // Interned elsewhere; copy
+      genotype = emp::NewPtr<Genotype>(genome_t(genotype->genome), digest_t(genotype->digest));
+    }
+    if (fun_derive) fun_derive(genotype->genome, genotype->derived);
+    genotype->store = this;
+    genotypes.emplace(hash, genotype);
+    return Handle(genotype);
+  }
+
+  Handle Intern(const genome_t & genome) { return Intern(NewStandalone(genome)); }
+
+  /// Call fun(genome, abundance) for every genotype in the store (in no particular order)
+  template<typename FUN>
+  void ForEachGenotype(FUN && fun) const {
+    for (const auto & entry : genotypes) {
+      fun((const genome_t &)entry.second->genome, entry.second->num_handles.load(std::memory_order_relaxed));
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ *  @date 2019
+ *
+ *  @file  MemoryUsage.h
+ *
+ *  Memory accounting. MemoryUsage breaks the bytes held by a deme (or the whole
+ *  population) down by component; the helpers here estimate the footprint of
+ *  the containers those components are built from.
+ *
+ *  Estimates count container capacity (not just size) plus the size of each
+ *  object itself, and model hash-map nodes as (next pointer + key/value pair).
+ *  Allocator overhead is not included, so numbers are a (close) lower bound on
+ *  what the allocator actually hands out; they're meant for spotting which
+ *  component grows, not for exact byte counts.
+ */
+
+#ifndef _MEMORY_USAGE_H
+#define _MEMORY_USAGE_H
+
+#include <iostream>
+#include <unordered_map>
+
+#include "base/vector.h"
+#include "hardware/EventDrivenGP.h"
+#include "tools/string_utils.h"
+
+#include "DOLWorldConfig.h"
+
+/// Bytes used, by component
+struct MemoryUsage {
+  size_t genomes=0;          ///< Organism genotypes (each split evenly between the organisms sharing it)
+  size_t phenotypes=0;       ///< Organism phenotypes (per-resource tallies)
+  size_t environments=0;     ///< Local (per-deme) environments
+  size_t cell_programs=0;    ///< Program copies loaded onto cell hardware
+  size_t sgp_cores=0;        ///< SignalGP cores (call stacks of execution states)
+  size_t sgp_memory=0;       ///< SignalGP memory maps (shared + per-call local/input/output)
+  size_t event_queues=0;     ///< Events waiting in SignalGP event queues
+  size_t neighbor_tables=0;  ///< Deme neighbor lookup tables (shared by all demes; population totals only)
+  size_t cell_state=0;       ///< Remaining cell state (cell objects, sensors, schedules, decoded programs)
+  size_t deme_pool=0;        ///< Idle (recycled) deme hardware, all components (population totals only)
+  size_t birth_chamber=0;    ///< Birth chamber (population totals only)
+
+  static constexpr size_t NUM_COMPONENTS = 11;
+
+  /// Component names (in the order of GetComponent)
+  static const char * GetComponentName(size_t i) {
+    static constexpr const char * names[NUM_COMPONENTS] = {
+      "genomes", "phenotypes", "environments", "cell_programs", "sgp_cores",
+      "sgp_memory", "event_queues", "neighbor_tables", "cell_state", "deme_pool",
+      "birth_chamber"
+    };
+    return names[i];
+  }
+
+  size_t GetComponent(size_t i) const {
+    const size_t values[NUM_COMPONENTS] = {
+      genomes, phenotypes, environments, cell_programs, sgp_cores, sgp_memory,
+      event_queues, neighbor_tables, cell_state, deme_pool, birth_chamber
+    };
+    return values[i];
+  }
+
+  size_t GetTotal() const {
+    size_t total = 0;
+    for (size_t i = 0; i < NUM_COMPONENTS; ++i) total += GetComponent(i);
+    return total;
+  }
+
+  void Clear() { *this = MemoryUsage(); }
+
+  MemoryUsage & operator+=(const MemoryUsage & other) {
+    genomes += other.genomes;
+    phenotypes += other.phenotypes;
+    environments += other.environments;
+    cell_programs += other.cell_programs;
+    sgp_cores += other.sgp_cores;
+    sgp_memory += other.sgp_memory;
+    event_queues += other.event_queues;
+    neighbor_tables += other.neighbor_tables;
+    cell_state += other.cell_state;
+    deme_pool += other.deme_pool;
+    birth_chamber += other.birth_chamber;
+    return *this;
+  }
+};
+
+/// Memory usage of every deme (by population position) + population totals
+struct MemoryReport {
+  size_t update=0;
+  emp::vector<MemoryUsage> demes;   ///< Per population position (zeros for empty positions)
+  MemoryUsage totals;               ///< Sum over demes + population-level components
+
+  /// Write the CSV header (see WriteCSV)
+  static void WriteCSVHeader(std::ostream & os) {
+    os << "update,deme";
+    for (size_t i = 0; i < MemoryUsage::NUM_COMPONENTS; ++i) os << "," << MemoryUsage::GetComponentName(i);
+    os << ",total\n";
+  }
+
+  /// Write population totals (deme = "all") and, if per_deme, one row per
+  /// non-empty population position
+  void WriteCSV(std::ostream & os, bool per_deme) const {
+    WriteCSVRow(os, "all", totals);
+    if (!per_deme) return;
+    for (size_t pos = 0; pos < demes.size(); ++pos) {
+      if (demes[pos].GetTotal() == 0) continue;
+      WriteCSVRow(os, emp::to_string(pos), demes[pos]);
+    }
+  }
+
+protected:
+  void WriteCSVRow(std::ostream & os, const std::string & deme, const MemoryUsage & usage) const {
+    os << update << "," << deme;
+    for (size_t i = 0; i < MemoryUsage::NUM_COMPONENTS; ++i) os << "," << usage.GetComponent(i);
+    os << "," << usage.GetTotal() << "\n";
+  }
+};
+
+/// Footprint estimates for the containers components are built from
+namespace MemoryAccounting {
+  using sgp_hardware_t = emp::EventDrivenGP_AW<DOLWorldConstants::TAG_WIDTH>;
+  using program_t = typename sgp_hardware_t::Program;
+  using memory_t = typename sgp_hardware_t::memory_t;
+  using event_t = typename sgp_hardware_t::event_t;
+
+  /// Heap bytes held by a vector
+  template<typename T>
+  size_t VectorBytes(const emp::vector<T> & vec) { return vec.capacity() * sizeof(T); }
+
+  /// Heap bytes held by a (bit-packed) bool vector
+  inline size_t VectorBytes(const emp::vector<bool> & vec) { return (vec.capacity() + 7) / 8; }
+
+  /// Heap bytes held by a hash map (bucket array + one node per entry)
+  template<typename K, typename V>
+  size_t HashMapBytes(const std::unordered_map<K,V> & map) {
+    return map.bucket_count() * sizeof(void *) + map.size() * (sizeof(void *) + sizeof(std::pair<const K, V>));
+  }
+
+  /// Heap bytes held by a SignalGP program (function table + instruction sequences)
+  inline size_t ProgramBytes(const program_t & program) {
+    size_t bytes = program.GetSize() * sizeof(typename sgp_hardware_t::Function);
+    for (size_t fp = 0; fp < program.GetSize(); ++fp) bytes += VectorBytes(program[fp].inst_seq);
+    return bytes;
+  }
+
+  /// Bytes held by a queued event (event object + message memory)
+  inline size_t EventBytes(const event_t & event) { return sizeof(event_t) + HashMapBytes(event.msg); }
+
+  /// Add the heap bytes held by SignalGP hardware's cores (call stacks) & memory
+  /// maps to usage. The hardware object itself & its program are not included.
+  inline void AddHardwareBytes(sgp_hardware_t & hw, MemoryUsage & usage) {
+    usage.sgp_memory += HashMapBytes(hw.GetShared());
+    auto & cores = hw.GetCores();
+    usage.sgp_cores += VectorBytes(cores);
+    for (auto & core : cores) {
+      usage.sgp_cores += VectorBytes(core);
+      for (auto & state : core) {
+        usage.sgp_memory += HashMapBytes(state.GetLocalMemory())
+                          + HashMapBytes(state.GetInputMemory())
+                          + HashMapBytes(state.GetOutputMemory());
+      }
+    }
+  }
+}
+
+#endif
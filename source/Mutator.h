@@ -1,23 +1,354 @@
+/**
+ *  @date 2019
+ *
+ *  @file  Mutator.h
+ *
+ *  Mutates DigitalOrganism genomes. MUTATION_ENGINE picks how:
+ *  - signalgp:   Empirical's SignalGPMutator operators, drawn per site, plus
+ *                birth tag bit flips.
+ *  - per-site:   Mutator's own operators (below), one random draw per site.
+ *  - skip-ahead: the same operators, but instead of drawing for every site, draw
+ *                the number of sites to skip until the next mutated one.
+ *
+ *  At per-site rates around 0.0025, per-site sampling spends thousands of
+ *  draws to produce about one mutation. Each operator treats its sites as one
+ *  flattened sequence (e.g., every tag bit of every instruction, in program
+ *  order), in which sites mutate independently with probability p. The gap
+ *  before the next mutated site is geometric (P(gap = k) = (1-p)^k p), so
+ *  drawing gaps mutates exactly the same distribution of sites as drawing
+ *  every site. Size constraints are checked at each mutated site, in the same
+ *  order, so they hold exactly as they do for per-site sampling.
+ *
+ *  Mutator's operators mirror SignalGPMutator's defaults, applied in the same
+ *  order: function duplication, function deletion, function tag bit flips,
+ *  slip mutations, substitutions (instruction tag bits, operations, and
+ *  arguments), then instruction insertions/deletions. Where SignalGPMutator's
+ *  choices shape the result, the operators make the same ones (e.g., duplicates
+ *  can themselves be duplicated, a deleted function is replaced by the last
+ *  function, and inserted instructions go before positions drawn with
+ *  replacement), so 'per-site' and 'signalgp' mutate the same distribution of
+ *  genomes (see the Mutator tests).
+ *
+ *  Mutating an organism is copy-on-write: organisms share genotypes (see
+ *  GenotypeStore.h), so the operators read the shared genome and only copy it
+ *  when they first change something. An organism that draws no mutations keeps
+ *  its genotype untouched (no copy, no hashing). The signalgp engine can't
+ *  look before it edits, so it always works on a copy (discarded if nothing
+ *  mutated).
+ *
+ *  Mutate returns a MutationDelta describing what changed (which functions were
+ *  added or removed, retagged, resized, and which instructions were
+ *  substituted), so genome digests (see GenomeDigest) and validity checks can
+ *  be updated in time proportional to the change rather than to genome length.
+ *  Mutating an organism updates its parent's digest this way. The signalgp
+ *  engine doesn't report what it changed, so its deltas mark the whole program
+ *  as changed.
+ *
+ *  Mutate only reads the mutator's configuration, so one mutator can be used
+ *  from several threads at once.
+ */
+
 #ifndef _DIGITAL_ORGANISM_MUTATOR_H
 #define _DIGITAL_ORGANISM_MUTATOR_H
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "base/vector.h"
 #include "hardware/EventDrivenGP.h"
 #include "hardware/signalgp_utils.h"
+#include "tools/Random.h"
 
 #include "DOLWorldConfig.h"
+#include "DigitalOrganism.h"
+
+/// How Mutator samples mutation sites (MUTATION_ENGINE; see above)
+enum class MutationEngine { SIGNALGP, PER_SITE, SKIP_AHEAD };
+
+/// Parse a MUTATION_ENGINE string. Returns false if engine_str isn't a known engine.
+bool ParseMutationEngine(const std::string & engine_str, MutationEngine & engine) {
+  if (engine_str == "signalgp") engine = MutationEngine::SIGNALGP;
+  else if (engine_str == "per-site") engine = MutationEngine::PER_SITE;
+  else if (engine_str == "skip-ahead") engine = MutationEngine::SKIP_AHEAD;
+  else return false;
+  return true;
+}
+
+/// Walks a sequence of sites that each mutate with probability p, drawing once per site.
+class PerSiteSampler {
+protected:
+  double p;
+
+public:
+  PerSiteSampler(double _p) : p(_p) { }
+
+  /// Visit the next n sites, stopping at the first mutated one. Returns its
+  /// offset, or n if none of the n sites mutate.
+  size_t NextHit(emp::Random & rnd, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      if (rnd.P(p)) return i;
+    }
+    return n;
+  }
+};
+
+/// Walks a sequence of sites that each mutate with probability p, drawing the
+/// gap to the next mutated site (one draw per mutation; see above).
+class SkipAheadSampler {
+public:
+  static constexpr size_t NEVER = std::numeric_limits<size_t>::max();
+
+protected:
+  double p;
+  double log_q;         ///< log(1 - p)
+  size_t gap=0;         ///< Sites left before the next mutated site (if has_gap)
+  bool has_gap=false;
+
+  size_t DrawGap(emp::Random & rnd) const {
+    if (p <= 0.0) return NEVER;
+    if (p >= 1.0) return 0;
+    // Inverse CDF: P(floor(log(1-U) / log(1-p)) >= k) = (1-p)^k
+    const double draw = std::floor(std::log1p(-rnd.GetDouble()) / log_q);
+    return (draw < (double)NEVER) ? (size_t)draw : NEVER;
+  }
+
+public:
+  SkipAheadSampler(double _p) : p(_p), log_q(std::log1p(-_p)) { }
+
+  /// Visit the next n sites, stopping at the first mutated one. Returns its
+  /// offset, or n if none of the n sites mutate.
+  size_t NextHit(emp::Random & rnd, size_t n) {
+    if (!has_gap) {
+      gap = DrawGap(rnd);
+      has_gap = true;
+    }
+    if (gap < n) {
+      has_gap = false;
+      return gap;
+    }
+    if (gap != NEVER) gap -= n;   // Geometric gaps are memoryless, so the rest carries over
+    return n;
+  }
+};
+
+/// Genome being mutated. Operators read through Get & call Edit before changing
+/// anything: edits go either straight to a genome (in place) or to a private
+/// copy of a shared genome, made on the first edit (copy-on-write).
+class MutationTarget {
+public:
+  using genome_t = DigitalOrganism::Genome;
+  using program_t = DigitalOrganism::program_t;
+
+protected:
+  const genome_t & source;
+  emp::Ptr<genome_t> target;     ///< Where edits go (nullptr until the first edit, if copying on write)
+  emp::Ptr<genome_t> copy=nullptr;
+
+public:
+  /// Edit genome in place
+  MutationTarget(genome_t & genome) : source(genome), target(&genome) { }
+  /// Copy genome on the first edit
+  MutationTarget(const genome_t & genome) : source(genome), target(nullptr) { }
+  MutationTarget(const MutationTarget &) = delete;
+  MutationTarget & operator=(const MutationTarget &) = delete;
+  ~MutationTarget() { if (copy) copy.Delete(); }
+
+  const genome_t & Get() const { return target ? *target : source; }
+  const program_t & GetProgram() const { return Get().program; }
+
+  genome_t & Edit() {
+    if (!target) target = copy = emp::NewPtr<genome_t>(source);
+    return *target;
+  }
+  program_t & EditProgram() { return Edit().program; }
+
+  /// Was the shared genome copied (i.e., edited)?
+  bool HasCopy() const { return copy != nullptr; }
+
+  /// Move the edited copy out (only valid if HasCopy)
+  genome_t TakeCopy() { emp_assert(copy); return std::move(*copy); }
+};
+
+/// What one call to Mutator::Mutate changed. Function indices refer to the
+/// mutated program; changes are listed even if they happen to cancel out.
+struct MutationDelta {
+  /// Instruction substituted in place (operation, argument, or tag)
+  struct InstEdit {
+    size_t fID;
+    size_t pos;
+    bool operator<(const InstEdit & in) const { return fID < in.fID || (fID == in.fID && pos < in.pos); }
+    bool operator==(const InstEdit & in) const { return fID == in.fID && pos == in.pos; }
+  };
+
+  size_t num_mutations=0;
+  bool whole_program=false;       ///< Changes weren't tracked (signalgp engine): treat every function as changed
+  bool birth_tag_changed=false;
+  /// Parent function each function came from (duplicates come from the function
+  /// they copy). Empty if no functions were added or removed (function i came from function i).
+  emp::vector<size_t> function_sources;
+  emp::vector<size_t> retagged_functions;   ///< Function tags flipped
+  emp::vector<size_t> resized_functions;    ///< Instructions inserted/deleted (positions shift; treat every instruction as changed)
+  emp::vector<InstEdit> inst_edits;         ///< Substitutions (only in functions that weren't resized)
+  emp::vector<size_t> changed_functions;    ///< Every function that differs from its source (retagged, resized, or edited)
+
+  operator size_t() const { return num_mutations; }
+
+  size_t GetSourceFunction(size_t fID) const { return function_sources.empty() ? fID : function_sources[fID]; }
+
+  bool IsFunctionChanged(size_t fID) const {
+    return whole_program || std::binary_search(changed_functions.begin(), changed_functions.end(), fID);
+  }
+
+  bool IsProgramChanged() const { return whole_program || !function_sources.empty() || !changed_functions.empty(); }
+
+  /// Sort & merge the change lists (called by Mutator::Mutate)
+  void Finish() {
+    auto sort_unique = [](auto & vec) {
+      std::sort(vec.begin(), vec.end());
+      vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+    };
+    sort_unique(retagged_functions);
+    sort_unique(resized_functions);
+    sort_unique(inst_edits);
+    inst_edits.erase(std::remove_if(inst_edits.begin(), inst_edits.end(), [this](const InstEdit & edit) {
+      return std::binary_search(resized_functions.begin(), resized_functions.end(), edit.fID);
+    }), inst_edits.end());
+    changed_functions = retagged_functions;
+    changed_functions.insert(changed_functions.end(), resized_functions.begin(), resized_functions.end());
+    for (const InstEdit & edit : inst_edits) changed_functions.emplace_back(edit.fID);
+    sort_unique(changed_functions);
+  }
+
+  /// Digest of the mutated genome, given the digest of the genome it was mutated from.
+  /// Only changed functions are rehashed.
+  void UpdateDigest(const DigitalOrganism::GenomeDigest & parent, const DigitalOrganism::Genome & genome,
+                    DigitalOrganism::GenomeDigest & digest) const {
+    using hash_t = DigitalOrganism::GenomeHash;
+    const size_t num_functions = genome.program.GetSize();
+    digest.function_hashes.resize(num_functions);
+    for (size_t fID = 0; fID < num_functions; ++fID) {
+      digest.function_hashes[fID] = IsFunctionChanged(fID) ? hash_t::HashFunction(genome.program[fID])
+                                                           : parent.function_hashes[GetSourceFunction(fID)];
+    }
+    digest.hash = hash_t::HashGenome(digest.function_hashes, genome.birth_tag);
+  }
+};
+
+/// Validate a mutated genome against configuration settings (see
+/// ValidateDigitalOrganismGenome), assuming the genome it was mutated from was
+/// valid: only the functions (and instructions) the mutation changed are checked.
+bool ValidateMutatedGenome(const DOLWorldConfig & config, const DigitalOrganism::Genome & genome,
+                           const MutationDelta & delta) {
+  using hardware_t = typename DigitalOrganism::sgp_hardware_t;
+  if (delta.whole_program) return ValidateDigitalOrganismGenome(config, genome);
+  const DigitalOrganism::program_t & prog = genome.program;
+  auto valid_inst = [&config](const typename hardware_t::inst_t & inst) {
+    for (size_t k = 0; k < hardware_t::MAX_INST_ARGS; ++k) {
+      if (inst.args[k] < config.MIN_ARGUMENT_VAL() || inst.args[k] > config.MAX_ARGUMENT_VAL()) return false;
+    }
+    return true;
+  };
+  if (!delta.function_sources.empty() || !delta.resized_functions.empty()) {
+    if (prog.GetSize() < config.MIN_FUNCTION_CNT() || prog.GetSize() > config.MAX_FUNCTION_CNT()) return false;
+    if (prog.GetInstCnt() > config.MAX_FUNCTION_CNT() * config.MAX_FUNCTION_LEN()) return false;
+  }
+  for (size_t fID : delta.resized_functions) {
+    if (prog[fID].GetSize() < config.MIN_FUNCTION_LEN() || prog[fID].GetSize() > config.MAX_FUNCTION_LEN()) return false;
+    for (size_t iID = 0; iID < prog[fID].GetSize(); ++iID) {
+      if (!valid_inst(prog[fID][iID])) return false;
+    }
+  }
+  for (const MutationDelta::InstEdit & edit : delta.inst_edits) {
+    if (!valid_inst(prog[edit.fID][edit.pos])) return false;
+  }
+  return true;
+}
 
 class Mutator {
 public:
   using tag_t = typename DigitalOrganism::tag_t;
+  using sgp_hardware_t = typename DigitalOrganism::sgp_hardware_t;
+  using program_t = typename DigitalOrganism::program_t;
+  using function_t = typename sgp_hardware_t::Function;
+  using inst_t = typename sgp_hardware_t::inst_t;
+  using inst_seq_t = emp::vector<inst_t>;
 
 protected:
   emp::SignalGPMutator<DOLWorldConstants::TAG_WIDTH> sgp_program_mutator;
 
+  MutationEngine engine=MutationEngine::SIGNALGP;
+
+  // Program constraints
+  size_t MIN_FUNCTION_CNT=1;
+  size_t MAX_FUNCTION_CNT=1;
+  size_t MIN_FUNCTION_LEN=1;
+  size_t MAX_FUNCTION_LEN=1;
+  size_t MAX_TOTAL_LEN=1;
+  int MIN_ARGUMENT_VAL=0;
+  int MAX_ARGUMENT_VAL=0;
+  // Mutation rates
+  double PROGRAM_ARG_SUB__PER_ARG=0.0;
+  double PROGRAM_INST_SUB__PER_INST=0.0;
+  double PROGRAM_INST_INS__PER_INST=0.0;
+  double PROGRAM_INST_DEL__PER_INST=0.0;
+  double PROGRAM_SLIP__PER_FUN=0.0;
+  double PROGRAM_FUNC_DUP__PER_FUN=0.0;
+  double PROGRAM_FUNC_DEL__PER_FUN=0.0;
+  double PROGRAM_TAG_BIT_FLIP__PER_BIT=0.0;
   double BIRTH_TAG_BIT_FLIP__PER_BIT=0.0;
 
+  /// Call fun(i) for each mutated site i in [0, n), in order
+  template<typename SAMPLER, typename FUN>
+  static void ForEachHit(SAMPLER & sampler, emp::Random & rnd, size_t n, FUN && fun) {
+    for (size_t i = sampler.NextHit(rnd, n); i < n; i += 1 + sampler.NextHit(rnd, n - i - 1)) fun(i);
+  }
+
+  /// Finds instructions (to edit) by their index in the flattened program (indices must not decrease)
+  struct InstCursor {
+    MutationTarget & target;
+    size_t fID=0;
+    size_t base=0;   ///< Flattened index of function fID's first instruction
+
+    InstCursor(MutationTarget & _target) : target(_target) { }
+
+    inst_t & At(size_t inst_index) {
+      program_t & program = target.EditProgram();
+      while (inst_index >= base + program[fID].GetSize()) {
+        base += program[fID].GetSize();
+        ++fID;
+      }
+      return program[fID][inst_index - base];
+    }
+
+    /// Function & position of the instruction at inst_index (call At(inst_index) first)
+    MutationDelta::InstEdit GetEdit(size_t inst_index) const { return {fID, inst_index - base}; }
+  };
+
+  inst_t GenRandInst(emp::Random & rnd, size_t num_insts) const {
+    return inst_t(rnd.GetUInt(num_insts), rnd.GetInt(MIN_ARGUMENT_VAL, MAX_ARGUMENT_VAL + 1),
+                  rnd.GetInt(MIN_ARGUMENT_VAL, MAX_ARGUMENT_VAL + 1), rnd.GetInt(MIN_ARGUMENT_VAL, MAX_ARGUMENT_VAL + 1),
+                  emp::GenRandSignalGPTag<DOLWorldConstants::TAG_WIDTH>(rnd));
+  }
+
+  // Mutation operators (see MutateProgram)
+  template<typename SAMPLER> size_t MutateFuncDup(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateFuncDel(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateFuncTags(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateSlip(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateSubs(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateInstInDel(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+  template<typename SAMPLER> size_t MutateBirthTag(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const;
+
 public:
 
   void Setup(const DOLWorldConfig & config) {
+    if (!ParseMutationEngine(config.MUTATION_ENGINE(), engine)) {
+      std::cout << "Unrecognized MUTATION_ENGINE (" << config.MUTATION_ENGINE() << ")! Exiting." << std::endl;
+      exit(-1);
+    }
     // Setup sgp mutator
     // - Program constraints
     sgp_program_mutator.SetProgMinFuncCnt(config.MIN_FUNCTION_CNT());
@@ -37,26 +368,324 @@ public:
     sgp_program_mutator.FUNC_DEL__PER_FUNC(config.PROGRAM_FUNC_DEL__PER_FUN());
     sgp_program_mutator.TAG_BIT_FLIP__PER_BIT(config.PROGRAM_TAG_BIT_FLIP__PER_BIT());
 
+    // Setup Mutator's own operators (per-site & skip-ahead engines)
+    MIN_FUNCTION_CNT = config.MIN_FUNCTION_CNT();
+    MAX_FUNCTION_CNT = config.MAX_FUNCTION_CNT();
+    MIN_FUNCTION_LEN = config.MIN_FUNCTION_LEN();
+    MAX_FUNCTION_LEN = config.MAX_FUNCTION_LEN();
+    MAX_TOTAL_LEN = config.MAX_FUNCTION_LEN() * config.MAX_FUNCTION_CNT();
+    MIN_ARGUMENT_VAL = config.MIN_ARGUMENT_VAL();
+    MAX_ARGUMENT_VAL = config.MAX_ARGUMENT_VAL();
+    PROGRAM_ARG_SUB__PER_ARG = config.PROGRAM_ARG_SUB__PER_ARG();
+    PROGRAM_INST_SUB__PER_INST = config.PROGRAM_INST_SUB__PER_INST();
+    PROGRAM_INST_INS__PER_INST = config.PROGRAM_INST_INS__PER_INST();
+    PROGRAM_INST_DEL__PER_INST = config.PROGRAM_INST_DEL__PER_INST();
+    PROGRAM_SLIP__PER_FUN = config.PROGRAM_SLIP__PER_FUN();
+    PROGRAM_FUNC_DUP__PER_FUN = config.PROGRAM_FUNC_DUP__PER_FUN();
+    PROGRAM_FUNC_DEL__PER_FUN = config.PROGRAM_FUNC_DEL__PER_FUN();
+    PROGRAM_TAG_BIT_FLIP__PER_BIT = config.PROGRAM_TAG_BIT_FLIP__PER_BIT();
+
     BIRTH_TAG_BIT_FLIP__PER_BIT = config.BIRTH_TAG_BIT_FLIP__PER_BIT();
   }
 
-  size_t Mutate(DigitalOrganism & org, emp::Random & rnd) {
-    return Mutate(org.GetGenome(), rnd);
+  MutationEngine GetEngine() const { return engine; }
+  void SetEngine(MutationEngine _engine) { engine = _engine; }
+
+  /// Mutate an organism. If anything mutated, the organism gets a new
+  /// (standalone) genotype, with its digest updated from the parent's if the
+  /// parent's is known; otherwise it keeps sharing its current genotype.
+  MutationDelta Mutate(DigitalOrganism & org, emp::Random & rnd) {
+    MutationTarget target(org.GetGenome());
+    MutationDelta delta = Mutate(target, rnd);
+    if (delta.num_mutations && target.HasCopy()) {
+      const DigitalOrganism::genotype_t & parent = org.GetGenotype();
+      if (parent.HasDigest()) {
+        DigitalOrganism::GenomeDigest digest;
+        delta.UpdateDigest(parent.GetDigest(), target.Get(), digest);
+        org.SetGenome(target.TakeCopy(), std::move(digest));
+      } else {
+        org.SetGenome(target.TakeCopy());
+      }
+    }
+    return delta;
   }
 
-  size_t Mutate(DigitalOrganism::Genome & genome, emp::Random & rnd) {
-    size_t num_mutations = 0;
-    num_mutations += sgp_program_mutator.ApplyMutations(genome.program, rnd);
-    tag_t & tag = genome.birth_tag;
-    for (size_t k = 0; k < tag.GetSize(); ++k) {
-      if (rnd.P(BIRTH_TAG_BIT_FLIP__PER_BIT)) {
-        tag.Toggle(k);
-        ++num_mutations;
+  /// Mutate genome in place
+  MutationDelta Mutate(DigitalOrganism::Genome & genome, emp::Random & rnd) {
+    MutationTarget target(genome);
+    return Mutate(target, rnd);
+  }
+
+  MutationDelta Mutate(MutationTarget & target, emp::Random & rnd) {
+    MutationDelta delta;
+    switch (engine) {
+      case MutationEngine::PER_SITE:
+        delta.num_mutations = MutateProgram<PerSiteSampler>(target, rnd, delta) + MutateBirthTag<PerSiteSampler>(target, rnd, delta);
+        break;
+      case MutationEngine::SKIP_AHEAD:
+        delta.num_mutations = MutateProgram<SkipAheadSampler>(target, rnd, delta) + MutateBirthTag<SkipAheadSampler>(target, rnd, delta);
+        break;
+      default: {
+        delta.num_mutations = sgp_program_mutator.ApplyMutations(target.EditProgram(), rnd);
+        delta.whole_program = delta.num_mutations > 0;
+        tag_t & tag = target.Edit().birth_tag;
+        for (size_t k = 0; k < tag.GetSize(); ++k) {
+          if (rnd.P(BIRTH_TAG_BIT_FLIP__PER_BIT)) {
+            tag.Toggle(k);
+            ++delta.num_mutations;
+            delta.birth_tag_changed = true;
+          }
+        }
+        break;
       }
     }
+    delta.Finish();
+    return delta;
+  }
+
+  /// Apply every program mutation operator (sampling sites with SAMPLER),
+  /// recording changes in delta. Returns the number of mutations.
+  template<typename SAMPLER>
+  size_t MutateProgram(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+    size_t num_mutations = 0;
+    num_mutations += MutateFuncDup<SAMPLER>(target, rnd, delta);
+    num_mutations += MutateFuncDel<SAMPLER>(target, rnd, delta);
+    num_mutations += MutateFuncTags<SAMPLER>(target, rnd, delta);
+    num_mutations += MutateSlip<SAMPLER>(target, rnd, delta);
+    num_mutations += MutateSubs<SAMPLER>(target, rnd, delta);
+    num_mutations += MutateInstInDel<SAMPLER>(target, rnd, delta);
     return num_mutations;
   }
 
 };
 
-#endif
\ No newline at end of file
+/// Sites: functions, in order, including duplicates added by this operator
+/// (as SignalGPMutator walks the growing program). A mutated function is copied
+/// onto the end of the program, if the result stays within MAX_FUNCTION_CNT &
+/// the total length limit.
+template<typename SAMPLER>
+size_t Mutator::MutateFuncDup(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER sampler(PROGRAM_FUNC_DUP__PER_FUN);
+  size_t num_mutations = 0;
+  size_t prog_len = target.GetProgram().GetInstCnt();
+  size_t begin = 0;                            // Functions [begin, end) haven't been visited yet
+  size_t end = target.GetProgram().GetSize();
+  while (begin < end) {
+    ForEachHit(sampler, rnd, end - begin, [&](size_t offset) {
+      const size_t fID = begin + offset;
+      const program_t & program = target.GetProgram();
+      const size_t func_len = program[fID].GetSize();
+      if (program.GetSize() >= MAX_FUNCTION_CNT || prog_len + func_len > MAX_TOTAL_LEN) return;
+      const function_t dup(program[fID]);   // (copy first; pushing may reallocate the function set)
+      if (delta.function_sources.empty()) {
+        delta.function_sources.resize(program.GetSize());
+        for (size_t i = 0; i < program.GetSize(); ++i) delta.function_sources[i] = i;
+      }
+      delta.function_sources.emplace_back(delta.function_sources[fID]);
+      target.EditProgram().PushFunction(dup);
+      prog_len += func_len;
+      ++num_mutations;
+    });
+    begin = end;
+    end = target.GetProgram().GetSize();
+  }
+  return num_mutations;
+}
+
+/// Sites: functions (present before this operator), visited as SignalGPMutator
+/// visits them: in order, except that a deleted function is replaced by the
+/// last function, which is visited next. A mutated function is deleted, unless
+/// that would leave fewer than MIN_FUNCTION_CNT.
+template<typename SAMPLER>
+size_t Mutator::MutateFuncDel(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER sampler(PROGRAM_FUNC_DEL__PER_FUN);
+  size_t num_mutations = 0;
+  size_t fID = 0;
+  // Every site either moves past a function or deletes the last one, so
+  // (program size - fID) sites remain
+  while (true) {
+    const size_t num_funcs = target.GetProgram().GetSize();
+    fID += sampler.NextHit(rnd, num_funcs - fID);
+    if (fID >= num_funcs) break;
+    if (num_funcs <= MIN_FUNCTION_CNT) {
+      ++fID;
+      continue;
+    }
+    program_t & program = target.EditProgram();
+    if (delta.function_sources.empty()) {
+      delta.function_sources.resize(num_funcs);
+      for (size_t i = 0; i < num_funcs; ++i) delta.function_sources[i] = i;
+    }
+    delta.function_sources[fID] = delta.function_sources.back();
+    delta.function_sources.pop_back();
+    program[fID] = program[num_funcs - 1];
+    program.program.pop_back();
+    ++num_mutations;
+  }
+  return num_mutations;
+}
+
+/// Sites: every bit of every function tag
+template<typename SAMPLER>
+size_t Mutator::MutateFuncTags(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER sampler(PROGRAM_TAG_BIT_FLIP__PER_BIT);
+  size_t num_mutations = 0;
+  const size_t tag_width = DOLWorldConstants::TAG_WIDTH;
+  ForEachHit(sampler, rnd, target.GetProgram().GetSize() * tag_width, [&](size_t site) {
+    target.EditProgram()[site / tag_width].affinity.Toggle(site % tag_width);
+    delta.retagged_functions.emplace_back(site / tag_width);
+    ++num_mutations;
+  });
+  return num_mutations;
+}
+
+/// Sites: functions. A mutated function picks two random positions, begin &
+/// end: if begin < end, [begin, end) is duplicated (inserted at end); if
+/// begin > end, [end, begin) is deleted. Skipped if the result would break
+/// function or total length limits.
+template<typename SAMPLER>
+size_t Mutator::MutateSlip(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER sampler(PROGRAM_SLIP__PER_FUN);
+  size_t num_mutations = 0;
+  size_t prog_len = target.GetProgram().GetInstCnt();
+  ForEachHit(sampler, rnd, target.GetProgram().GetSize(), [&](size_t fID) {
+    const size_t func_len = target.GetProgram()[fID].GetSize();
+    if (func_len == 0) return;
+    const size_t begin = rnd.GetUInt(func_len);
+    const size_t end = rnd.GetUInt(func_len);
+    if (begin < end) {
+      const size_t dup_size = end - begin;
+      if (prog_len + dup_size > MAX_TOTAL_LEN || func_len + dup_size > MAX_FUNCTION_LEN) return;
+      inst_seq_t & seq = target.EditProgram()[fID].inst_seq;
+      const inst_seq_t segment(seq.begin() + begin, seq.begin() + end);
+      seq.insert(seq.begin() + end, segment.begin(), segment.end());
+      delta.resized_functions.emplace_back(fID);
+      prog_len += dup_size;
+      ++num_mutations;
+    } else if (begin > end) {
+      const size_t del_size = begin - end;
+      if (func_len - del_size < MIN_FUNCTION_LEN) return;
+      inst_seq_t & seq = target.EditProgram()[fID].inst_seq;
+      seq.erase(seq.begin() + end, seq.begin() + begin);
+      delta.resized_functions.emplace_back(fID);
+      prog_len -= del_size;
+      ++num_mutations;
+    }
+  });
+  return num_mutations;
+}
+
+/// Sites: every tag bit of every instruction (flipped), every instruction's
+/// operation (replaced by a random one), and every instruction argument
+/// (replaced by a random value in [MIN_ARGUMENT_VAL, MAX_ARGUMENT_VAL])
+template<typename SAMPLER>
+size_t Mutator::MutateSubs(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  const size_t num_insts = target.GetProgram().GetInstCnt();
+  const size_t num_ops = target.GetProgram().GetInstLib()->GetSize();
+  const size_t tag_width = DOLWorldConstants::TAG_WIDTH;
+  const size_t num_args = sgp_hardware_t::MAX_INST_ARGS;
+  size_t num_mutations = 0;
+  SAMPLER tag_sampler(PROGRAM_TAG_BIT_FLIP__PER_BIT);
+  InstCursor tag_cursor(target);
+  ForEachHit(tag_sampler, rnd, num_insts * tag_width, [&](size_t site) {
+    tag_cursor.At(site / tag_width).affinity.Toggle(site % tag_width);
+    delta.inst_edits.push_back(tag_cursor.GetEdit(site / tag_width));
+    ++num_mutations;
+  });
+  SAMPLER op_sampler(PROGRAM_INST_SUB__PER_INST);
+  InstCursor op_cursor(target);
+  ForEachHit(op_sampler, rnd, num_insts, [&](size_t site) {
+    op_cursor.At(site).id = rnd.GetUInt(num_ops);
+    delta.inst_edits.push_back(op_cursor.GetEdit(site));
+    ++num_mutations;
+  });
+  SAMPLER arg_sampler(PROGRAM_ARG_SUB__PER_ARG);
+  InstCursor arg_cursor(target);
+  ForEachHit(arg_sampler, rnd, num_insts * num_args, [&](size_t site) {
+    arg_cursor.At(site / num_args).args[site % num_args] = rnd.GetInt(MIN_ARGUMENT_VAL, MAX_ARGUMENT_VAL + 1);
+    delta.inst_edits.push_back(arg_cursor.GetEdit(site / num_args));
+    ++num_mutations;
+  });
+  return num_mutations;
+}
+
+/// Sites: every instruction, twice (insertion, then deletion). As in
+/// SignalGPMutator, a function inserts as many random instructions as its sites
+/// drew, each before a random position (drawn with replacement), in position
+/// order; an insertion that would break length limits waits for a later
+/// position (and is dropped if none has room). A deletion drops the site's
+/// instruction, unless the function is already at MIN_FUNCTION_LEN.
+template<typename SAMPLER>
+size_t Mutator::MutateInstInDel(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER ins_sampler(PROGRAM_INST_INS__PER_INST);
+  SAMPLER del_sampler(PROGRAM_INST_DEL__PER_INST);
+  const size_t num_insts = target.GetProgram().GetInstCnt();
+  const size_t num_ops = target.GetProgram().GetInstLib()->GetSize();
+  size_t next_ins = ins_sampler.NextHit(rnd, num_insts);
+  size_t next_del = del_sampler.NextHit(rnd, num_insts);
+  size_t num_mutations = 0;
+  size_t prog_len = num_insts;
+  size_t base = 0;   // Flattened index of the current function's first instruction
+  emp::vector<size_t> ins_positions;
+  for (size_t fID = 0; fID < target.GetProgram().GetSize(); ++fID) {
+    const inst_seq_t & seq = target.GetProgram()[fID].inst_seq;
+    const size_t end = base + seq.size();
+    if (next_ins >= end && next_del >= end) { // Nothing to do in this function
+      base = end;
+      continue;
+    }
+    ins_positions.clear();
+    while (next_ins < end) {
+      ins_positions.emplace_back(rnd.GetUInt(seq.size()));
+      next_ins = next_ins + 1 + ins_sampler.NextHit(rnd, num_insts - next_ins - 1);
+    }
+    std::sort(ins_positions.begin(), ins_positions.end());
+    size_t next_pos = 0;
+    inst_seq_t new_seq;
+    new_seq.reserve(seq.size() + ins_positions.size());
+    size_t func_len = seq.size();
+    const size_t func_mutations = num_mutations;
+    for (size_t i = 0; i < seq.size(); ++i) {
+      const size_t site = base + i;
+      while (next_pos < ins_positions.size() && ins_positions[next_pos] <= i
+             && prog_len + 1 <= MAX_TOTAL_LEN && func_len + 1 <= MAX_FUNCTION_LEN) {
+        new_seq.emplace_back(GenRandInst(rnd, num_ops));
+        ++next_pos;
+        ++func_len;
+        ++prog_len;
+        ++num_mutations;
+      }
+      if (site == next_del) {
+        next_del = site + 1 + del_sampler.NextHit(rnd, num_insts - site - 1);
+        if (func_len > MIN_FUNCTION_LEN) {
+          --func_len;
+          --prog_len;
+          ++num_mutations;
+          continue;
+        }
+      }
+      new_seq.emplace_back(seq[i]);
+    }
+    if (num_mutations != func_mutations) {
+      target.EditProgram()[fID].inst_seq.swap(new_seq);
+      delta.resized_functions.emplace_back(fID);
+    }
+    base = end;
+  }
+  return num_mutations;
+}
+
+/// Sites: every bit of the birth tag
+template<typename SAMPLER>
+size_t Mutator::MutateBirthTag(MutationTarget & target, emp::Random & rnd, MutationDelta & delta) const {
+  SAMPLER sampler(BIRTH_TAG_BIT_FLIP__PER_BIT);
+  size_t num_mutations = 0;
+  ForEachHit(sampler, rnd, target.Get().birth_tag.GetSize(), [&](size_t k) {
+    target.Edit().birth_tag.Toggle(k);
+    delta.birth_tag_changed = true;
+    ++num_mutations;
+  });
+  return num_mutations;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ *  @date 2019
+ *
+ *  @file  PhaseTimings.h
+ *
+ *  Wall time DOLWorld::RunStep spends in each phase of an update (see
+ *  RunStatus::Phase), for the last update and summed over the run. Timing a
+ *  phase costs one steady_clock read, so phase timing is cheap enough to leave
+ *  on (PHASE_TIMING); by default only the end-of-run summary is printed
+ *  (PHASE_TIMING_PER_UPDATE also prints every update's timings).
+ *
+ *  Per-deme timing (PHASE_TIMING_PER_DEME) also times every deme's Advance, to
+ *  show load imbalance: the slowest deme vs. the mean deme each update and, for
+ *  parallel runs, the busiest worker thread vs. the mean thread.
+ */
+
+#ifndef _PHASE_TIMINGS_H
+#define _PHASE_TIMINGS_H
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "base/vector.h"
+
+#include "RunStatus.h"
+
+class PhaseTimings {
+public:
+  using timer_clock_t = std::chrono::steady_clock;
+  static constexpr size_t NUM_PHASES = RunStatus::NUM_PHASES;
+
+  /// Load balance over one update (or summed over the run)
+  struct Balance {
+    double max_ms=0.0;     ///< Slowest deme (or busiest thread)
+    double mean_ms=0.0;    ///< Mean deme (or thread)
+
+    void Clear() { max_ms = mean_ms = 0.0; }
+    /// Slowest over mean (1 = perfectly balanced; 0 if nothing was timed)
+    double GetImbalance() const { return (mean_ms > 0.0) ? max_ms / mean_ms : 0.0; }
+  };
+
+protected:
+  bool enabled=false;
+  bool per_deme=false;
+  timer_clock_t::time_point phase_start;
+  size_t num_updates=0;                 ///< Updates timed
+  double update_ms[NUM_PHASES] = {};    ///< Last update
+  double total_ms[NUM_PHASES] = {};     ///< Summed over every update timed
+
+  emp::vector<double> deme_ms;          ///< Last update's time advancing each deme (< 0 if not advanced)
+  emp::vector<double> thread_ms;        ///< Last update's time each worker thread spent advancing demes
+  Balance deme_balance;                 ///< Last update
+  Balance thread_balance;               ///< Last update
+  Balance total_deme_balance;           ///< Summed over every update timed
+  Balance total_thread_balance;         ///< Summed over every update timed
+
+  static double Ms(timer_clock_t::time_point start, timer_clock_t::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  static void Measure(const emp::vector<double> & times, Balance & balance) {
+    balance.Clear();
+    size_t count = 0;
+    for (double ms : times) {
+      if (ms < 0.0) continue;
+      balance.max_ms = std::max(balance.max_ms, ms);
+      balance.mean_ms += ms;
+      ++count;
+    }
+    if (count) balance.mean_ms /= (double)count;
+  }
+
+public:
+  /// Start a run's timings over (num_positions demes, advanced on num_threads threads)
+  void Setup(bool _enabled, bool _per_deme, size_t num_positions, size_t num_threads) {
+    enabled = _enabled || _per_deme;
+    per_deme = _per_deme;
+    num_updates = 0;
+    std::fill(update_ms, update_ms + NUM_PHASES, 0.0);
+    std::fill(total_ms, total_ms + NUM_PHASES, 0.0);
+    deme_ms.assign((per_deme) ? num_positions : 0, -1.0);
+    thread_ms.assign((per_deme) ? num_threads : 0, 0.0);
+    deme_balance.Clear();
+    thread_balance.Clear();
+    total_deme_balance.Clear();
+    total_thread_balance.Clear();
+  }
+
+  bool IsEnabled() const { return enabled; }
+  bool IsTimingDemes() const { return per_deme; }
+  size_t GetNumUpdates() const { return num_updates; }
+
+  double GetUpdateMS(size_t phase) const { return update_ms[phase]; }
+  double GetTotalMS(size_t phase) const { return total_ms[phase]; }
+  const Balance & GetDemeBalance() const { return deme_balance; }
+  const Balance & GetThreadBalance() const { return thread_balance; }
+  const Balance & GetTotalDemeBalance() const { return total_deme_balance; }
+  const Balance & GetTotalThreadBalance() const { return total_thread_balance; }
+
+  /// Start timing an update (its first phase starts now)
+  void BeginUpdate() {
+    if (!enabled) return;
+    if (per_deme) {
+      std::fill(deme_ms.begin(), deme_ms.end(), -1.0);
+      std::fill(thread_ms.begin(), thread_ms.end(), 0.0);
+    }
+    phase_start = timer_clock_t::now();
+  }
+
+  /// The given phase ends (and the next begins) now
+  void EndPhase(RunStatus::Phase phase) {
+    if (!enabled) return;
+    const timer_clock_t::time_point now = timer_clock_t::now();
+    update_ms[phase] = Ms(phase_start, now);
+    phase_start = now;
+  }
+
+  /// Advance the deme at position pos (on worker thread thread_id) by calling
+  /// advance(), timing it if timing per deme. Safe to call from every worker
+  /// thread at once, for different positions.
+  template<typename FUN>
+  void TimeDeme(size_t pos, size_t thread_id, FUN && advance) {
+    if (!per_deme) {
+      advance();
+      return;
+    }
+    const timer_clock_t::time_point start = timer_clock_t::now();
+    advance();
+    const double ms = Ms(start, timer_clock_t::now());
+    deme_ms[pos] = ms;
+    thread_ms[thread_id] += ms;
+  }
+
+  /// Finish timing an update (after its last phase)
+  void EndUpdate() {
+    if (!enabled) return;
+    ++num_updates;
+    for (size_t phase = 0; phase < NUM_PHASES; ++phase) total_ms[phase] += update_ms[phase];
+    if (!per_deme) return;
+    Measure(deme_ms, deme_balance);
+    Measure(thread_ms, thread_balance);
+    total_deme_balance.max_ms += deme_balance.max_ms;
+    total_deme_balance.mean_ms += deme_balance.mean_ms;
+    total_thread_balance.max_ms += thread_balance.max_ms;
+    total_thread_balance.mean_ms += thread_balance.mean_ms;
+  }
+
+  /// One line of the last update's timings (e.g., "phase ms: trace=0.001 ...")
+  void WriteUpdate(std::ostream & os) const;
+
+  /// Cumulative timings (total & per-update mean per phase, plus load balance)
+  void WriteSummary(std::ostream & os) const;
+};
+
+void PhaseTimings::WriteUpdate(std::ostream & os) const {
+  os << "  phase ms:";
+  for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+    os << " " << RunStatus::GetPhaseName(phase) << "=" << update_ms[phase];
+  }
+  if (per_deme) {
+    os << "; deme ms max/mean=" << deme_balance.max_ms << "/" << deme_balance.mean_ms;
+    if (thread_ms.size() > 1) os << "; thread ms max/mean=" << thread_balance.max_ms << "/" << thread_balance.mean_ms;
+  }
+  os << std::endl;
+}
+
+void PhaseTimings::WriteSummary(std::ostream & os) const {
+  double run_ms = 0.0;
+  for (size_t phase = 0; phase < NUM_PHASES; ++phase) run_ms += total_ms[phase];
+  const double updates = (num_updates) ? (double)num_updates : 1.0;
+  os << "Phase timings (" << num_updates << " updates, " << run_ms << " ms):" << std::endl;
+  for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+    os << "  " << std::left << std::setw(14) << RunStatus::GetPhaseName(phase) << std::right
+       << " total_ms=" << total_ms[phase]
+       << " ms_per_update=" << (total_ms[phase] / updates)
+       << " share=" << ((run_ms > 0.0) ? 100.0 * total_ms[phase] / run_ms : 0.0) << "%" << std::endl;
+  }
+  if (per_deme) {
+    os << "  deme imbalance (slowest/mean deme, summed over updates)=" << total_deme_balance.GetImbalance() << std::endl;
+    if (thread_ms.size() > 1) {
+      os << "  thread imbalance (busiest/mean thread, summed over updates)=" << total_thread_balance.GetImbalance() << std::endl;
+    }
+  }
+}
+
+#endif
@@ -67,6 +67,25 @@ public:
   void AdvanceAvailabilityTracking();
 };
 
+/// Resource consumption/decay policies. RESOURCE_CONSUMPTION_MODE and
+/// RESOURCE_DECAY_MODE select a policy at setup, and the DOLWorld code paths that
+/// consume/decay resources are instantiated for each policy.
+enum class ResourcePolicyType { FIXED, PROPORTIONAL };
+
+/// Consume/decay a fixed amount of resource
+struct FixedResourcePolicy {
+  static constexpr ResourcePolicyType type = ResourcePolicyType::FIXED;
+  static double Consume(Resource & res, double amount) { return res.ConsumeFixed(amount); }
+  static void Decay(Resource & res, double amount) { res.DecayFixed(amount); }
+};
+
+/// Consume/decay a proportion of available resource
+struct ProportionalResourcePolicy {
+  static constexpr ResourcePolicyType type = ResourcePolicyType::PROPORTIONAL;
+  static double Consume(Resource & res, double prop) { return res.ConsumeProportion(prop); }
+  static void Decay(Resource & res, double prop) { res.DecayProportion(prop); }
+};
+
 /// Reset this resource
 void Resource::Reset() {
   amount = 0;
@@ -0,0 +1,144 @@
+/**
+ *  @date 2019
+ *
+ *  @file  RunStatus.h
+ *
+ *  Lightweight summary of a running world (for monitoring long runs; see
+ *  StatusServer.h) and the board the simulation thread publishes it to.
+ *
+ *  StatusBoard is double buffered: the simulation thread writes each new status
+ *  into the slot readers aren't pointed at, then flips which slot is current.
+ *  Neither side ever takes a lock or waits on the other. Each slot carries a
+ *  sequence number (odd while being written), so a reader that raced with two
+ *  publishes in a row notices and simply copies again. Slots are stored as
+ *  atomic words, so even that torn copy is well defined.
+ */
+
+#ifndef _RUN_STATUS_H
+#define _RUN_STATUS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+struct RunStatus {
+  static constexpr size_t MAX_RESOURCES = 64;   ///< Resource aggregates tracked (extra resources are dropped)
+
+  /// Parts of an update that are timed (see DOLWorld::RunStep & PhaseTimings.h)
+  /// - REPORTING: flushing the trace & sampling memory usage
+  /// - WORLD_UPDATE: emp::World::Update (signals, systematics, etc.)
+  enum Phase : size_t { TRACE=0, ENVIRONMENT, DEMES, REPRODUCTION, REPORTING, WORLD_UPDATE, NUM_PHASES };
+
+  static const char * GetPhaseName(size_t phase) {
+    static constexpr const char * names[NUM_PHASES] = {
+      "trace", "environment", "demes", "reproduction", "reporting", "world_update"
+    };
+    return names[phase];
+  }
+
+  size_t update=0;                ///< Updates completed
+  size_t num_orgs=0;
+  size_t max_pop_size=0;
+  double elapsed_sec=0.0;         ///< Wall time since the world was set up
+  double updates_per_sec=0.0;     ///< Over (about) the last second
+  double phase_ms[NUM_PHASES] = {};   ///< Wall time spent in each phase during the last update
+  double phase_total_ms[NUM_PHASES] = {};   ///< Wall time spent in each phase, summed over the run
+
+  size_t estimated_memory_bytes=0;    ///< Population total from the last memory sample (0 if never sampled; see MemoryUsage.h)
+  size_t estimated_memory_update=0;   ///< Update of the last memory sample
+
+  /// Consumption tallies summed over the living population
+  size_t num_resources=0;
+  double consumed[MAX_RESOURCES] = {};
+  size_t consumption_successes[MAX_RESOURCES] = {};
+  size_t consumption_failures[MAX_RESOURCES] = {};
+
+  /// Write this status as a JSON object (resident_bytes is measured by the caller)
+  void WriteJSON(std::ostream & os, size_t resident_bytes=0) const;
+};
+
+class StatusBoard {
+protected:
+  static_assert(std::is_trivially_copyable<RunStatus>::value && sizeof(RunStatus) % sizeof(uint64_t) == 0,
+                "RunStatus must be copyable word by word.");
+  static constexpr size_t NUM_WORDS = sizeof(RunStatus) / sizeof(uint64_t);
+
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};   ///< Odd while the slot is being written
+    std::atomic<uint64_t> words[NUM_WORDS];
+  };
+
+  Slot slots[2];
+  std::atomic<size_t> current{0};        ///< Slot readers should copy
+  std::atomic<bool> published{false};
+
+public:
+  /// Has anything been published yet?
+  bool HasStatus() const { return published.load(std::memory_order_acquire); }
+
+  /// Publish a new status (simulation thread only; never blocks)
+  void Publish(const RunStatus & status) {
+    const size_t back = 1 - current.load(std::memory_order_relaxed);
+    Slot & slot = slots[back];
+    const uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < NUM_WORDS; ++i) {
+      uint64_t word;
+      std::memcpy(&word, (const char *)&status + i * sizeof(uint64_t), sizeof(uint64_t));
+      slot.words[i].store(word, std::memory_order_relaxed);
+    }
+    slot.sequence.store(seq + 2, std::memory_order_release);
+    current.store(back, std::memory_order_release);
+    published.store(true, std::memory_order_release);
+  }
+
+  /// Copy the latest status into out. Returns false if nothing has been published.
+  bool Read(RunStatus & out) const {
+    if (!HasStatus()) return false;
+    while (true) {
+      const Slot & slot = slots[current.load(std::memory_order_acquire)];
+      const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+      if (seq & 1) continue;   // Being rewritten (the simulation published twice while we looked)
+      for (size_t i = 0; i < NUM_WORDS; ++i) {
+        const uint64_t word = slot.words[i].load(std::memory_order_relaxed);
+        std::memcpy((char *)&out + i * sizeof(uint64_t), &word, sizeof(uint64_t));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == seq) return true;
+    }
+  }
+};
+
+void RunStatus::WriteJSON(std::ostream & os, size_t resident_bytes) const {
+  os << "{\"update\": " << update
+     << ", \"num_orgs\": " << num_orgs
+     << ", \"max_pop_size\": " << max_pop_size
+     << ", \"elapsed_sec\": " << elapsed_sec
+     << ", \"updates_per_sec\": " << updates_per_sec
+     << ", \"phase_ms\": {";
+  for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+    if (phase) os << ", ";
+    os << "\"" << GetPhaseName(phase) << "\": " << phase_ms[phase];
+  }
+  os << "}, \"phase_total_ms\": {";
+  for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+    if (phase) os << ", ";
+    os << "\"" << GetPhaseName(phase) << "\": " << phase_total_ms[phase];
+  }
+  os << "}, \"memory\": {\"resident_bytes\": " << resident_bytes
+     << ", \"estimated_bytes\": " << estimated_memory_bytes
+     << ", \"estimated_update\": " << estimated_memory_update
+     << "}, \"resources\": [";
+  for (size_t res_id = 0; res_id < num_resources; ++res_id) {
+    if (res_id) os << ", ";
+    os << "{\"consumed\": " << consumed[res_id]
+       << ", \"successes\": " << consumption_successes[res_id]
+       << ", \"failures\": " << consumption_failures[res_id] << "}";
+  }
+  os << "]}";
+}
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ *  @date 2019
+ *
+ *  @file  StatusServer.h
+ *
+ *  Monitoring thread for long native runs. Serves the latest RunStatus (see
+ *  RunStatus.h) as JSON on localhost HTTP and/or a Unix domain socket:
+ *    curl http://127.0.0.1:PORT/
+ *    nc -U PATH            (the status is written as soon as a client connects)
+ *
+ *  The server only ever reads the world's StatusBoard, so it never touches
+ *  simulation state or blocks the simulation thread. Resident memory is measured
+ *  here, per request (Linux only; reported as 0 elsewhere).
+ *
+ *  POSIX only (not built into the web version).
+ */
+
+#ifndef _STATUS_SERVER_H
+#define _STATUS_SERVER_H
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "base/vector.h"
+
+#include "RunStatus.h"
+
+class StatusServer {
+protected:
+  struct Listener {
+    int fd;
+    bool http;               ///< HTTP (TCP) or raw JSON (Unix socket)?
+    std::string unix_path;   ///< Removed when the server stops
+  };
+
+  const StatusBoard & board;
+  emp::vector<Listener> listeners;
+  std::thread thread;
+  std::atomic<bool> stopping{false};
+
+  static constexpr int POLL_MS = 200;   ///< How often the server thread checks whether it should stop
+
+  void ServeLoop();
+  void Serve(const Listener & listener);
+  std::string GetStatusJSON() const;
+
+  static void SendAll(int fd, const std::string & data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      #ifdef MSG_NOSIGNAL
+      const ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      #else
+      const ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+      #endif
+      if (n <= 0) return;
+      sent += (size_t)n;
+    }
+  }
+
+public:
+  StatusServer(const StatusBoard & _board) : board(_board) { }
+  StatusServer(const StatusServer &) = delete;
+  StatusServer & operator=(const StatusServer &) = delete;
+  ~StatusServer() { Stop(); }
+
+  /// Serve HTTP on 127.0.0.1:port. Returns false if the port can't be bound.
+  bool ListenHTTP(uint16_t port);
+
+  /// Serve raw JSON on a Unix domain socket (replacing any stale socket file).
+  /// Returns false if the socket can't be created.
+  bool ListenUnix(const std::string & path);
+
+  bool IsListening() const { return !listeners.empty(); }
+
+  /// Start answering requests on a background thread
+  void Start() {
+    if (thread.joinable() || listeners.empty()) return;
+    stopping = false;
+    thread = std::thread([this]() { ServeLoop(); });
+  }
+
+  /// Stop the background thread and close every listener
+  void Stop() {
+    stopping = true;
+    if (thread.joinable()) thread.join();
+    for (const Listener & listener : listeners) {
+      close(listener.fd);
+      if (listener.unix_path != "") unlink(listener.unix_path.c_str());
+    }
+    listeners.clear();
+  }
+
+  /// Resident set size of this process in bytes (0 if unknown)
+  static size_t GetResidentBytes() {
+    size_t pages_total = 0, pages_resident = 0;
+    FILE * statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    const int read = std::fscanf(statm, "%zu %zu", &pages_total, &pages_resident);
+    std::fclose(statm);
+    if (read != 2) return 0;
+    return pages_resident * (size_t)sysconf(_SC_PAGESIZE);
+  }
+};
+
+bool StatusServer::ListenHTTP(uint16_t port) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  const int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // Never reachable from other machines
+  if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+    close(fd);
+    return false;
+  }
+  listeners.push_back({fd, true, ""});
+  return true;
+}
+
+bool StatusServer::ListenUnix(const std::string & path) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  if (path == "" || path.size() >= sizeof(addr.sun_path)) return false;
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+    close(fd);
+    return false;
+  }
+  listeners.push_back({fd, false, path});
+  return true;
+}
+
+std::string StatusServer::GetStatusJSON() const {
+  RunStatus status;
+  if (!board.Read(status)) return "{}\n";
+  std::ostringstream os;
+  status.WriteJSON(os, GetResidentBytes());
+  os << "\n";
+  return os.str();
+}
+
+void StatusServer::ServeLoop() {
+  emp::vector<pollfd> fds(listeners.size());
+  while (!stopping) {
+    for (size_t i = 0; i < listeners.size(); ++i) fds[i] = {listeners[i].fd, POLLIN, 0};
+    if (poll(fds.data(), fds.size(), POLL_MS) <= 0) continue;
+    for (size_t i = 0; i < listeners.size(); ++i) {
+      if (fds[i].revents & POLLIN) Serve(listeners[i]);
+    }
+  }
+}
+
+/// Answer one client (any HTTP request gets the status, whatever the path)
+void StatusServer::Serve(const Listener & listener) {
+  const int client = accept(listener.fd, nullptr, nullptr);
+  if (client < 0) return;
+  if (listener.http) {
+    // Read (and ignore) the request headers; give up on slow clients
+    std::string request;
+    char buffer[1024];
+    pollfd client_fd = {client, POLLIN, 0};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+      if (poll(&client_fd, 1, POLL_MS) <= 0) break;
+      const ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+      if (n <= 0) break;
+      request.append(buffer, (size_t)n);
+    }
+    const std::string body = GetStatusJSON();
+    SendAll(client, "HTTP/1.0 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+                    + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+  } else {
+    SendAll(client, GetStatusJSON());
+  }
+  close(client);
+}
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ *  @date 2019
+ *
+ *  @file  WorkerPool.h
+ *
+ *  Fixed pool of worker threads for data-parallel loops (e.g., advancing every
+ *  deme in an update). Threads are started once and reused; the calling thread
+ *  does its share of the work as thread 0, so a pool of one thread runs
+ *  everything inline (and never starts a thread).
+ *
+ *  ParallelFor splits [0, n) into one contiguous block per thread (thread t
+ *  gets the t'th block), so which thread handles which index depends only on n
+ *  and the number of threads (not on timing).
+ *
+ *  Single-threaded WebAssembly builds (no pthreads) always get a pool of one.
+ */
+
+#ifndef _WORKER_POOL_H
+#define _WORKER_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "base/assert.h"
+#include "base/vector.h"
+
+class WorkerPool {
+public:
+  using task_fun_t = std::function<void(size_t)>;   ///< Called with thread id
+
+protected:
+  size_t num_threads;
+  emp::vector<std::thread> threads;   ///< Helper threads (ids 1 .. num_threads-1)
+
+  std::mutex mutex;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  const task_fun_t * task = nullptr;  ///< Current task (valid while a RunOnAll is in progress)
+  size_t task_generation = 0;         ///< Incremented for every task (wakes helpers)
+  size_t tasks_remaining = 0;         ///< Helpers still working on the current task
+  bool stopping = false;
+
+  void HelperLoop(size_t thread_id) {
+    size_t seen_generation = 0;
+    while (true) {
+      const task_fun_t * cur_task = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        start_cv.wait(lock, [&]() { return stopping || task_generation != seen_generation; });
+        if (stopping) return;
+        seen_generation = task_generation;
+        cur_task = task;
+      }
+      (*cur_task)(thread_id);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        --tasks_remaining;
+      }
+      done_cv.notify_one();
+    }
+  }
+
+public:
+  WorkerPool(size_t _num_threads) : num_threads(_num_threads ? _num_threads : 1) {
+    #if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    num_threads = 1;
+    #endif
+    for (size_t id = 1; id < num_threads; ++id) {
+      threads.emplace_back([this, id]() { HelperLoop(id); });
+    }
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool & operator=(const WorkerPool &) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    start_cv.notify_all();
+    for (std::thread & thread : threads) thread.join();
+  }
+
+  size_t GetNumThreads() const { return num_threads; }
+
+  /// Run fun(thread_id) once on every thread in the pool (the caller runs
+  /// thread 0) and wait for all of them to finish.
+  void RunOnAll(const task_fun_t & fun) {
+    if (num_threads == 1) {
+      fun(0);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      task = &fun;
+      tasks_remaining = num_threads - 1;
+      ++task_generation;
+    }
+    start_cv.notify_all();
+    fun(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return tasks_remaining == 0; });
+    task = nullptr;
+  }
+
+  /// Which thread handles index i of a ParallelFor over [0, n)?
+  size_t GetThreadFor(size_t i, size_t n) const {
+    emp_assert(i < n);
+    return ((i + 1) * num_threads - 1) / n;
+  }
+
+  /// Call fun(i, thread_id) for every i in [0, n); thread t handles the t'th
+  /// contiguous block of indices (in increasing order).
+  template<typename FUN>
+  void ParallelFor(size_t n, FUN && fun) {
+    RunOnAll([this, n, &fun](size_t thread_id) {
+      const size_t begin = (n * thread_id) / num_threads;
+      const size_t end = (n * (thread_id + 1)) / num_threads;
+      for (size_t i = begin; i < end; ++i) fun(i, thread_id);
+    });
+  }
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ *  @date 2019
+ *
+ *  @file  WorldSnapshot.h
+ *
+ *  Display-oriented snapshot of a DOLWorld, stored in one contiguous buffer so it
+ *  can be handed between threads (e.g., posted from a web worker to the page as
+ *  a transferable ArrayBuffer) and read back without any parsing.
+ *
+ *  Buffer layout (64-bit words, native byte order):
+ *    Header                               (NUM_HEADER_WORDS words)
+ *    Cell sensors       [deme * capacity + cell]   bit 0 = active, bit 1+r = sensing resource r
+ *    Cell metabolism    [deme * capacity + cell]   bit 0 = active, bit 1+r = metabolizing resource r
+ *    Resource levels    [deme * num_resources + r] (double)
+ *    Deme active flags  [deme]                     (one byte each, padded to a whole word)
+ */
+
+#ifndef _WORLD_SNAPSHOT_H
+#define _WORLD_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "base/vector.h"
+
+#include "DOLWorld.h"
+
+class WorldSnapshot {
+public:
+  static constexpr uint64_t CELL_ACTIVE = 1;   ///< Bit set in a cell word if the cell is active
+
+  struct Header {
+    uint64_t generation=0;            ///< Caller-provided tag (e.g., which configuration produced this snapshot)
+    uint64_t update=0;
+    uint64_t num_orgs=0;
+    uint64_t num_demes=0;             ///< Population positions
+    uint64_t deme_width=0;
+    uint64_t deme_height=0;
+    uint64_t num_resources=0;
+    uint64_t num_static_resources=0;
+  };
+  static constexpr size_t NUM_HEADER_WORDS = sizeof(Header) / sizeof(uint64_t);
+
+protected:
+  Header header;
+  emp::vector<uint64_t> words;   ///< Whole snapshot (header included), see layout above
+
+  size_t GetNumCells() const { return header.num_demes * header.deme_width * header.deme_height; }
+  size_t SensorsOffset() const { return NUM_HEADER_WORDS; }
+  size_t MetabolismOffset() const { return SensorsOffset() + GetNumCells(); }
+  size_t LevelsOffset() const { return MetabolismOffset() + GetNumCells(); }
+  size_t DemeFlagsOffset() const { return LevelsOffset() + header.num_demes * header.num_resources; }
+  size_t CalcNumWords() const { return DemeFlagsOffset() + (header.num_demes + 7) / 8; }
+
+  uint8_t * DemeFlags() { return (uint8_t *)(words.data() + DemeFlagsOffset()); }
+  const uint8_t * DemeFlags() const { return (const uint8_t *)(words.data() + DemeFlagsOffset()); }
+
+public:
+  const Header & GetHeader() const { return header; }
+  bool IsEmpty() const { return words.empty(); }
+
+  /// Raw snapshot bytes (see Load)
+  const uint8_t * GetData() const { return (const uint8_t *)words.data(); }
+  size_t GetNumBytes() const { return words.size() * sizeof(uint64_t); }
+
+  size_t GetGeneration() const { return header.generation; }
+  size_t GetUpdate() const { return header.update; }
+  size_t GetNumOrgs() const { return header.num_orgs; }
+  size_t GetNumDemes() const { return header.num_demes; }
+  size_t GetDemeWidth() const { return header.deme_width; }
+  size_t GetDemeHeight() const { return header.deme_height; }
+  size_t GetDemeCapacity() const { return header.deme_width * header.deme_height; }
+  size_t GetNumResources() const { return header.num_resources; }
+  size_t GetNumStaticResources() const { return header.num_static_resources; }
+
+  /// Does the deme at this position exist and is it active?
+  bool IsDemeActive(size_t deme_id) const { return DemeFlags()[deme_id]; }
+
+  /// Cell's sensor word (bit 0 = active, bit 1+r = sensing resource r)
+  uint64_t GetCellSensors(size_t deme_id, size_t cell_id) const {
+    return words[SensorsOffset() + deme_id * GetDemeCapacity() + cell_id];
+  }
+
+  /// Cell's metabolism word (bit 0 = active, bit 1+r = metabolizing resource r)
+  uint64_t GetCellMetabolism(size_t deme_id, size_t cell_id) const {
+    return words[MetabolismOffset() + deme_id * GetDemeCapacity() + cell_id];
+  }
+
+  /// Amount of resource res_id in the deme's local environment
+  double GetResourceLevel(size_t deme_id, size_t res_id) const {
+    double level;
+    std::memcpy(&level, words.data() + LevelsOffset() + deme_id * header.num_resources + res_id, sizeof(double));
+    return level;
+  }
+
+  /// Capture the world's current state
+  void Capture(DOLWorld & world, uint64_t generation=0);
+
+  /// Load a snapshot from raw bytes (produced by GetData on another snapshot).
+  /// Returns false (and leaves this snapshot unchanged) if the bytes are malformed.
+  bool Load(const uint8_t * bytes, size_t num_bytes);
+};
+
+void WorldSnapshot::Capture(DOLWorld & world, uint64_t generation) {
+  header.generation = generation;
+  header.update = world.GetUpdate();
+  header.num_orgs = world.GetNumOrgs();
+  header.num_demes = world.GetSize();
+  header.deme_width = world.GetDemeWidth();
+  header.deme_height = world.GetDemeHeight();
+  header.num_resources = world.GetNumResources();
+  header.num_static_resources = world.GetNumStaticResources();
+  emp_assert(header.num_resources < 64, "Too many resources to pack into a cell word.");
+  words.assign(CalcNumWords(), 0);
+  std::memcpy(words.data(), &header, sizeof(Header));
+  const size_t capacity = GetDemeCapacity();
+  for (size_t deme_id = 0; deme_id < header.num_demes; ++deme_id) {
+    const DOLWorld::Environment & env = world.GetEnvironment(deme_id);
+    for (size_t res_id = 0; res_id < header.num_resources; ++res_id) {
+      const double level = env.resources[res_id].GetAmount();
+      std::memcpy(words.data() + LevelsOffset() + deme_id * header.num_resources + res_id, &level, sizeof(double));
+    }
+    // Deme hardware is only allocated once a position has been occupied
+    if (!world.HasDeme(deme_id) || !world.GetDeme(deme_id).IsActive()) continue;
+    DemeFlags()[deme_id] = 1;
+    Deme & deme = world.GetDeme(deme_id);
+    for (size_t cell_id = 0; cell_id < capacity; ++cell_id) {
+      const Deme::CellularHardware & cell = deme.GetCell(cell_id);
+      if (!cell.IsActive()) continue;
+      uint64_t sensors = CELL_ACTIVE;
+      uint64_t metabolism = CELL_ACTIVE;
+      for (size_t res_id = 0; res_id < header.num_resources; ++res_id) {
+        if (cell.IsSensingResource(res_id)) sensors |= (uint64_t)2 << res_id;
+        if (cell.HasMetabolized(res_id)) metabolism |= (uint64_t)2 << res_id;
+      }
+      words[SensorsOffset() + deme_id * capacity + cell_id] = sensors;
+      words[MetabolismOffset() + deme_id * capacity + cell_id] = metabolism;
+    }
+  }
+}
+
+bool WorldSnapshot::Load(const uint8_t * bytes, size_t num_bytes) {
+  if (num_bytes < sizeof(Header) || num_bytes % sizeof(uint64_t)) return false;
+  const Header old_header = header;
+  std::memcpy(&header, bytes, sizeof(Header));
+  if (header.num_resources >= 64 || CalcNumWords() * sizeof(uint64_t) != num_bytes) {
+    header = old_header;
+    return false;
+  }
+  words.resize(num_bytes / sizeof(uint64_t));
+  std::memcpy(words.data(), bytes, num_bytes);
+  return true;
+}
+
+#endif
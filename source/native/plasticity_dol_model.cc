@@ -9,6 +9,7 @@
 
 #include "../DOLWorld.h"
 #include "../DOLWorldConfig.h"
+#include "../StatusServer.h"
 
 #include <unordered_map>
 #include "tools/map_utils.h"
@@ -34,5 +35,24 @@ int main(int argc, char* argv[])
   DOLWorld world(rnd);
 
   world.Setup(config);
+
+  // Serve run status (see StatusServer.h), if configured
+  StatusServer status_server(world.GetStatusBoard());
+  if (config.STATUS_PORT()) {
+    if (!status_server.ListenHTTP((uint16_t)config.STATUS_PORT())) {
+      std::cout << "Failed to serve run status on port " << config.STATUS_PORT() << ". Exiting..." << std::endl;
+      exit(-1);
+    }
+    std::cout << "Serving run status on http://127.0.0.1:" << config.STATUS_PORT() << "/" << std::endl;
+  }
+  if (config.STATUS_SOCKET_FPATH() != "") {
+    if (!status_server.ListenUnix(config.STATUS_SOCKET_FPATH())) {
+      std::cout << "Failed to serve run status on " << config.STATUS_SOCKET_FPATH() << ". Exiting..." << std::endl;
+      exit(-1);
+    }
+    std::cout << "Serving run status on " << config.STATUS_SOCKET_FPATH() << std::endl;
+  }
+  status_server.Start();
+
   world.Run();
 }
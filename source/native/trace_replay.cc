@@ -0,0 +1,112 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Rebuild world state from an event trace (see EventTrace.h) without re-simulating.
+//  Usage: trace_replay TRACE_FILE UPDATE [POSITION]
+//  - Prints a summary of the population at the beginning of UPDATE.
+//  - If POSITION is given, prints that deme's cells and every event recorded for
+//    that position during UPDATE (and its resource levels, if UPDATE is a
+//    keyframe update; levels aren't recorded between keyframes).
+
+#include <iostream>
+#include <string>
+
+#include "base/vector.h"
+
+#include "../EventTrace.h"
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0] << " TRACE_FILE UPDATE [POSITION]" << std::endl;
+    return 1;
+  }
+  const std::string trace_fpath(argv[1]);
+  const size_t update = std::stoul(argv[2]);
+  const bool show_pos = argc > 3;
+  const size_t pos = (show_pos) ? std::stoul(argv[3]) : 0;
+
+  EventTraceReader reader;
+  if (!reader.Load(trace_fpath)) return 1;
+  const EventTrace::Header & header = reader.GetHeader();
+  std::cout << "Trace: " << trace_fpath << " (pop size: " << header.pop_size
+            << "; deme: " << header.deme_width << "x" << header.deme_height
+            << "; resources: " << header.num_resources
+            << "; keyframes: " << reader.GetKeyframeIndex().size() << ")" << std::endl;
+
+  EventTrace::State state;
+  if (!reader.Seek(update, state)) {
+    std::cout << "Can't rebuild update " << update << " (no keyframe at or before it, the trace ends before it, or the trace is malformed)." << std::endl;
+    return 1;
+  }
+
+  // Population summary
+  size_t num_orgs = 0;
+  size_t num_active_cells = 0;
+  double total_collected = 0.0;
+  for (const EventTrace::OrgState & org : state.orgs) {
+    if (!org.occupied) continue;
+    ++num_orgs;
+    for (bool active : org.active_cells) num_active_cells += (size_t)active;
+    total_collected += org.total_resources_collected;
+  }
+  std::cout << "Update " << update << ": " << num_orgs << " organisms; " << num_active_cells
+            << " active cells; " << total_collected << " resources collected (by living organisms)" << std::endl;
+
+  if (!show_pos) return 0;
+  if (pos >= state.orgs.size()) {
+    std::cout << "Invalid position (" << pos << ")." << std::endl;
+    return 1;
+  }
+
+  // Deme detail (top row printed first; see Deme.h for cell indexing)
+  const EventTrace::OrgState & org = state.orgs[pos];
+  std::cout << "Position " << pos << ": " << ((org.occupied) ? "occupied" : "empty") << std::endl;
+  if (org.occupied) {
+    for (size_t y = header.deme_height; y-- > 0;) {
+      std::cout << "  ";
+      for (size_t x = 0; x < header.deme_width; ++x) {
+        const size_t cell_id = y * header.deme_width + x;
+        std::cout << ((org.active_cells[cell_id]) ? "#" : ".");
+      }
+      std::cout << std::endl;
+    }
+    for (size_t res_id = 0; res_id < header.num_resources; ++res_id) {
+      std::cout << "  Resource " << res_id << ": " << org.consumption_successes[res_id] << " successes, "
+                << org.consumption_failures[res_id] << " failures" << std::endl;
+    }
+    std::cout << "  Total collected: " << org.total_resources_collected << std::endl;
+    if (state.has_resource_levels) {
+      for (size_t res_id = 0; res_id < header.num_resources; ++res_id) {
+        std::cout << "  Resource " << res_id << " level: " << state.resource_levels[pos * header.num_resources + res_id] << std::endl;
+      }
+    } else {
+      std::cout << "  Resource levels: not recorded (keyframe updates only)" << std::endl;
+    }
+  }
+
+  emp::vector<EventTraceReader::Record> records;
+  reader.GetUpdateRecords(update, records);
+  std::cout << "Events during update " << update << ":" << std::endl;
+  for (const EventTraceReader::Record & record : records) {
+    if (record.pos != pos) continue;
+    std::cout << "  " << EventTraceReader::RecordName(record.type);
+    switch (record.type) {
+      case EventTrace::RecordType::PULSE: std::cout << " resource=" << record.a; break;
+      case EventTrace::RecordType::METABOLIZE:
+        std::cout << " cell=" << record.a << " resource=" << record.b
+                  << ((record.flag) ? " collected=" + std::to_string(record.amount) : " (failed)");
+        break;
+      case EventTrace::RecordType::DIVISION: std::cout << " parent=" << record.a << " offspring=" << record.b; break;
+      case EventTrace::RecordType::MESSAGE: std::cout << " from=" << record.a << " to=" << record.b; break;
+      case EventTrace::RecordType::SENSOR:
+        std::cout << " cell=" << record.a << " resource=" << record.b << ((record.flag) ? " on" : " off");
+        break;
+      case EventTrace::RecordType::BIRTH: std::cout << " seed_cell=" << record.a; break;
+      default: break;
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
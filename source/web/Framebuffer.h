@@ -0,0 +1,156 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+/**
+ *  @file  Framebuffer.h
+ *
+ *  RGBA framebuffer kept in WASM linear memory. Views draw into it with plain
+ *  C++ (no JS calls); Blit hands the whole buffer to a canvas with a single
+ *  putImageData through a typed-array view of the WASM heap (no copy on the
+ *  C++ side).
+ */
+
+#ifndef _FRAMEBUFFER_H
+#define _FRAMEBUFFER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include <emscripten.h>
+
+#include "base/vector.h"
+
+class Framebuffer {
+public:
+  using color_t = uint32_t;   ///< RGBA, one byte per channel (R in the lowest byte; WASM is little-endian)
+
+  static constexpr color_t RGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    return (color_t)r | ((color_t)g << 8) | ((color_t)b << 16) | ((color_t)a << 24);
+  }
+
+  /// Convert a CSS color string to RGBA. Supports '#rrggbb', 'rgb(r,g,b)',
+  /// 'hsl(h,s%,l%)' (as produced by emp::GetHueMap), and the named colors the
+  /// web views use. Unknown colors come back magenta.
+  static color_t ParseColor(const std::string & color);
+
+protected:
+  size_t width=0;
+  size_t height=0;
+  emp::vector<color_t> pixels;   ///< Row-major, width x height
+
+  static color_t HSLToRGBA(double h, double s, double l);
+
+  /// Round [x, x+w) to whole pixels & clip to the buffer. Returns false if empty.
+  bool ClipSpan(double x, double w, size_t limit, size_t & begin, size_t & end) const {
+    const double lo = std::max(std::round(x), 0.0);
+    const double hi = std::min(std::round(x + w), (double)limit);
+    if (hi <= lo) return false;
+    begin = (size_t)lo;
+    end = (size_t)hi;
+    return true;
+  }
+
+public:
+  size_t GetWidth() const { return width; }
+  size_t GetHeight() const { return height; }
+
+  /// Resize the buffer (contents are undefined until the next Clear)
+  void Resize(size_t _width, size_t _height) {
+    width = _width;
+    height = _height;
+    pixels.resize(width * height);
+  }
+
+  void Clear(color_t color) { std::fill(pixels.begin(), pixels.end(), color); }
+
+  /// Fill [x, x+w) x [y, y+h), rounded to whole pixels
+  void FillRect(double x, double y, double w, double h, color_t color) {
+    size_t x0, x1, y0, y1;
+    if (!ClipSpan(x, w, width, x0, x1) || !ClipSpan(y, h, height, y0, y1)) return;
+    for (size_t row = y0; row < y1; ++row) {
+      std::fill(pixels.begin() + row * width + x0, pixels.begin() + row * width + x1, color);
+    }
+  }
+
+  /// Draw a one-pixel outline just inside [x, x+w) x [y, y+h)
+  void StrokeRect(double x, double y, double w, double h, color_t color) {
+    size_t x0, x1, y0, y1;
+    if (!ClipSpan(x, w, width, x0, x1) || !ClipSpan(y, h, height, y0, y1)) return;
+    std::fill(pixels.begin() + y0 * width + x0, pixels.begin() + y0 * width + x1, color);
+    std::fill(pixels.begin() + (y1 - 1) * width + x0, pixels.begin() + (y1 - 1) * width + x1, color);
+    for (size_t row = y0; row < y1; ++row) {
+      pixels[row * width + x0] = color;
+      pixels[row * width + x1 - 1] = color;
+    }
+  }
+
+  /// FillRect + StrokeRect (the equivalent of a canvas Rect with a line color)
+  void Rect(double x, double y, double w, double h, color_t fill, color_t line) {
+    FillRect(x, y, w, h, fill);
+    StrokeRect(x, y, w, h, line);
+  }
+
+  /// Copy the buffer onto the canvas with the given element id (one JS call)
+  void Blit(const std::string & canvas_id) const {
+    if (pixels.empty()) return;
+    EM_ASM({
+      var canvas = document.getElementById(UTF8ToString($0));
+      if (!canvas) return;
+      var data = new Uint8ClampedArray(HEAPU8.buffer, $1, $2 * $3 * 4);
+      canvas.getContext('2d').putImageData(new ImageData(data, $2, $3), 0, 0);
+    }, canvas_id.c_str(), pixels.data(), width, height);
+  }
+};
+
+Framebuffer::color_t Framebuffer::HSLToRGBA(double h, double s, double l) {
+  h = std::fmod(std::fmod(h, 360.0) + 360.0, 360.0) / 360.0;
+  s = std::min(std::max(s, 0.0), 1.0);
+  l = std::min(std::max(l, 0.0), 1.0);
+  auto hue_to_rgb = [](double p, double q, double t) {
+    if (t < 0.0) t += 1.0;
+    if (t > 1.0) t -= 1.0;
+    if (t < 1.0/6.0) return p + (q - p) * 6.0 * t;
+    if (t < 1.0/2.0) return q;
+    if (t < 2.0/3.0) return p + (q - p) * (2.0/3.0 - t) * 6.0;
+    return p;
+  };
+  const double q = (l < 0.5) ? l * (1.0 + s) : l + s - l * s;
+  const double p = 2.0 * l - q;
+  auto to_byte = [](double v) { return (uint8_t)std::round(v * 255.0); };
+  return RGBA(to_byte(hue_to_rgb(p, q, h + 1.0/3.0)),
+              to_byte(hue_to_rgb(p, q, h)),
+              to_byte(hue_to_rgb(p, q, h - 1.0/3.0)));
+}
+
+Framebuffer::color_t Framebuffer::ParseColor(const std::string & color) {
+  if (color == "white") return RGBA(255, 255, 255);
+  if (color == "black") return RGBA(0, 0, 0);
+  if (color == "grey" || color == "gray") return RGBA(128, 128, 128);
+  if (color == "tan") return RGBA(210, 180, 140);
+  if (color.size() == 7 && color[0] == '#') {
+    const unsigned long rgb = std::strtoul(color.c_str() + 1, nullptr, 16);
+    return RGBA((uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb);
+  }
+  // rgb(r,g,b) / hsl(h,s%,l%): pull out the three numbers
+  const bool is_hsl = color.compare(0, 4, "hsl(") == 0;
+  if (is_hsl || color.compare(0, 4, "rgb(") == 0) {
+    double vals[3] = {0.0, 0.0, 0.0};
+    const char * cur = color.c_str() + 4;
+    for (size_t i = 0; i < 3; ++i) {
+      char * next = nullptr;
+      vals[i] = std::strtod(cur, &next);
+      if (next == cur) return RGBA(255, 0, 255);
+      cur = next;
+      while (*cur == '%' || *cur == ',' || *cur == ' ') ++cur;
+    }
+    if (is_hsl) return HSLToRGBA(vals[0], vals[1] / 100.0, vals[2] / 100.0);
+    return RGBA((uint8_t)vals[0], (uint8_t)vals[1], (uint8_t)vals[2]);
+  }
+  return RGBA(255, 0, 255);
+}
+
+#endif
@@ -2,14 +2,18 @@
 //  Copyright (C) Alex Lalejini, 2019.
 //  Released under MIT license; see LICENSE
 
-#include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
 
 #include "web/web.h"
 #include "tools/math.h"
 
-#include "../DOLWorld.h"
 #include "../DOLWorldConfig.h"
+#include "../WorldSnapshot.h"
+#include "Framebuffer.h"
 
 namespace UI = emp::web;
 
@@ -18,6 +22,10 @@ namespace UI = emp::web;
 
 // reminder: source ~/gen_ws/emsdk/emsdk_env.sh
 
+// The simulation runs in a web worker (plasticity_dol_model-worker.cc); this
+// page only configures it, tells it when to run, and renders the latest
+// WorldSnapshot it publishes.
+
 double GetHTMLElementWidthByID(const std::string & id) {
   return EM_ASM_DOUBLE({
       var id = UTF8ToString($0);
@@ -32,7 +40,7 @@ double GetHTMLElementHeightByID(const std::string & id) {
     }, id.c_str());
 }
 
-class DOLWorldWebInterface : public UI::Animate, public DOLWorld {
+class DOLWorldWebInterface : public UI::Animate {
 public:
   static constexpr double DEME_CELL_SIZE=18;
   static constexpr double DEME_MARGIN_SIZE=5;
@@ -72,114 +80,58 @@ protected:
 
   double max_res_level=0;
 
+  uint32_t generation=0;                ///< Configuration the simulation was last given (snapshots are tagged with it)
+  bool use_worker=true;                 ///< Run the world in a web worker? (else in-page, within each frame's budget)
+  emp::Ptr<DOLWorld> local_world=nullptr; ///< In-page world (if not using a worker)
+  bool local_world_setup=false;
+  double frame_budget_ms=12;            ///< Simulation time per slice (in-page: per animation frame)
+
+  double frame_time_ms=0;               ///< Time spent in the last frame (simulation + rendering)
+  double updates_per_sec=0;
+  double rate_window_start_ms=0;        ///< updates_per_sec is measured over windows of RATE_WINDOW_MS
+  size_t rate_window_start_update=0;
+  static constexpr double RATE_WINDOW_MS=500;
+  WorldSnapshot snapshot;               ///< Latest snapshot from the worker (what's displayed)
+  WorldSnapshot incoming_snapshot;
+  emp::vector<uint8_t> snapshot_buffer; ///< Landing spot for snapshot bytes posted by the worker
+
   bool configuration_edit_mode=false;
 
+  // Every view draws into a framebuffer in WASM memory, which is blitted onto
+  // the world canvas with a single JS call per frame. Deme views draw
+  // incrementally: only cells whose render state (active flag + displayed
+  // resource flags) changed since the last frame are redrawn.
+  static constexpr uint64_t CELL_NOT_DRAWN = (uint64_t)-1;
+  enum DemeRenderState : uint8_t { DEME_NOT_DRAWN=0, DEME_DRAWN_EMPTY=1, DEME_DRAWN_ACTIVE=2 };
+
+  Framebuffer framebuffer;
+  Framebuffer::color_t color_white = Framebuffer::ParseColor("white");
+  Framebuffer::color_t color_black = Framebuffer::ParseColor("black");
+  Framebuffer::color_t color_tan = Framebuffer::ParseColor("tan");
+  Framebuffer::color_t color_grey = Framebuffer::ParseColor("grey");
+  emp::vector<Framebuffer::color_t> env_res_rgba_map;   ///< env_res_color_map as RGBA
+
+  bool full_redraw=true;                      ///< Does the next frame need to redraw everything?
+  emp::vector<uint64_t> cell_render_state;    ///< Last drawn state of each cell ([deme_id * deme capacity + cell_id])
+  emp::vector<uint8_t> deme_render_state;     ///< Last drawn state of each deme (DemeRenderState)
+
   canvas_draw_fun_t canvas_draw_fun;
   canvas_draw_fun_t draw_deme_cell_sensors = [this]() {
-    world_display.Clear("white");
-
-    for (size_t deme_id = 0; deme_id < demes.size(); ++deme_id) {
-      Deme & deme = GetDeme(deme_id);
-      // What's this deme's row/column id?
-      const size_t deme_row = deme_id / num_deme_cols;
-      const size_t deme_col = deme_id % num_deme_cols;
-      const double margin = DEME_MARGIN_SIZE/2.0;
-      const double deme_x = (deme_col * deme_width) + margin;
-      const double deme_y = (deme_row * deme_height) + margin;
-      if (deme.IsActive()) {
-        // world_display.Rect(deme_x, deme_y, deme_width - margin, deme_height - margin, "white", "white");
-        // Draw Cells
-        for (size_t cell_id = 0; cell_id < deme.GetCellCapacity(); ++cell_id) {
-          Deme::CellularHardware & cell = deme.GetCell(cell_id);
-          const size_t cell_col = deme.GetCellX(cell_id);
-          const size_t cell_row = deme.GetCellY(cell_id);
-          const double cell_x = deme_x + (cell_col * DEME_CELL_SIZE);
-          const double cell_y = deme_y + (cell_row * DEME_CELL_SIZE);
-          if (deme.IsCellActive(cell_id)) {
-            // Alive cell => tan
-            world_display.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, "tan", "black");
-
-            // Display PERIODIC sensors
-            const size_t num_sensors = NUM_PERIODIC_RESOURCES;
-            if (num_sensors > 0) {
-              const double bar_height = DEME_CELL_SIZE / (double)num_sensors;
-              const double bar_width = DEME_CELL_SIZE;
-              for (size_t sensor_id = NUM_STATIC_RESOURCES; sensor_id < TOTAL_RESOURCES; ++sensor_id) {
-                const size_t offset = sensor_id - NUM_STATIC_RESOURCES;
-                const double sensor_x = cell_x;
-                const double sensor_y = cell_y + (bar_height*offset);
-                // std::cout << cell.resource_sensors[sensor_id] << std::endl;
-                if (cell.resource_sensors[sensor_id]) {
-                  world_display.Rect(sensor_x, sensor_y, bar_width, bar_height, env_res_color_fun(sensor_id), "black");
-                } else {
-                  world_display.Rect(sensor_x, sensor_y, bar_width, bar_height, "tan", "black");
-                }
-              }
-            }
-
-          } else {
-            world_display.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, "grey", "black");
-          }
-        }
-      } else {
-        world_display.Rect(deme_x, deme_y, deme_width-DEME_MARGIN_SIZE, deme_height-DEME_MARGIN_SIZE, "black");
-      }
-    }
+    // Display PERIODIC sensors
+    DrawDemeCellBars(snapshot.GetNumStaticResources(), &WorldSnapshot::GetCellSensors);
   };
 
   canvas_draw_fun_t draw_deme_cell_metabolism = [this]() {
-    world_display.Clear("white");
-
-    for (size_t deme_id = 0; deme_id < demes.size(); ++deme_id) {
-      Deme & deme = GetDeme(deme_id);
-      // What's this deme's row/column id?
-      const size_t deme_row = deme_id / num_deme_cols;
-      const size_t deme_col = deme_id % num_deme_cols;
-      const double margin = DEME_MARGIN_SIZE/2.0;
-      const double deme_x = (deme_col * deme_width) + margin;
-      const double deme_y = (deme_row * deme_height) + margin;
-      if (deme.IsActive()) {
-        // world_display.Rect(deme_x, deme_y, deme_width - margin, deme_height - margin, "white", "white");
-        // Draw Cells
-        for (size_t cell_id = 0; cell_id < deme.GetCellCapacity(); ++cell_id) {
-          Deme::CellularHardware & cell = deme.GetCell(cell_id);
-          const size_t cell_col = deme.GetCellX(cell_id);
-          const size_t cell_row = deme.GetCellY(cell_id);
-          const double cell_x = deme_x + (cell_col * DEME_CELL_SIZE);
-          const double cell_y = deme_y + (cell_row * DEME_CELL_SIZE);
-          if (deme.IsCellActive(cell_id)) {
-            // Alive cell => tan
-            world_display.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, "tan", "black");
-
-            // Display resource consumption
-            if (TOTAL_RESOURCES > 0) {
-              const double bar_height = DEME_CELL_SIZE / (double)TOTAL_RESOURCES;
-              const double bar_width = DEME_CELL_SIZE;
-              for (size_t res_id = 0; res_id < TOTAL_RESOURCES; ++res_id) {
-                const double res_x = cell_x;
-                const double res_y = cell_y + (bar_height*res_id);
-                if (cell.metabolized_on_advance[res_id]) {
-                  world_display.Rect(res_x, res_y, bar_width, bar_height, env_res_color_fun(res_id), "black");
-                } else {
-                  world_display.Rect(res_x, res_y, bar_width, bar_height, "tan", "black");
-                }
-              }
-            }
-          } else {
-            world_display.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, "grey", "black");
-          }
-        }
-      } else {
-        world_display.Rect(deme_x, deme_y, deme_width-DEME_MARGIN_SIZE, deme_height-DEME_MARGIN_SIZE, "black");
-      }
-    }
+    // Display resource consumption
+    DrawDemeCellBars(0, &WorldSnapshot::GetCellMetabolism);
   };
 
   canvas_draw_fun_t draw_env_res_levels = [this]() {
-    world_display.Clear("white");
-    for (size_t env_id = 0; env_id < environments.size(); ++env_id) {
+    if (full_redraw) BeginFullRedraw();
+    framebuffer.Clear(color_white);
+    const size_t num_resources = snapshot.GetNumResources();
+    for (size_t env_id = 0; env_id < snapshot.GetNumDemes(); ++env_id) {
       // todo - inactive environments should not get drawn (just be greyed out)
-      Environment & env = environments[env_id];
       // What row/col is this environment on?
       const size_t env_row = env_id / num_deme_cols;
       const size_t env_col = env_id % num_deme_cols;
@@ -188,18 +140,20 @@ protected:
       const double env_y = (env_row * deme_height) + margin;
       const double env_width = deme_width-DEME_MARGIN_SIZE;
       const double env_height = deme_width-DEME_MARGIN_SIZE;
-      world_display.Rect(env_x, env_y, env_width, env_height, "grey", "grey");
+      framebuffer.Rect(env_x, env_y, env_width, env_height, color_grey, color_grey);
 
       // draw each resource level
-      for (size_t res_id = 0; res_id < env.resources.size(); ++res_id) {
-        Resource res = env.resources[res_id];
-        double res_width = env_width / TOTAL_RESOURCES;
-        double res_height = (res.GetAmount() / max_res_level) * env_height;
+      for (size_t res_id = 0; res_id < num_resources; ++res_id) {
+        double res_width = env_width / num_resources;
+        double res_height = (snapshot.GetResourceLevel(env_id, res_id) / max_res_level) * env_height;
         double res_x = env_x + res_width*res_id;
         double res_y = env_y + (env_height - res_height);
-        world_display.Rect(res_x, res_y, res_width, res_height, env_res_color_fun(res_id), "black");
+        framebuffer.Rect(res_x, res_y, res_width, res_height, env_res_rgba_map[res_id], color_black);
       }
     }
+    // Cell render state no longer matches the framebuffer
+    full_redraw = true;
+    framebuffer.Blit(world_display.GetID());
   };
 
   env_res_color_fun_t env_res_color_fun = [this](size_t env_id) {
@@ -207,6 +161,75 @@ protected:
     return env_res_color_map[env_id];
   };
 
+  /// Size the framebuffer to the canvas, clear it, and forget what was drawn
+  void BeginFullRedraw() {
+    framebuffer.Resize((size_t)(deme_width * num_deme_cols), (size_t)(deme_height * num_deme_rows));
+    framebuffer.Clear(color_white);
+    env_res_rgba_map.resize(env_res_color_map.size());
+    for (size_t i = 0; i < env_res_color_map.size(); ++i) {
+      env_res_rgba_map[i] = Framebuffer::ParseColor(env_res_color_map[i]);
+    }
+    cell_render_state.assign(snapshot.GetNumDemes() * snapshot.GetDemeCapacity(), CELL_NOT_DRAWN);
+    deme_render_state.assign(snapshot.GetNumDemes(), DEME_NOT_DRAWN);
+    full_redraw = false;
+  }
+
+  /// Draw every deme's cells (tan = active, grey = inactive) with one bar per
+  /// resource in [first_res, num resources), colored if that resource's bit is set
+  /// in the cell's snapshot word (get_cell_word: WorldSnapshot::GetCellSensors or
+  /// GetCellMetabolism). Only cells that changed since the last frame are drawn.
+  void DrawDemeCellBars(size_t first_res, uint64_t (WorldSnapshot::* get_cell_word)(size_t, size_t) const) {
+    if (full_redraw) BeginFullRedraw();
+    const size_t capacity = snapshot.GetDemeCapacity();
+    const size_t deme_cell_cols = snapshot.GetDemeWidth();
+    const size_t num_bars = snapshot.GetNumResources() - first_res;
+    const double bar_height = (num_bars) ? DEME_CELL_SIZE / (double)num_bars : 0.0;
+    for (size_t deme_id = 0; deme_id < snapshot.GetNumDemes(); ++deme_id) {
+      // What's this deme's row/column id?
+      const size_t deme_row = deme_id / num_deme_cols;
+      const size_t deme_col = deme_id % num_deme_cols;
+      const double margin = DEME_MARGIN_SIZE/2.0;
+      const double deme_x = (deme_col * deme_width) + margin;
+      const double deme_y = (deme_row * deme_height) + margin;
+      // Deme hardware is only allocated once a position has been occupied
+      if (!snapshot.IsDemeActive(deme_id)) {
+        if (deme_render_state[deme_id] != DEME_DRAWN_EMPTY) {
+          framebuffer.FillRect(deme_x, deme_y, deme_width-DEME_MARGIN_SIZE, deme_height-DEME_MARGIN_SIZE, color_black);
+          deme_render_state[deme_id] = DEME_DRAWN_EMPTY;
+        }
+        continue;
+      }
+      if (deme_render_state[deme_id] != DEME_DRAWN_ACTIVE) {
+        // Deme is newly drawn (or was drawn empty) => all of its cells need drawing
+        std::fill(cell_render_state.begin() + deme_id * capacity,
+                  cell_render_state.begin() + (deme_id + 1) * capacity, CELL_NOT_DRAWN);
+        deme_render_state[deme_id] = DEME_DRAWN_ACTIVE;
+      }
+      for (size_t cell_id = 0; cell_id < capacity; ++cell_id) {
+        // Cell render state: bit 0 = active; bit 1+i = flag of resource first_res+i
+        const uint64_t word = (snapshot.*get_cell_word)(deme_id, cell_id);
+        const bool cell_active = word & WorldSnapshot::CELL_ACTIVE;
+        const uint64_t state = (cell_active) ? (((word >> (first_res + 1)) << 1) | 1) : 0;
+        uint64_t & last_state = cell_render_state[deme_id * capacity + cell_id];
+        if (state == last_state) continue;
+        last_state = state;
+        const double cell_x = deme_x + ((cell_id % deme_cell_cols) * DEME_CELL_SIZE);
+        const double cell_y = deme_y + ((cell_id / deme_cell_cols) * DEME_CELL_SIZE);
+        if (!cell_active) {
+          framebuffer.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, color_grey, color_black);
+          continue;
+        }
+        // Alive cell => tan
+        framebuffer.Rect(cell_x, cell_y, DEME_CELL_SIZE, DEME_CELL_SIZE, color_tan, color_black);
+        for (size_t i = 0; i < num_bars; ++i) {
+          const Framebuffer::color_t color = (state & ((uint64_t)2 << i)) ? env_res_rgba_map[first_res + i] : color_tan;
+          framebuffer.Rect(cell_x, cell_y + (bar_height*i), DEME_CELL_SIZE, bar_height, color, color_black);
+        }
+      }
+    }
+    framebuffer.Blit(world_display.GetID());
+  }
+
   void DisableConfigInputs() {
     for (size_t i = 0; i < config_input_ids.size(); ++i) {
       EM_ASM({
@@ -228,11 +251,11 @@ protected:
   }
 
   void ConfigCanvasSize() {
-    const size_t num_demes = demes.size();
+    const size_t num_demes = snapshot.GetNumDemes();
     double parent_w = GetHTMLElementWidthByID("world-view");
 
-    deme_width = (double)(DEME_WIDTH * DEME_CELL_SIZE) + DEME_MARGIN_SIZE;
-    deme_height = (double)(DEME_HEIGHT * DEME_CELL_SIZE) + DEME_MARGIN_SIZE;
+    deme_width = (double)(snapshot.GetDemeWidth() * DEME_CELL_SIZE) + DEME_MARGIN_SIZE;
+    deme_height = (double)(snapshot.GetDemeHeight() * DEME_CELL_SIZE) + DEME_MARGIN_SIZE;
 
     num_deme_cols = (size_t)emp::Max(std::floor(parent_w/(deme_width)), 1.0);
     emp_assert(num_deme_cols > 0);
@@ -335,6 +358,120 @@ protected:
     });
   }
 
+  /// Start the simulation worker. The worker posts snapshots; only the newest
+  /// is kept (older, unrendered snapshots are simply dropped). Without web
+  /// workers (or with '?no-worker' in the page URL), the world runs in-page.
+  void SetupWorker() {
+    use_worker = EM_ASM_INT({
+      return (typeof Worker !== 'undefined' && window.location.search.indexOf('no-worker') == -1) ? 1 : 0;
+    });
+    if (!use_worker) {
+      local_world = emp::NewPtr<DOLWorld>();
+      return;
+    }
+    emp::JSWrap([this]() { RenderLatestSnapshot(); }, "dol_render_snapshot");
+    EM_ASM({
+      emp.dol_snapshot = null;
+      emp.dol_worker = new Worker('plasticity_dol_model-worker-main.js');
+      emp.dol_worker.onmessage = function(e) {
+        if (e.data.type != 'snapshot') return;
+        emp.dol_snapshot = e.data.snapshot;
+        // Not animating (paused/stepping)? => render now
+        if (!e.data.running) emp.dol_render_snapshot();
+      };
+    });
+  }
+
+  /// Apply the current configuration to the simulation (resets its world)
+  void ConfigureSimulation() {
+    ++generation;
+    ResetRateStats();
+    if (!use_worker) {
+      local_world->GetRandom().ResetSeed(config.SEED());
+      if (local_world_setup) local_world->Reset(config);
+      else local_world->Setup(config);
+      local_world_setup = true;
+      CaptureLocalSnapshot();
+      DrawWorldCanvas();
+      stats_view.Redraw();
+      return;
+    }
+    std::ostringstream config_stream;
+    config.Write(config_stream);
+    EM_ASM({
+      emp.dol_worker.postMessage({type: 'configure', config: UTF8ToString($0), generation: $1});
+    }, config_stream.str().c_str(), generation);
+  }
+
+  /// Send a control message ('run', 'pause', or 'step') to the worker
+  void PostWorkerCommand(const std::string & command) {
+    EM_ASM({ emp.dol_worker.postMessage({type: UTF8ToString($0), budget_ms: $1}); }, command.c_str(), frame_budget_ms);
+  }
+
+  /// Start/stop running the world (in-page worlds run from DoFrame)
+  void SetSimulationRunning(bool run) {
+    ResetRateStats();
+    if (use_worker) PostWorkerCommand(run ? "run" : "pause");
+  }
+
+  /// Run the world for a single update
+  void StepSimulation() {
+    if (use_worker) {
+      PostWorkerCommand("step");
+      return;
+    }
+    local_world->RunStep();
+    CaptureLocalSnapshot();
+    DrawWorldCanvas();
+    stats_view.Redraw();
+  }
+
+  /// Snapshot the in-page world (what gets displayed)
+  void CaptureLocalSnapshot() {
+    incoming_snapshot.Capture(*local_world, generation);
+    AcceptIncomingSnapshot();
+  }
+
+  /// Pull the newest snapshot the worker has posted (if any). Returns true if a
+  /// snapshot of the current configuration was received.
+  bool ReceiveSnapshot() {
+    const size_t num_bytes = EM_ASM_INT({ return (emp.dol_snapshot) ? emp.dol_snapshot.byteLength : 0; });
+    if (!num_bytes) return false;
+    snapshot_buffer.resize(num_bytes);
+    EM_ASM({
+      HEAPU8.set(new Uint8Array(emp.dol_snapshot), $0);
+      emp.dol_snapshot = null;
+    }, snapshot_buffer.data());
+    if (!incoming_snapshot.Load(snapshot_buffer.data(), num_bytes)) return false;
+    return AcceptIncomingSnapshot();
+  }
+
+  /// Make incoming_snapshot the displayed snapshot (unless it's stale). Returns
+  /// true if accepted.
+  bool AcceptIncomingSnapshot() {
+    // Stale? (produced before the last configuration was applied)
+    if (incoming_snapshot.GetGeneration() != generation) return false;
+    const bool reshaped = snapshot.IsEmpty()
+                          || snapshot.GetNumDemes() != incoming_snapshot.GetNumDemes()
+                          || snapshot.GetDemeHeight() != incoming_snapshot.GetDemeHeight()
+                          || snapshot.GetDemeWidth() != incoming_snapshot.GetDemeWidth()
+                          || snapshot.GetNumResources() != incoming_snapshot.GetNumResources();
+    std::swap(snapshot, incoming_snapshot);
+    if (reshaped) {
+      env_res_color_map = emp::GetHueMap(snapshot.GetNumResources(), 0, 250, 85, 50);
+      ConfigCanvasSize();
+      full_redraw = true;
+    }
+    return true;
+  }
+
+  /// Render the newest snapshot from the worker (if there is one)
+  void RenderLatestSnapshot() {
+    if (!ReceiveSnapshot()) return;
+    DrawWorldCanvas();
+    stats_view.Redraw();
+  }
+
 public:
   DOLWorldWebInterface()
     : world_view("world-view"),
@@ -348,21 +485,20 @@ public:
     SetupInterface();
   }
 
+  ~DOLWorldWebInterface() {
+    if (local_world) local_world.Delete();
+  }
+
   void SetupInterface() {
     std::cout << "SetupInterface" << std::endl;
-    // Configure random number seed
-    GetRandom().ResetSeed(config.SEED());
     // todo - allow configuration to be changed
-    // Setup the world based on default config
+    // Setup the world (in the worker) based on default config
     config.MAX_POP_SIZE(100);
     config.INIT_POP_SIZE(10);
-    Setup(config);
+    SetupWorker();
 
     max_res_level = emp::Max(config.PERIODIC_RESOURCES__LEVEL(), config.STATIC_RESOURCES__LEVEL());
 
-    // Setup color maps
-    env_res_color_map = emp::GetHueMap(TOTAL_RESOURCES, 0, 250, 85, 50);
-
     emp::JSWrap([this](std::string val) { return config.Get(val); }, "get_config_val");
 
     // SETUP INTERFACE CONTROL BUTTONS
@@ -370,13 +506,14 @@ public:
     // we want control over the button's callback.
     run_toggle_but = UI::Button([this] () {
       ToggleActive();
+      SetSimulationRunning(active);
       run_toggle_but.SetLabel(active ? "Stop" : "Start");
       active ? run_step_but.SetDisabled(true) : run_step_but.SetDisabled(false);
       active ? configure_but.SetDisabled(true) : configure_but.SetDisabled(false);
     }, "Start", "run-toggle-button");
     run_toggle_but.SetAttr("class", "btn btn-primary m-1");
     // Run-step (run world for a single step) button
-    run_step_but = GetStepButton("run-step-button");
+    run_step_but = UI::Button([this]() { StepSimulation(); }, "Step", "run-step-button");
     run_step_but.SetAttr("class", "btn btn-primary m-1");
     // Configure button
     configure_but = UI::Button([this]() {
@@ -388,12 +525,9 @@ public:
       if (!configuration_edit_mode) {
         // Configure mode => !Configure mode: reset the world!
         // todo - move this stuff to its own function
-        Reset(config);
+        // (with a worker, the view updates once its first snapshot of the new world arrives)
         max_res_level = emp::Max(config.PERIODIC_RESOURCES__LEVEL(), config.STATIC_RESOURCES__LEVEL());
-        env_res_color_map = emp::GetHueMap(TOTAL_RESOURCES, 0, 250, 85, 50);
-        ConfigCanvasSize();
-        RedrawWorldCanvas();
-        stats_view.Redraw();
+        ConfigureSimulation();
       }
       // Enable/disable settings
       configuration_edit_mode ? EnableConfigInputs() : DisableConfigInputs();
@@ -440,13 +574,16 @@ public:
     controls << run_step_but;     // todo - disable step when running
     controls << configure_but;
     controls << world_display_selector;
+    SetupFrameBudgetInput();
 
     // Settings view
     SetupSettingsEditor();
 
     // Stats area
-    stats_view << "Update: " << UI::Live( [this]() { return GetUpdate(); } );
-    stats_view << "<br/>Number of organisms: " << UI::Live( [this]() { return GetNumOrgs(); } );
+    stats_view << "Update: " << UI::Live( [this]() { return snapshot.GetUpdate(); } );
+    stats_view << "<br/>Number of organisms: " << UI::Live( [this]() { return snapshot.GetNumOrgs(); } );
+    stats_view << "<br/>Updates/sec: " << UI::Live( [this]() { return (size_t)std::round(updates_per_sec); } );
+    stats_view << "<br/>Frame time (ms): " << UI::Live( [this]() { return std::round(frame_time_ms * 10.0) / 10.0; } );
 
     // World view area
 
@@ -464,24 +601,74 @@ public:
     // Disable all settings
     DisableConfigInputs();
 
+    // Start the world (needs the canvas & stats views set up if running in-page)
+    ConfigureSimulation();
+
     RedrawWorldCanvas();
     stats_view.Redraw();
   }
 
+  /// With a worker, animation frames only render (the worker runs the world at
+  /// its own pace). In-page, each frame runs as many updates as fit in
+  /// frame_budget_ms (at least one). Either way, the canvas & stats are drawn
+  /// once per frame.
   void DoFrame() {
-    std::cout << "CPU_CYCLES_PER_UPDATE = " << config.CPU_CYCLES_PER_UPDATE() << std::endl;
-    std::cout << "MAX_POP_SIZE = " << config.MAX_POP_SIZE() << std::endl;
-    std::cout << "INIT_POP_SIZE = " << config.INIT_POP_SIZE() << std::endl;
-    RunStep();
-    RedrawWorldCanvas();
+    const double frame_start = emscripten_get_now();
+    if (use_worker) {
+      if (!ReceiveSnapshot()) return;
+    } else {
+      do {
+        local_world->RunStep();
+      } while (emscripten_get_now() - frame_start < frame_budget_ms);
+      CaptureLocalSnapshot();
+    }
+    DrawWorldCanvas();
+    const double now = emscripten_get_now();
+    frame_time_ms = now - frame_start;
+    if (snapshot.GetUpdate() < rate_window_start_update) {
+      ResetRateStats(); // World was reset
+    } else if (now - rate_window_start_ms >= RATE_WINDOW_MS) {
+      updates_per_sec = 1000.0 * (double)(snapshot.GetUpdate() - rate_window_start_update) / (now - rate_window_start_ms);
+      rate_window_start_ms = now;
+      rate_window_start_update = snapshot.GetUpdate();
+    }
     stats_view.Redraw();
   }
 
+  /// Start a fresh updates/sec measurement window
+  void ResetRateStats() {
+    rate_window_start_ms = emscripten_get_now();
+    rate_window_start_update = snapshot.GetUpdate();
+    updates_per_sec = 0;
+  }
 
+  /// Slider for frame_budget_ms (in-page: simulation time per frame; worker: per snapshot)
+  void SetupFrameBudgetInput() {
+    emp::JSWrap([this](double val) { frame_budget_ms = val; if (active) SetSimulationRunning(true); },
+                "dol_set_frame_budget");
+    std::stringstream html;
+    html << "<form oninput=\"frame_budget_output.value=frame_budget_input.value\">"
+         <<   "<label for=\"frame_budget_input\">Frame Budget (ms)</label>"
+         <<   "<input type=\"range\" id=\"frame_budget_input\" class=\"form-control\""
+         <<   " onchange=\"emp.dol_set_frame_budget(this.value);\""
+         <<   " value=\"" << frame_budget_ms << "\" min=\"1\" max=\"100\" step=\"1\">"
+         <<   "<output class=\"badge badge-dark\" for=\"frame_budget_input\" name=\"frame_budget_output\">" << frame_budget_ms << "</output>"
+         << "</form>";
+    controls << html.str();
+  }
+
+
+  /// Redraw the world canvas from scratch (view, canvas size, or world changed)
   void RedrawWorldCanvas() {
-    world_display.Freeze();
+    full_redraw = true;
+    if (snapshot.IsEmpty()) return;
+    canvas_draw_fun();
+  }
+
+  /// Draw the current frame (deme views only redraw what changed)
+  void DrawWorldCanvas() {
+    if (snapshot.IsEmpty()) return;
     canvas_draw_fun();
-    world_display.Activate();
   }
 
 };
@@ -0,0 +1,61 @@
+//  This file is part of example
+//  Copyright (C) Alex Lalejini, 2019.
+//  Released under MIT license; see LICENSE
+
+// Simulation side of the web interface. Built as its own module and run inside
+// a web worker (see web/plasticity_dol_model-worker-main.js), so the world runs
+// as fast as it can, independent of the page's animation frames. The page only
+// renders the latest WorldSnapshot the worker publishes.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <emscripten.h>
+
+#include "../DOLWorld.h"
+#include "../DOLWorldConfig.h"
+#include "../WorldSnapshot.h"
+
+DOLWorldConfig config;
+DOLWorld world;
+WorldSnapshot snapshot;
+uint64_t generation=0;    ///< Which configuration (from the page) the world is running
+
+extern "C" {
+
+/// (Re)configure the world from config file text (as written by DOLWorldConfig::Write).
+/// Snapshots are tagged with _generation so the page can drop stale ones.
+EMSCRIPTEN_KEEPALIVE void worker_configure(const char * config_text, uint32_t _generation) {
+  std::istringstream config_stream(config_text);
+  config.Read(config_stream);
+  world.GetRandom().ResetSeed(config.SEED());
+  static bool world_setup = false;
+  if (world_setup) world.Reset(config);
+  else world.Setup(config);
+  world_setup = true;
+  generation = _generation;
+  snapshot.Capture(world, generation);
+}
+
+/// Run world updates until budget_ms has elapsed or max_steps updates have run
+/// (at least one update), then capture a snapshot. Returns updates run.
+EMSCRIPTEN_KEEPALIVE uint32_t worker_run(double budget_ms, uint32_t max_steps) {
+  const double start = emscripten_get_now();
+  uint32_t steps = 0;
+  do {
+    world.RunStep();
+    ++steps;
+  } while (steps < max_steps && emscripten_get_now() - start < budget_ms);
+  snapshot.Capture(world, generation);
+  return steps;
+}
+
+EMSCRIPTEN_KEEPALIVE const uint8_t * worker_snapshot_data() { return snapshot.GetData(); }
+EMSCRIPTEN_KEEPALIVE uint32_t worker_snapshot_size() { return (uint32_t)snapshot.GetNumBytes(); }
+
+}
+
+int main() {
+
+}
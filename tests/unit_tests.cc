@@ -1,13 +1,24 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include "catch.hpp"
 
+#include "CellBits.h"
+#include "CellSchedule.h"
+#include "DecodedProgram.h"
 #include "Deme.h"
 #include "DOLWorld.h"
 #include "DOLWorldConfig.h"
 #include "DigitalOrganism.h"
+#include "EventTrace.h"
+#include "GenomeIO.h"
+#include "GenomeTextParser.h"
 #include "Mutator.h"
+#include "PhaseTimings.h"
 #include "Utilities.h"
 #include "Resource.h"
+#include "RunStatus.h"
+#include "StatusServer.h"
+#include "WorkerPool.h"
+#include "WorldSnapshot.h"
 
 // Tests
 // - [ ] Test that phenotypes are property reset on birth/placement!
@@ -100,6 +111,20 @@ TEST_CASE ( "Deme - Topology", "[deme]" ) {
   REQUIRE(deme4x4.GetCellX(5) == 1);
   REQUIRE(deme4x4.GetCellY(5) == 1);
   REQUIRE(deme4x4.GetCellID(1,1) == 5);
+
+  // Demes with the same dimensions share one topology
+  Deme other4x4(4, 4, nullptr, nullptr, nullptr);
+  REQUIRE(&other4x4.GetTopology() == &deme4x4.GetTopology());
+  REQUIRE(&deme2x2.GetTopology() != &deme4x4.GetTopology());
+  // Neighbor ids are stored in the narrowest type that fits
+  REQUIRE(deme4x4.GetTopology().GetIDBytes() == 1);
+  REQUIRE(DemeTopology::Get(16, 16)->GetIDBytes() == 1);
+  REQUIRE(DemeTopology::Get(16, 17)->GetIDBytes() == 2);
+  REQUIRE(DemeTopology::Get(256, 256)->GetIDBytes() == 2);
+  REQUIRE(DemeTopology::Get(257, 256)->GetIDBytes() == 4);
+  auto wide = DemeTopology::Get(300, 2);
+  REQUIRE(wide->GetNeighbor(299, Deme::Facing::E) == 0);
+  REQUIRE(wide->GetNeighbor(0, Deme::Facing::SW) == 599);
 }
 
 TEST_CASE ("Deme - Rotation", "[deme]") {
@@ -177,33 +202,172 @@ TEST_CASE ("Deme - Reset", "[deme]") {
   for (size_t i = 0; i < 3*3; ++i) {
     Deme::CellularHardware & cell = deme3x3.GetCell(i);
     REQUIRE(cell.cell_id == i);
-    cell.active = true;
+    cell.SetActive(true);
     cell.repro_tag.SetAll();
-    cell.repro_tag_locked = true;
-    cell.new_born = true;
+    cell.SetReproTagLocked(true);
+    cell.SetNewBorn(true);
     cell.Reset();
-    REQUIRE(!cell.active);
+    REQUIRE(!cell.IsActive());
     REQUIRE(cell.repro_tag.None());
-    REQUIRE(!cell.repro_tag_locked);
-    REQUIRE(!cell.new_born);
+    REQUIRE(!cell.IsReproTagLocked());
+    REQUIRE(!cell.IsNewBorn());
   }
 
   for (size_t i = 0; i < 3*3; ++i) {
     Deme::CellularHardware & cell = deme3x3.GetCell(i);
     REQUIRE(cell.cell_id == i);
-    cell.active = true;
+    cell.SetActive(true);
     cell.repro_tag.SetAll();
-    cell.repro_tag_locked = true;
-    cell.new_born = true;
+    cell.SetReproTagLocked(true);
+    cell.SetNewBorn(true);
   }
   deme3x3.DeactivateDeme();
   for (size_t i = 0; i < 3*3; ++i) {
     Deme::CellularHardware & cell = deme3x3.GetCell(i);
     REQUIRE(cell.cell_id == i);
-    REQUIRE(!cell.active);
+    REQUIRE(!cell.IsActive());
     REQUIRE(cell.repro_tag.None());
-    REQUIRE(!cell.repro_tag_locked);
-    REQUIRE(!cell.new_born);
+    REQUIRE(!cell.IsReproTagLocked());
+    REQUIRE(!cell.IsNewBorn());
+  }
+}
+
+TEST_CASE ("Deme - Cell Scheduling", "[deme][schedule]") {
+  emp::Random rnd(3);
+  const size_t num_cells = 9;
+  const size_t updates = 300;
+  const size_t cycles = 10;
+  auto table = std::make_shared<CellPermutationTable>(rnd, num_cells, 64);
+
+  // Every strategy visits every cell exactly once per cycle
+  for (CellScheduleMode mode : {CellScheduleMode::SHUFFLE, CellScheduleMode::PERMUTATION_TABLE,
+                                CellScheduleMode::ROTATE, CellScheduleMode::FIXED}) {
+    CellScheduler scheduler(&rnd, num_cells);
+    scheduler.SetMode(mode, table);
+    scheduler.BeginUpdate();
+    for (size_t c = 0; c < cycles; ++c) {
+      emp::vector<size_t> visits(num_cells, 0);
+      scheduler.ForEachCell([&visits](size_t id) { ++visits[id]; });
+      for (size_t v : visits) REQUIRE(v == 1);
+    }
+  }
+
+  // Full shuffle: unbiased positions & precedence, cycles independent
+  CellScheduler shuffle(&rnd, num_cells);
+  ScheduleBias bias = MeasureScheduleBias(shuffle, updates, cycles);
+  REQUIRE(bias.position_chi2_per_dof < 1.8);
+  REQUIRE(bias.max_precedence_bias < 0.05);
+  REQUIRE(std::abs(bias.order_repeat_rate - 0.5) < 0.03);
+
+  // Permutation table: biased toward the table's permutations; approaches the
+  // full shuffle as the table grows
+  CellScheduler small_table(&rnd, num_cells);
+  small_table.SetMode(CellScheduleMode::PERMUTATION_TABLE, std::make_shared<CellPermutationTable>(rnd, num_cells, 16));
+  bias = MeasureScheduleBias(small_table, updates, cycles);
+  REQUIRE(bias.position_chi2_per_dof > 20.0);
+  CellScheduler large_table(&rnd, num_cells);
+  large_table.SetMode(CellScheduleMode::PERMUTATION_TABLE, std::make_shared<CellPermutationTable>(rnd, num_cells, 16384));
+  bias = MeasureScheduleBias(large_table, updates, cycles);
+  REQUIRE(bias.position_chi2_per_dof < 2.0);
+  REQUIRE(bias.max_precedence_bias < 0.05);
+  REQUIRE(std::abs(bias.order_repeat_rate - 0.5) < 0.03);
+
+  // Rotation: unbiased positions, but relative order persists across an update's cycles
+  CellScheduler rotate(&rnd, num_cells);
+  rotate.SetMode(CellScheduleMode::ROTATE);
+  bias = MeasureScheduleBias(rotate, updates, cycles);
+  REQUIRE(bias.position_chi2_per_dof < 1.8);
+  REQUIRE(bias.order_repeat_rate > 0.58);
+
+  // Fixed: completely biased
+  CellScheduler fixed(&rnd, num_cells);
+  fixed.SetMode(CellScheduleMode::FIXED);
+  bias = MeasureScheduleBias(fixed, updates, cycles);
+  REQUIRE(bias.max_precedence_bias == Approx(0.5));
+  REQUIRE(bias.order_repeat_rate == Approx(1.0));
+
+  CellScheduleMode mode;
+  REQUIRE(ParseCellScheduleMode("permutation-table", mode));
+  REQUIRE(mode == CellScheduleMode::PERMUTATION_TABLE);
+  REQUIRE(!ParseCellScheduleMode("random", mode));
+
+  // Worlds run under every strategy
+  for (const std::string & mode_str : {"shuffle", "permutation-table", "rotate", "fixed"}) {
+    DOLWorldConfig config;
+    config.SEED(4);
+    config.INIT_POP_SIZE(4);
+    config.MAX_POP_SIZE(10);
+    config.INIT_POP_MODE("random");
+    config.CELL_SCHEDULE_MODE(mode_str);
+    emp::Random world_rnd(config.SEED());
+    DOLWorld world(world_rnd);
+    world.Setup(config);
+    for (size_t u = 0; u < 3; ++u) world.RunStep();
+  }
+}
+
+TEST_CASE ("Deme - Cell-Major Execution", "[deme][execution]") {
+  CellExecutionMode mode;
+  REQUIRE(ParseCellExecutionMode("cell-major", mode));
+  REQUIRE(mode == CellExecutionMode::CELL_MAJOR);
+  REQUIRE(ParseCellExecutionMode("interleaved", mode));
+  REQUIRE(mode == CellExecutionMode::INTERLEAVED);
+  REQUIRE(!ParseCellExecutionMode("batched", mode));
+
+  auto make_config = [](const std::string & mode_str, size_t batch_steps) {
+    DOLWorldConfig config;
+    config.SEED(5);
+    config.INIT_POP_SIZE(6);
+    config.MAX_POP_SIZE(12);
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+    config.DEME_REPRODUCTION_COST(20);
+    config.CELL_EXECUTION_MODE(mode_str);
+    config.CELL_BATCH_STEPS(batch_steps);
+    return config;
+  };
+
+  // One-step batches draw the same schedules as interleaved execution & resolve
+  // metabolism in the same order. The ancestor doesn't message and donates the
+  // step after it expresses, so end-of-cycle crediting changes nothing: runs match.
+  DOLWorldConfig config_interleaved = make_config("interleaved", 1);
+  DOLWorldConfig config_k1 = make_config("cell-major", 1);
+  emp::Random rnd_interleaved(config_interleaved.SEED());
+  emp::Random rnd_k1(config_k1.SEED());
+  DOLWorld world_interleaved(rnd_interleaved);
+  DOLWorld world_k1(rnd_k1);
+  world_interleaved.Setup(config_interleaved);
+  world_k1.Setup(config_k1);
+  for (size_t u = 0; u < 20; ++u) {
+    world_interleaved.RunStep();
+    world_k1.RunStep();
+  }
+  REQUIRE(world_interleaved.GetNumOrgs() == world_k1.GetNumOrgs());
+  for (size_t pos = 0; pos < world_k1.GetSize(); ++pos) {
+    REQUIRE(world_interleaved.IsOccupied(pos) == world_k1.IsOccupied(pos));
+    if (!world_k1.IsOccupied(pos)) continue;
+    const DOLWorld::org_t::Phenotype & phen_interleaved = world_interleaved.GetOrg(pos).GetPhenotype();
+    const DOLWorld::org_t::Phenotype & phen_k1 = world_k1.GetOrg(pos).GetPhenotype();
+    REQUIRE(phen_interleaved.total_resources_collected == Approx(phen_k1.total_resources_collected));
+    REQUIRE(phen_interleaved.resource_pool == Approx(phen_k1.resource_pool));
+    REQUIRE(phen_interleaved.consumption_successes_by_type == phen_k1.consumption_successes_by_type);
+    REQUIRE(phen_interleaved.consumption_failures_by_type == phen_k1.consumption_failures_by_type);
+  }
+
+  // Longer batches (including one batch per update) still resolve every attempt:
+  // each cell attempts each resource at most once per update
+  for (size_t batch_steps : {4, 7, 30}) {
+    DOLWorldConfig config = make_config("cell-major", batch_steps);
+    emp::Random rnd(config.SEED());
+    DOLWorld world(rnd);
+    world.Setup(config);
+    for (size_t u = 0; u < 20; ++u) world.RunStep();
+    REQUIRE(world.GetNumOrgs() > 0);
+    for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+      if (!world.IsOccupied(pos)) continue;
+      const DOLWorld::org_t::Phenotype & phen = world.GetOrg(pos).GetPhenotype();
+      REQUIRE(phen.consumption_successes_by_type[0] + phen.consumption_failures_by_type[0] <= phen.age);
+    }
   }
 }
 
@@ -219,12 +383,68 @@ TEST_CASE ("Deme - CellularHardware", "[deme][cell_hardware]") {
     Deme::CellularHardware & cell = deme3x3.GetCell(i);
     for (size_t j = 0; j < 3*3; ++j) {
       if (j == i) {
-        REQUIRE(cell.resource_sensors[j]);
+        REQUIRE(cell.IsSensingResource(j));
       } else {
-        REQUIRE(!cell.resource_sensors[j]);
+        REQUIRE(!cell.IsSensingResource(j));
       }
     }
   }
+
+  // Cell flags & metabolism trackers live in deme-wide bit rows
+  for (size_t i = 0; i < 3*3; i += 2) {
+    deme3x3.GetCell(i).SetActive(true);
+    deme3x3.GetCell(i).SetMetabolized(i);
+  }
+  deme3x3.GetCell(4).SetNewBorn(true);
+  REQUIRE(deme3x3.GetNumActiveCells() == 5);
+  REQUIRE(deme3x3.IsCellRunnable(2));
+  REQUIRE(!deme3x3.IsCellRunnable(3));
+  REQUIRE(!deme3x3.IsCellRunnable(4));
+  emp::vector<size_t> sensing;
+  deme3x3.ForEachCellSensing(4, [&sensing](size_t id) { sensing.emplace_back(id); });
+  REQUIRE(sensing == emp::vector<size_t>({4}));
+  deme3x3.ForEachCellSensing(3, [&sensing](size_t id) { sensing.emplace_back(id); });
+  REQUIRE(sensing.size() == 1); // Cell 3 is sensing, but isn't active
+  // A new update clears every metabolism tracker & new born flag
+  deme3x3.Advance(0);
+  REQUIRE(deme3x3.IsCellRunnable(4));
+  for (size_t i = 0; i < 3*3; ++i) {
+    for (size_t j = 0; j < 3*3; ++j) REQUIRE(!deme3x3.GetCell(i).HasMetabolized(j));
+  }
+  // Reset clears only that cell's bits
+  deme3x3.GetCell(4).Reset();
+  REQUIRE(!deme3x3.IsCellActive(4));
+  REQUIRE(!deme3x3.GetCell(4).IsSensingResource(4));
+  REQUIRE(deme3x3.IsCellActive(2));
+  REQUIRE(deme3x3.GetCell(2).IsSensingResource(2));
+}
+
+TEST_CASE ("CellBits", "[deme][cell_bits]") {
+  // Rows span several words
+  CellBitRows bits(130, 3);
+  REQUIRE(bits.GetWordsPerRow() == 3);
+  for (size_t cell_id : {0, 63, 64, 129}) bits.Set(1, cell_id);
+  bits.Set(2, 64);
+  REQUIRE(bits.Get(1, 63));
+  REQUIRE(bits.Get(1, 64));
+  REQUIRE(!bits.Get(0, 64));
+  REQUIRE(!bits.Get(1, 65));
+  REQUIRE(bits.CountRow(1) == 4);
+  emp::vector<size_t> set_cells;
+  ForEachSetBit(bits.GetWordsPerRow(), [&bits](size_t w) { return bits.GetRow(1)[w]; },
+                [&set_cells](size_t id) { set_cells.emplace_back(id); });
+  REQUIRE(set_cells == emp::vector<size_t>({0, 63, 64, 129}));
+  bits.ClearCell(64);
+  REQUIRE(!bits.Get(1, 64));
+  REQUIRE(!bits.Get(2, 64));
+  REQUIRE(bits.CountRow(1) == 3);
+  bits.Set(1, 0, false);
+  REQUIRE(bits.CountRow(1) == 2);
+  bits.ClearRow(1);
+  REQUIRE(bits.CountRow(1) == 0);
+  bits.Set(0, 5);
+  bits.ClearAll();
+  REQUIRE(bits.CountRow(0) == 0);
 }
 
 TEST_CASE ( "DOLWorld Setup - Random Population Initialization", "[world][setup][population]" ) {
@@ -292,9 +512,12 @@ TEST_CASE ( "DOLWorld Setup - Deme Hardware Setup", "[world][setup][deme]" ) {
   world.Setup(config);
 
   // Check deme configuration
+  // - Deme hardware should only exist for occupied positions
   REQUIRE(world.GetDemes().size() == config.MAX_POP_SIZE());
   size_t active_cell_cnt = 0;
   for (size_t i = 0; i < config.MAX_POP_SIZE(); ++i) {
+    REQUIRE(world.HasDeme(i) == world.IsOccupied(i));
+    if (!world.HasDeme(i)) continue;
     deme_t & deme = world.GetDeme(i);
     REQUIRE(deme.GetDemeID() == i); // Deme IDs should match up with population IDs
     // Check cellular hardware configuration
@@ -305,7 +528,7 @@ TEST_CASE ( "DOLWorld Setup - Deme Hardware Setup", "[world][setup][deme]" ) {
       REQUIRE(cell.sgp_hw.GetMinBindThresh() == config.SGP_MIN_TAG_MATCH_THRESHOLD());
       REQUIRE(cell.sgp_hw.IsStochasticFunCall() == false);
       REQUIRE(cell.cell_id == k);
-      if (cell.active) {
+      if (cell.IsActive()) {
         ++active_cell_cnt;
         REQUIRE(cell.sgp_hw.GetProgram().GetSize() > 0);
         REQUIRE(cell.sgp_hw.GetProgram().GetInstCnt() > 0);
@@ -315,6 +538,318 @@ TEST_CASE ( "DOLWorld Setup - Deme Hardware Setup", "[world][setup][deme]" ) {
   REQUIRE(active_cell_cnt == config.INIT_POP_SIZE());
 }
 
+TEST_CASE ( "DOLWorld - Deme Hardware Recycling", "[world][deme]" ) {
+  // Create a configuration object
+  DOLWorldConfig config;
+  config.SEED(2);
+  config.INIT_POP_SIZE(4);
+  config.MAX_POP_SIZE(20);
+  config.INIT_POP_MODE("random");
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  REQUIRE(world.GetDemePoolSize() == 0);
+
+  // Killing an organism should deactivate its deme & return it to the pool
+  emp::Ptr<Deme> released = world.GetDemes()[0];
+  const auto genome = world.GetGenomeAt(0);
+  world.RemoveOrgAt(0);
+  REQUIRE(!world.HasDeme(0));
+  REQUIRE(world.GetDemePoolSize() == 1);
+  REQUIRE(!released->IsActive());
+  // - Cell hardware keeps its program buffers across deactivation
+  REQUIRE(released->GetCell(released->GetCellCapacity()/2).sgp_hw.GetProgram().GetSize() > 0);
+
+  // Placing an organism should pull hardware from the pool
+  world.InjectAt(genome, 10);
+  REQUIRE(world.GetDemePoolSize() == 0);
+  REQUIRE(world.HasDeme(10));
+  REQUIRE(world.GetDemes()[10] == released);
+  REQUIRE(world.GetDeme(10).GetDemeID() == 10);
+  REQUIRE(world.GetDeme(10).IsActive());
+  size_t active_cell_cnt = 0;
+  for (size_t k = 0; k < world.GetDeme(10).GetCellCapacity(); ++k) {
+    const Deme::CellularHardware & cell = world.GetDeme(10).GetCell(k);
+    REQUIRE(cell.GetDemeID() == 10);
+    if (cell.IsActive()) ++active_cell_cnt;
+  }
+  REQUIRE(active_cell_cnt == 1);
+  world.RunStep();
+}
+
+TEST_CASE ( "DOLWorld - Memory Report", "[world][memory]" ) {
+  const std::string report_fpath = "test_memory.csv";
+  DOLWorldConfig config;
+  config.SEED(2);
+  config.INIT_POP_SIZE(4);
+  config.MAX_POP_SIZE(20);
+  config.INIT_POP_MODE("random");
+  config.MEMORY_REPORT_INTERVAL(2);
+  config.MEMORY_REPORT_FPATH(report_fpath);
+  config.MEMORY_REPORT_PER_DEME(true);
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  world.RemoveOrgAt(1); // Put some hardware in the deme pool
+
+  MemoryReport report;
+  world.MeasureMemory(report);
+  REQUIRE(report.demes.size() == world.GetSize());
+  MemoryUsage deme_sum;
+  for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+    const MemoryUsage & usage = report.demes[pos];
+    deme_sum += usage;
+    REQUIRE(usage.environments > 0);
+    REQUIRE(usage.deme_pool == 0);
+    REQUIRE(usage.birth_chamber == 0);
+    if (!world.IsOccupied(pos)) {
+      REQUIRE(usage.genomes == 0);
+      REQUIRE(usage.cell_programs == 0);
+      continue;
+    }
+    REQUIRE(usage.genomes > 0);
+    REQUIRE(usage.phenotypes > 0);
+    REQUIRE(usage.cell_programs > 0);
+    REQUIRE(usage.sgp_cores > 0);
+    REQUIRE(usage.neighbor_tables == 0); // Shared (counted in totals)
+  }
+  REQUIRE(report.totals.deme_pool > 0);
+  REQUIRE(report.totals.neighbor_tables == world.GetDemeCapacity() * Deme::NUM_DIRECTIONS * sizeof(uint8_t));
+  REQUIRE(report.totals.GetTotal() == deme_sum.GetTotal() + report.totals.deme_pool
+                                      + report.totals.birth_chamber + report.totals.neighbor_tables);
+
+  // Sampled every MEMORY_REPORT_INTERVAL updates (updates 0 & 2): totals + one row per occupied deme
+  for (size_t u = 0; u < 4; ++u) world.RunStep();
+  world.CloseMemoryReport();
+  std::ifstream report_file(report_fpath);
+  std::string line;
+  std::getline(report_file, line);
+  REQUIRE(line.find("update,deme,genomes,") == 0);
+  size_t total_rows = 0;
+  size_t deme_rows = 0;
+  while (std::getline(report_file, line)) {
+    if (line.find(",all,") != std::string::npos) ++total_rows;
+    else ++deme_rows;
+  }
+  REQUIRE(total_rows == 2);
+  REQUIRE(deme_rows >= 2 * 3);
+  std::remove(report_fpath.c_str());
+}
+
+TEST_CASE ( "DOLWorld - Run Status", "[world][status]" ) {
+  const std::string socket_fpath = "test_status.sock";
+  DOLWorldConfig config;
+  config.SEED(4);
+  config.INIT_POP_SIZE(6);
+  config.MAX_POP_SIZE(20);
+  config.INIT_POP_MODE("random");
+  config.STATUS_SOCKET_FPATH(socket_fpath);
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  RunStatus status;
+  REQUIRE(!world.GetStatusBoard().Read(status)); // Nothing published before the first update
+
+  for (size_t u = 0; u < 5; ++u) world.RunStep();
+  REQUIRE(world.GetStatusBoard().Read(status));
+  REQUIRE(status.update == 5);
+  REQUIRE(status.num_orgs == world.GetNumOrgs());
+  REQUIRE(status.max_pop_size == 20);
+  REQUIRE(status.num_resources == world.GetNumResources());
+  REQUIRE(status.updates_per_sec > 0.0);
+  for (size_t phase = 0; phase < RunStatus::NUM_PHASES; ++phase) REQUIRE(status.phase_ms[phase] >= 0.0);
+  // Consumption aggregates = sums over the living population
+  for (size_t res_id = 0; res_id < status.num_resources; ++res_id) {
+    size_t successes = 0;
+    size_t failures = 0;
+    for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+      if (!world.IsOccupied(pos)) continue;
+      successes += world.GetOrg(pos).GetPhenotype().consumption_successes_by_type[res_id];
+      failures += world.GetOrg(pos).GetPhenotype().consumption_failures_by_type[res_id];
+    }
+    REQUIRE(status.consumption_successes[res_id] == successes);
+    REQUIRE(status.consumption_failures[res_id] == failures);
+  }
+
+  // Readers always see a whole status, even while the simulation keeps publishing
+  StatusBoard board;
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    RunStatus published;
+    for (size_t u = 1; u <= 20000; ++u) {
+      published.update = u;
+      published.num_orgs = u;
+      published.num_resources = u % RunStatus::MAX_RESOURCES;
+      board.Publish(published);
+    }
+    done = true;
+  });
+  size_t last_update = 0;
+  while (!done) {
+    RunStatus read;
+    if (!board.Read(read)) continue;
+    REQUIRE(read.num_orgs == read.update);
+    REQUIRE(read.num_resources == read.update % RunStatus::MAX_RESOURCES);
+    REQUIRE(read.update >= last_update);
+    last_update = read.update;
+  }
+  writer.join();
+
+  // Served as JSON on the Unix socket
+  StatusServer server(world.GetStatusBoard());
+  REQUIRE(server.ListenUnix(socket_fpath));
+  server.Start();
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socket_fpath.c_str(), sizeof(addr.sun_path) - 1);
+  REQUIRE(connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0);
+  std::string reply;
+  char buffer[512];
+  ssize_t n;
+  while ((n = read(fd, buffer, sizeof(buffer))) > 0) reply.append(buffer, (size_t)n);
+  close(fd);
+  server.Stop();
+  REQUIRE(reply.find("{\"update\": 5, ") == 0);
+  REQUIRE(reply.find("\"phase_ms\": {\"trace\": ") != std::string::npos);
+  REQUIRE(reply.find("\"phase_total_ms\": {\"trace\": ") != std::string::npos);
+  REQUIRE(reply.find("\"resident_bytes\": ") != std::string::npos);
+  REQUIRE(std::ifstream(socket_fpath).fail()); // Socket file removed on Stop
+}
+
+TEST_CASE ( "DOLWorld - Phase Timings", "[world][status]" ) {
+  auto make_config = [](bool timing, bool per_deme) {
+    DOLWorldConfig config;
+    config.SEED(6);
+    config.INIT_POP_SIZE(6);
+    config.MAX_POP_SIZE(12);
+    config.INIT_POP_MODE("random");
+    config.NUM_THREADS(2);
+    config.PHASE_TIMING(timing);
+    config.PHASE_TIMING_PER_DEME(per_deme);
+    return config;
+  };
+
+  // Cumulative totals add up every update's phase times
+  DOLWorldConfig config = make_config(true, true);
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  const PhaseTimings & timings = world.GetPhaseTimings();
+  REQUIRE(timings.IsEnabled());
+  REQUIRE(timings.IsTimingDemes());
+  double phase_sums[RunStatus::NUM_PHASES] = {};
+  for (size_t u = 0; u < 5; ++u) {
+    world.RunStep();
+    for (size_t phase = 0; phase < RunStatus::NUM_PHASES; ++phase) {
+      REQUIRE(timings.GetUpdateMS(phase) >= 0.0);
+      phase_sums[phase] += timings.GetUpdateMS(phase);
+    }
+    // Per-deme timing: the slowest deme (busiest thread) takes at least the mean
+    REQUIRE(timings.GetDemeBalance().mean_ms > 0.0);
+    REQUIRE(timings.GetDemeBalance().max_ms >= timings.GetDemeBalance().mean_ms);
+    REQUIRE(timings.GetThreadBalance().max_ms >= timings.GetThreadBalance().mean_ms);
+  }
+  REQUIRE(timings.GetNumUpdates() == 5);
+  for (size_t phase = 0; phase < RunStatus::NUM_PHASES; ++phase) {
+    REQUIRE(timings.GetTotalMS(phase) == Approx(phase_sums[phase]));
+  }
+  REQUIRE(timings.GetTotalMS(RunStatus::DEMES) > 0.0);
+  REQUIRE(timings.GetTotalDemeBalance().GetImbalance() >= 1.0);
+  std::ostringstream summary;
+  timings.WriteSummary(summary);
+  REQUIRE(summary.str().find("world_update") != std::string::npos);
+  REQUIRE(summary.str().find("deme imbalance") != std::string::npos);
+
+  // Off (and not publishing status) => nothing is timed
+  DOLWorldConfig config_off = make_config(false, false);
+  emp::Random rnd_off(config_off.SEED());
+  DOLWorld world_off(rnd_off);
+  world_off.Setup(config_off);
+  world_off.RunStep();
+  REQUIRE(!world_off.GetPhaseTimings().IsEnabled());
+  REQUIRE(world_off.GetPhaseTimings().GetNumUpdates() == 0);
+
+  // Per-update timing lines are only printed on request
+  auto run_logged = [&make_config](bool per_update) {
+    DOLWorldConfig config_log = make_config(true, false);
+    config_log.PHASE_TIMING_PER_UPDATE(per_update);
+    emp::Random rnd_log(config_log.SEED());
+    DOLWorld world_log(rnd_log);
+    world_log.Setup(config_log);
+    std::ostringstream log;
+    std::streambuf * cout_buf = std::cout.rdbuf(log.rdbuf());
+    for (size_t u = 0; u < 3; ++u) world_log.RunStep();
+    std::cout.rdbuf(cout_buf);
+    REQUIRE(world_log.GetPhaseTimings().GetNumUpdates() == 3);
+    return log.str();
+  };
+  REQUIRE(!DOLWorldConfig().PHASE_TIMING_PER_UPDATE());
+  REQUIRE(run_logged(false).find("phase ms:") == std::string::npos);
+  REQUIRE(run_logged(true).find("phase ms:") != std::string::npos);
+}
+
+TEST_CASE ( "WorldSnapshot", "[world][snapshot]" ) {
+  DOLWorldConfig config;
+  config.SEED(3);
+  config.INIT_POP_SIZE(5);
+  config.MAX_POP_SIZE(12);
+  config.INIT_POP_MODE("random");
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  for (size_t u = 0; u < 3; ++u) world.RunStep();
+
+  WorldSnapshot snapshot;
+  REQUIRE(snapshot.IsEmpty());
+  snapshot.Capture(world, 7);
+  REQUIRE(snapshot.GetGeneration() == 7);
+  REQUIRE(snapshot.GetUpdate() == world.GetUpdate());
+  REQUIRE(snapshot.GetNumOrgs() == world.GetNumOrgs());
+  REQUIRE(snapshot.GetNumDemes() == world.GetSize());
+  REQUIRE(snapshot.GetDemeCapacity() == world.GetDemeCapacity());
+  REQUIRE(snapshot.GetNumResources() == world.GetNumResources());
+
+  // Round trip through raw bytes
+  WorldSnapshot loaded;
+  REQUIRE(loaded.Load(snapshot.GetData(), snapshot.GetNumBytes()));
+  REQUIRE(loaded.GetNumBytes() == snapshot.GetNumBytes());
+  for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+    const bool deme_active = world.HasDeme(pos) && world.GetDeme(pos).IsActive();
+    REQUIRE(loaded.IsDemeActive(pos) == deme_active);
+    for (size_t res_id = 0; res_id < world.GetNumResources(); ++res_id) {
+      REQUIRE(loaded.GetResourceLevel(pos, res_id) == world.GetEnvironment(pos).resources[res_id].GetAmount());
+    }
+    for (size_t cell_id = 0; cell_id < world.GetDemeCapacity(); ++cell_id) {
+      const uint64_t sensors = loaded.GetCellSensors(pos, cell_id);
+      const uint64_t metabolism = loaded.GetCellMetabolism(pos, cell_id);
+      if (!deme_active || !world.GetDeme(pos).IsCellActive(cell_id)) {
+        REQUIRE(sensors == 0);
+        REQUIRE(metabolism == 0);
+        continue;
+      }
+      const Deme::CellularHardware & cell = world.GetDeme(pos).GetCell(cell_id);
+      REQUIRE((sensors & WorldSnapshot::CELL_ACTIVE));
+      REQUIRE((metabolism & WorldSnapshot::CELL_ACTIVE));
+      for (size_t res_id = 0; res_id < world.GetNumResources(); ++res_id) {
+        REQUIRE((bool)(sensors & ((uint64_t)2 << res_id)) == cell.IsSensingResource(res_id));
+        REQUIRE((bool)(metabolism & ((uint64_t)2 << res_id)) == cell.HasMetabolized(res_id));
+      }
+    }
+  }
+
+  // Malformed bytes are rejected (snapshot unchanged)
+  REQUIRE(!loaded.Load(snapshot.GetData(), snapshot.GetNumBytes() - sizeof(uint64_t)));
+  REQUIRE(!loaded.Load(snapshot.GetData(), 3));
+  REQUIRE(loaded.GetNumBytes() == snapshot.GetNumBytes());
+  REQUIRE(loaded.GetGeneration() == 7);
+}
+
 TEST_CASE ( "DOLWorld Run - Default Settings", "[world][run]" ) {
   // Create a configuration object
   DOLWorldConfig config;
@@ -328,6 +863,411 @@ TEST_CASE ( "DOLWorld Run - Default Settings", "[world][run]" ) {
   REQUIRE(world.GetUpdate() == config.UPDATES()+1);
 }
 
+TEST_CASE ( "EventTrace", "[trace]" ) {
+  // Varint/zigzag encoding round trip
+  EventTrace::Buffer buffer;
+  const emp::vector<uint64_t> values = {0, 1, 127, 128, 300, 16384, (uint64_t)-1};
+  const emp::vector<int64_t> signed_values = {0, -1, 1, -64, 64, -100000};
+  for (uint64_t v : values) buffer.PutVarint(v);
+  for (int64_t v : signed_values) buffer.PutZigzag(v);
+  buffer.PutDouble(2.5);
+  REQUIRE(buffer.GetSize() < values.size() * 8 + signed_values.size() * 8);
+  EventTrace::Cursor cursor{buffer.bytes.data(), buffer.bytes.size(), 0};
+  for (uint64_t v : values) REQUIRE(cursor.GetVarint() == v);
+  for (int64_t v : signed_values) REQUIRE(cursor.GetZigzag() == v);
+  REQUIRE(cursor.GetDouble() == 2.5);
+  REQUIRE(cursor.AtEnd());
+
+  // Record a run, then rebuild state from the trace
+  const std::string trace_fpath = "test_trace.dol";
+  DOLWorldConfig config;
+  config.SEED(5);
+  config.INIT_POP_SIZE(4);
+  config.MAX_POP_SIZE(10);
+  config.INIT_POP_MODE("load-single");
+  config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+  config.DEME_REPRODUCTION_COST(20);
+  config.TRACE_EVENTS(true);
+  config.TRACE_FPATH(trace_fpath);
+  config.TRACE_KEYFRAME_INTERVAL(5);
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  REQUIRE(world.IsTracing());
+  EventTrace::State state_at_8;
+  EventTrace::State state_at_10;
+  EventTrace::State state_at_12;
+  for (size_t u = 0; u < 12; ++u) {
+    if (u == 8) world.CaptureTraceState(state_at_8);
+    if (u == 10) world.CaptureTraceState(state_at_10);
+    world.RunStep();
+  }
+  world.CaptureTraceState(state_at_12);
+  world.CloseTrace();
+  REQUIRE(!world.IsTracing());
+
+  EventTraceReader reader;
+  REQUIRE(reader.Load(trace_fpath));
+  REQUIRE(reader.GetHeader().pop_size == 10);
+  REQUIRE(reader.GetHeader().num_resources == world.GetEnvironment(0).resources.size());
+  REQUIRE(reader.GetKeyframeIndex().size() == 3); // Updates 0, 5, 10
+
+  EventTrace::State replayed;
+  REQUIRE(reader.Seek(8, replayed));
+  REQUIRE(replayed.orgs.size() == state_at_8.orgs.size());
+  for (size_t pos = 0; pos < replayed.orgs.size(); ++pos) REQUIRE(replayed.orgs[pos] == state_at_8.orgs[pos]);
+  REQUIRE(!replayed.has_resource_levels);
+  REQUIRE(reader.Seek(12, replayed));
+  for (size_t pos = 0; pos < replayed.orgs.size(); ++pos) REQUIRE(replayed.orgs[pos] == state_at_12.orgs[pos]);
+  // Can't seek past the end of the trace (updates 0-11 were recorded)
+  REQUIRE(!reader.Seek(13, replayed));
+
+  // Resource levels are only known at keyframe updates
+  REQUIRE(!reader.Seek(8, replayed, true));
+  REQUIRE(reader.Seek(10, replayed, true));
+  REQUIRE(replayed.has_resource_levels);
+  REQUIRE(replayed.resource_levels == state_at_10.resource_levels);
+
+  // Organisms in the ancestor file metabolize every update
+  emp::vector<EventTraceReader::Record> records;
+  REQUIRE(reader.GetUpdateRecords(3, records));
+  size_t metabolize_cnt = 0;
+  for (const auto & record : records) metabolize_cnt += (size_t)(record.type == EventTrace::RecordType::METABOLIZE);
+  REQUIRE(metabolize_cnt > 0);
+  std::remove(trace_fpath.c_str());
+
+  // Records that don't fit the header (position, cell, or resource) fail the read
+  EventTrace::Header header;
+  header.pop_size = 4;
+  header.deme_width = 2;
+  header.deme_height = 2;
+  header.num_resources = 2;
+  header.keyframe_interval = 100;
+  auto write_trace = [&header, &trace_fpath](const std::function<void(EventTrace::Lane &)> & add_records) {
+    EventTrace trace(header);
+    EventTrace::State state;
+    state.Reset(header);
+    REQUIRE(trace.Open(trace_fpath));
+    trace.BeginUpdate(0);
+    trace.WriteKeyframe(state);
+    trace.GetLane(0).Birth(1, 3);
+    trace.EndUpdate();
+    trace.BeginUpdate(1);
+    add_records(trace.GetLane(0));
+    trace.Close();
+  };
+  const emp::vector<std::function<void(EventTrace::Lane &)>> bad_records = {
+    [](EventTrace::Lane & lane) { lane.Death(4); },
+    [](EventTrace::Lane & lane) { lane.Birth(2, 4); },
+    [](EventTrace::Lane & lane) { lane.Division(1, 3, 4); },
+    [](EventTrace::Lane & lane) { lane.Sensor(1, 0, 2, true); },
+    [](EventTrace::Lane & lane) { lane.Metabolize(1, 0, 2, true, 1.0); },
+    [](EventTrace::Lane & lane) { lane.Pulse(1, 2); }
+  };
+  write_trace([](EventTrace::Lane & lane) { lane.Division(1, 3, 0); lane.Sensor(1, 0, 1, true); });
+  REQUIRE(reader.Load(trace_fpath));
+  REQUIRE(reader.Seek(2, replayed));
+  REQUIRE(replayed.orgs[1].active_cells[0]);
+  REQUIRE(replayed.orgs[1].sensors[1]);
+  REQUIRE(!reader.Seek(3, replayed));
+  for (const auto & add_records : bad_records) {
+    write_trace(add_records);
+    REQUIRE(reader.Load(trace_fpath));
+    REQUIRE(!reader.Seek(2, replayed));
+    REQUIRE(!reader.GetUpdateRecords(1, records));
+  }
+  std::remove(trace_fpath.c_str());
+}
+
+TEST_CASE ( "DOLWorld - Parallel Demes", "[world][threads]" ) {
+  // Same seed, different thread counts => identical runs (and replayable traces)
+  auto run_world = [](size_t num_threads, EventTrace::State & final_state, const std::string & trace_fpath) {
+    DOLWorldConfig config;
+    config.SEED(11);
+    config.INIT_POP_SIZE(6);
+    config.MAX_POP_SIZE(12);
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+    config.DEME_REPRODUCTION_COST(20);
+    config.NUM_THREADS(num_threads);
+    config.TRACE_EVENTS(true);
+    config.TRACE_FPATH(trace_fpath);
+    config.TRACE_KEYFRAME_INTERVAL(100);
+    emp::Random rnd(config.SEED());
+    DOLWorld world(rnd);
+    world.Setup(config);
+    for (size_t u = 0; u < 15; ++u) world.RunStep();
+    world.CaptureTraceState(final_state);
+    world.CloseTrace();
+    return world.GetNumOrgs();
+  };
+  EventTrace::State state2, state3;
+  const size_t num_orgs2 = run_world(2, state2, "test_trace_threads2.dol");
+  const size_t num_orgs3 = run_world(3, state3, "test_trace_threads3.dol");
+  REQUIRE(num_orgs2 == num_orgs3);
+  REQUIRE(state2.orgs.size() == state3.orgs.size());
+  for (size_t pos = 0; pos < state2.orgs.size(); ++pos) REQUIRE(state2.orgs[pos] == state3.orgs[pos]);
+
+  // Per-thread trace lanes replay to the same state (only keyframe is update 0)
+  EventTraceReader reader;
+  REQUIRE(reader.Load("test_trace_threads3.dol"));
+  EventTrace::State replayed;
+  REQUIRE(reader.Seek(15, replayed));
+  for (size_t pos = 0; pos < replayed.orgs.size(); ++pos) REQUIRE(replayed.orgs[pos] == state3.orgs[pos]);
+  std::remove("test_trace_threads2.dol");
+  std::remove("test_trace_threads3.dol");
+
+  // Pool splits work into contiguous blocks (one per thread), each index visited once
+  WorkerPool pool(4);
+  emp::vector<size_t> owner(103, 1000);
+  pool.ParallelFor(owner.size(), [&owner](size_t i, size_t thread_id) { owner[i] = thread_id; });
+  for (size_t i = 0; i < owner.size(); ++i) {
+    REQUIRE(owner[i] < pool.GetNumThreads());
+    REQUIRE(pool.GetThreadFor(i, owner.size()) == owner[i]);
+    if (i) REQUIRE(owner[i] >= owner[i-1]);
+  }
+
+  // Worlds record to their own trace lanes: interleaved worlds (with different
+  // thread counts) still replay to their own final states
+  auto setup_world = [](DOLWorld & world, size_t num_threads, const std::string & trace_fpath) {
+    DOLWorldConfig config;
+    config.SEED(11);
+    config.INIT_POP_SIZE(6);
+    config.MAX_POP_SIZE(12);
+    config.INIT_POP_MODE("load-single");
+    config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+    config.DEME_REPRODUCTION_COST(20);
+    config.NUM_THREADS(num_threads);
+    config.TRACE_EVENTS(true);
+    config.TRACE_FPATH(trace_fpath);
+    config.TRACE_KEYFRAME_INTERVAL(100);
+    world.Setup(config);
+  };
+  emp::Random rnd_a(11);
+  emp::Random rnd_b(11);
+  DOLWorld world_a(rnd_a);
+  DOLWorld world_b(rnd_b);
+  setup_world(world_a, 3, "test_trace_world_a.dol");
+  setup_world(world_b, 1, "test_trace_world_b.dol");
+  for (size_t u = 0; u < 10; ++u) {
+    world_a.RunStep();
+    world_b.RunStep();
+  }
+  EventTrace::State final_a, final_b;
+  world_a.CaptureTraceState(final_a);
+  world_b.CaptureTraceState(final_b);
+  world_a.CloseTrace();
+  world_b.CloseTrace();
+  REQUIRE(reader.Load("test_trace_world_a.dol"));
+  REQUIRE(reader.Seek(10, replayed));
+  for (size_t pos = 0; pos < replayed.orgs.size(); ++pos) REQUIRE(replayed.orgs[pos] == final_a.orgs[pos]);
+  REQUIRE(reader.Load("test_trace_world_b.dol"));
+  REQUIRE(reader.Seek(10, replayed));
+  for (size_t pos = 0; pos < replayed.orgs.size(); ++pos) REQUIRE(replayed.orgs[pos] == final_b.orgs[pos]);
+  std::remove("test_trace_world_a.dol");
+  std::remove("test_trace_world_b.dol");
+}
+
+TEST_CASE ( "DOLWorld - Parallel Births", "[world][threads]" ) {
+  // Every organism reproduces every update (births overwrite parents that haven't
+  // reproduced yet); offspring are identical whatever the thread count (including
+  // serial runs), and every birth fires DoBirth's signals in DoBirth's order
+  auto make_config = [](size_t num_threads) {
+    DOLWorldConfig config;
+    config.SEED(12);
+    config.INIT_POP_SIZE(10);
+    config.MAX_POP_SIZE(16);
+    config.INIT_POP_MODE("random");
+    config.DEME_REPRODUCTION_COST(0);
+    config.PROGRAM_INST_SUB__PER_INST(0.05);
+    config.BIRTH_TAG_BIT_FLIP__PER_BIT(0.05);
+    config.NUM_THREADS(num_threads);
+    return config;
+  };
+  const emp::vector<size_t> thread_counts = {1, 2, 4};
+  emp::vector<DOLWorldConfig> configs;
+  emp::vector<emp::Ptr<emp::Random>> rnds;
+  emp::vector<emp::Ptr<DOLWorld>> worlds;
+  emp::vector<std::string> signal_logs(thread_counts.size());
+  for (size_t i = 0; i < thread_counts.size(); ++i) {
+    configs.emplace_back(make_config(thread_counts[i]));
+    rnds.emplace_back(emp::NewPtr<emp::Random>(configs[i].SEED()));
+    worlds.emplace_back(emp::NewPtr<DOLWorld>(*rnds[i]));
+    worlds[i]->Setup(configs[i]);
+    std::string & log = signal_logs[i];
+    worlds[i]->OnBeforeRepro([&log](size_t parent_pos) { log += "r" + emp::to_string(parent_pos); });
+    worlds[i]->OnOffspringReady([&log](DOLWorld::org_t & org, size_t parent_pos) {
+      // Offspring are prepared (phenotype reset) before offspring-ready handlers run
+      REQUIRE(org.GetPhenotype().age == 0);
+      log += "o" + emp::to_string(parent_pos);
+    });
+  }
+  for (size_t u = 0; u < 10; ++u) {
+    for (emp::Ptr<DOLWorld> world : worlds) world->RunStep();
+  }
+  REQUIRE(signal_logs[0].size());
+  for (size_t i = 0; i < worlds.size(); ++i) {
+    REQUIRE(worlds[i]->GetNumOrgs() == 16);
+    REQUIRE(signal_logs[i] == signal_logs[0]);
+  }
+  DOLWorld & serial = *worlds[0];
+  for (size_t i = 1; i < worlds.size(); ++i) {
+    DOLWorld & world = *worlds[i];
+    for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+      REQUIRE(world.GetGenomeAt(pos).program == serial.GetGenomeAt(pos).program);
+      REQUIRE(world.GetGenomeAt(pos).birth_tag == serial.GetGenomeAt(pos).birth_tag);
+      const DOLWorld::org_t::Phenotype & phen = world.GetOrg(pos).GetPhenotype();
+      const DOLWorld::org_t::Phenotype & serial_phen = serial.GetOrg(pos).GetPhenotype();
+      REQUIRE(phen.age == serial_phen.age);
+      REQUIRE(phen.offspring_cnt == serial_phen.offspring_cnt);
+      REQUIRE(phen.resource_pool == serial_phen.resource_pool);
+      REQUIRE(phen.total_resources_collected == serial_phen.total_resources_collected);
+      REQUIRE(phen.total_resources_donated == serial_phen.total_resources_donated);
+      REQUIRE(phen.consumption_amount_by_type == serial_phen.consumption_amount_by_type);
+      REQUIRE(phen.consumption_successes_by_type == serial_phen.consumption_successes_by_type);
+      REQUIRE(phen.consumption_failures_by_type == serial_phen.consumption_failures_by_type);
+      REQUIRE(phen.resource_alerts_received_by_type == serial_phen.resource_alerts_received_by_type);
+    }
+  }
+  for (size_t i = 0; i < worlds.size(); ++i) {
+    worlds[i].Delete();
+    rnds[i].Delete();
+  }
+}
+
+TEST_CASE ( "GenomeIO", "[genome_io]" ) {
+  // Create a world with a random population and save it
+  const std::string pop_fpath = "test_population.dolpop";
+  DOLWorldConfig config;
+  config.SEED(6);
+  config.INIT_POP_SIZE(20);
+  config.MAX_POP_SIZE(30);
+  config.INIT_POP_MODE("random");
+  config.MAX_ARGUMENT_VAL(15);
+  config.MIN_ARGUMENT_VAL(-15);
+
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  world.RemoveOrgAt(3); // Leave a hole in the population
+  REQUIRE(world.SavePopulation(pop_fpath));
+
+  // Read it back directly
+  GenomeIO::PopulationReader reader;
+  REQUIRE(reader.Load(pop_fpath, world.GetInstLib()));
+  REQUIRE(reader.GetSize() == 19);
+  for (const GenomeIO::PopulationEntry & entry : reader.GetEntries()) {
+    REQUIRE(entry.position != 3);
+    REQUIRE(entry.genome.birth_tag == world.GetGenomeAt(entry.position).birth_tag);
+    REQUIRE(entry.genome.program == world.GetGenomeAt(entry.position).program);
+  }
+
+  // Seed a new world from the population file
+  config.INIT_POP_MODE("load-population");
+  config.LOAD_POPULATION_FPATH(pop_fpath);
+  emp::Random rnd2(7);
+  DOLWorld world2(rnd2);
+  world2.Setup(config);
+  REQUIRE(world2.GetNumOrgs() == 19);
+  REQUIRE(!world2.IsOccupied(3));
+  for (size_t i = 0; i < world.GetSize(); ++i) {
+    REQUIRE(world.IsOccupied(i) == world2.IsOccupied(i));
+    if (!world.IsOccupied(i)) continue;
+    REQUIRE(world2.GetGenomeAt(i).program == world.GetGenomeAt(i).program);
+  }
+  world2.RunStep();
+
+  // Malformed files should be rejected
+  std::ofstream(pop_fpath, std::ios::binary | std::ios::trunc) << "DOLPOP";
+  std::stringstream err;
+  REQUIRE(!reader.Load(pop_fpath, world.GetInstLib(), err));
+  REQUIRE(reader.GetSize() == 0);
+  std::remove(pop_fpath.c_str());
+}
+
+TEST_CASE ( "GenomeTextParser", "[genome_io]" ) {
+  DOLWorldConfig config;
+  config.SEED(2);
+  config.INIT_POP_SIZE(6);
+  config.MAX_POP_SIZE(10);
+  config.INIT_POP_MODE("load-single");
+  config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+  emp::Random rnd(config.SEED());
+  DOLWorld world(rnd);
+  world.Setup(config);
+  const auto & inst_lib = world.GetInstLib();
+
+  // Multiple records, mixed spacing/case, optional tags & arguments
+  const std::string library =
+    "BIRTH-[0000000000000000]\n"
+    "Fn-0000000000000000:\n"
+    "  Inc(0,0,0)\n"
+    "  Nop[1000000000000001](1, -2, +3)\n"
+    "\n"
+    "birth [1100000000000000]\r\n"
+    "fn-0000000000000011:\r\n"
+    "  Express-0\r\n"
+    "Fn-1:\n"
+    "  Nop ( 4 )\n";
+  GenomeTextParser parser(inst_lib);
+  emp::vector<DigitalOrganism::Genome> genomes;
+  REQUIRE(parser.Parse(library, genomes));
+  REQUIRE(genomes.size() == 2);
+
+  DigitalOrganism::program_t expected(&inst_lib);
+  DigitalOrganism::tag_t tag;
+  expected.PushFunction(DOLWorld::sgp_hardware_t::Function(tag));
+  expected.PushInst(inst_lib.GetID("Inc"), 0, 0, 0, tag);
+  tag.Set(0, true); tag.Set(tag.GetSize()-1, true);
+  expected.PushInst(inst_lib.GetID("Nop"), 1, -2, 3, tag);
+  REQUIRE(genomes[0].birth_tag.CountOnes() == 0);
+  REQUIRE(genomes[0].program == expected);
+
+  REQUIRE(genomes[1].birth_tag.Get(genomes[1].birth_tag.GetSize()-1));
+  REQUIRE(genomes[1].birth_tag.Get(genomes[1].birth_tag.GetSize()-2));
+  REQUIRE(genomes[1].birth_tag.CountOnes() == 2);
+  REQUIRE(genomes[1].program.GetSize() == 2);
+  REQUIRE(genomes[1].program[0].affinity.CountOnes() == 2);
+  REQUIRE(genomes[1].program[0][0].id == inst_lib.GetID("Express-0"));
+  REQUIRE(genomes[1].program[1].affinity.Get(genomes[1].birth_tag.GetSize()-1));
+  REQUIRE(genomes[1].program[1][0].args[0] == 4);
+
+  // The single-ancestor file loaded by the world parses to the same genome
+  emp::vector<DigitalOrganism::Genome> loaded;
+  REQUIRE(parser.ParseFile("tests/test-configs/single-static-task.gp", loaded));
+  REQUIRE(loaded.size() == 1);
+  REQUIRE(loaded[0].program == world.GetGenomeAt(0).program);
+
+  // Errors are reported by line, and leave the output untouched
+  REQUIRE(!parser.Parse("Fn-0:\n  Nop\n", genomes));
+  REQUIRE(parser.GetError().line == 1);
+  REQUIRE(!parser.Parse("BIRTH-[0]\nFn-0:\n  Nop\n  NotAnInstruction(0,0,0)\n", genomes));
+  REQUIRE(parser.GetError().line == 4);
+  REQUIRE(!parser.Parse("BIRTH\n  Nop\n", genomes));
+  REQUIRE(parser.GetError().line == 2);
+  REQUIRE(!parser.Parse("BIRTH\nFn-0:\n  Nop(1,2,3,4)\n", genomes));
+  REQUIRE(parser.GetError().line == 3);
+  REQUIRE(!parser.Parse("BIRTH-[01\n", genomes));
+  REQUIRE(parser.GetError().line == 1);
+  REQUIRE(!parser.ParseFile("does-not-exist.gp", genomes));
+  REQUIRE(genomes.size() == 2);
+
+  // Seed a world from an ancestor library
+  const std::string library_fpath = "test_library.gp";
+  std::ofstream(library_fpath, std::ios::trunc) << library;
+  config.INIT_POP_MODE("load-library");
+  config.LOAD_ANCESTOR_LIBRARY_FPATH(library_fpath);
+  emp::Random rnd2(3);
+  DOLWorld world2(rnd2);
+  world2.Setup(config);
+  REQUIRE(world2.GetNumOrgs() == 6);
+  for (size_t i = 0; i < 6; ++i) {
+    REQUIRE(world2.GetGenomeAt(i).program == genomes[i % 2].program);
+  }
+  std::remove(library_fpath.c_str());
+}
+
 TEST_CASE ( "Resource", "[resource]") {
   Resource resource;
 
@@ -445,6 +1385,48 @@ TEST_CASE ( "Resource", "[resource]") {
   REQUIRE(resource.IsAvailable() == true);
   REQUIRE(resource.GetTimeAvailable() == 0);
   REQUIRE(resource.GetTimeUnavailable() == 0);
+
+  // Consumption/decay policies
+  resource.SetAmount(100);
+  REQUIRE(FixedResourcePolicy::Consume(resource, 25) == 25);
+  REQUIRE(resource.GetAmount() == 75);
+  REQUIRE(ProportionalResourcePolicy::Consume(resource, 0.2) == 15);
+  REQUIRE(resource.GetAmount() == 60);
+  FixedResourcePolicy::Decay(resource, 10);
+  REQUIRE(resource.GetAmount() == 50);
+  ProportionalResourcePolicy::Decay(resource, 1.0);
+  REQUIRE(resource.GetAmount() == 0.0);
+  REQUIRE(resource.IsAvailable() == false);
+}
+
+TEST_CASE ( "DOLWorld - Resource Policies", "[world][resource]") {
+  // World should run (& organisms should collect resources) under every
+  // consumption/decay mode combination, whether metabolize attempts resolve
+  // immediately (interleaved) or are buffered until a batch ends (cell-major)
+  for (const std::string execution_mode : {"interleaved", "cell-major"}) {
+    for (const std::string consume_mode : {"fixed", "proportional"}) {
+      for (const std::string decay_mode : {"fixed", "proportional"}) {
+        DOLWorldConfig config;
+        config.SEED(4);
+        config.INIT_POP_SIZE(4);
+        config.MAX_POP_SIZE(10);
+        config.INIT_POP_MODE("load-single");
+        config.LOAD_ANCESTOR_INDIV_FPATH("tests/test-configs/single-static-task.gp");
+        config.CELL_EXECUTION_MODE(execution_mode);
+        config.RESOURCE_CONSUMPTION_MODE(consume_mode);
+        config.RESOURCE_DECAY_MODE(decay_mode);
+        emp::Random rnd(config.SEED());
+        DOLWorld world(rnd);
+        world.Setup(config);
+        for (size_t u = 0; u < 10; ++u) world.RunStep();
+        double collected = 0;
+        for (size_t i = 0; i < world.GetSize(); ++i) {
+          if (world.IsOccupied(i)) collected += world.GetOrg(i).GetPhenotype().total_resources_collected;
+        }
+        REQUIRE(collected > 0);
+      }
+    }
+  }
 }
 
 TEST_CASE ( "Mutator", "[mutator]") {
@@ -494,6 +1476,415 @@ TEST_CASE ( "Mutator", "[mutator]") {
   }
 }
 
+TEST_CASE ( "Mutator - Skip-Ahead Sampling", "[mutator]") {
+  using genome_t = typename DigitalOrganism::Genome;
+  using sgp_hardware_t = typename DOLWorld::sgp_hardware_t;
+  using inst_lib_t = typename DOLWorld::inst_lib_t;
+
+  // Sample statistics; means must agree to within 5 standard errors
+  struct Stats {
+    double sum=0.0, sum_sq=0.0;
+    size_t n=0;
+    void Add(double x) { sum += x; sum_sq += x * x; ++n; }
+    double Mean() const { return sum / (double)n; }
+    double Var() const { return sum_sq / (double)n - Mean() * Mean(); }
+  };
+  auto same_mean = [](const Stats & a, const Stats & b) {
+    return std::abs(a.Mean() - b.Mean()) <= 5.0 * std::sqrt(a.Var() / (double)a.n + b.Var() / (double)b.n);
+  };
+
+  // Samplers: same number of hits & same first-hit position
+  emp::Random rnd(11);
+  for (double p : {0.0025, 0.05, 0.5}) {
+    Stats per_site_hits, skip_hits, per_site_first, skip_first;
+    for (size_t t = 0; t < 5000; ++t) {
+      PerSiteSampler per_site(p);
+      SkipAheadSampler skip(p);
+      size_t hits = 0;
+      size_t first = 500;
+      for (size_t i = per_site.NextHit(rnd, 500); i < 500; i += 1 + per_site.NextHit(rnd, 500 - i - 1)) {
+        if (!hits) first = i;
+        ++hits;
+      }
+      per_site_hits.Add((double)hits);
+      per_site_first.Add((double)first);
+      hits = 0;
+      first = 500;
+      for (size_t i = skip.NextHit(rnd, 500); i < 500; i += 1 + skip.NextHit(rnd, 500 - i - 1)) {
+        if (!hits) first = i;
+        ++hits;
+      }
+      skip_hits.Add((double)hits);
+      skip_first.Add((double)first);
+    }
+    REQUIRE(same_mean(per_site_hits, skip_hits));
+    REQUIRE(same_mean(per_site_first, skip_first));
+    REQUIRE(std::abs(skip_hits.Mean() - 500 * p) <= 5.0 * std::sqrt(500 * p * (1 - p) / 5000.0));
+  }
+  SkipAheadSampler never(0.0);
+  REQUIRE(never.NextHit(rnd, 1000000) == 1000000);
+  SkipAheadSampler always(1.0);
+  REQUIRE(always.NextHit(rnd, 10) == 0);
+
+  // Engines: per-site & skip-ahead mutate the same distribution of genomes
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop-A", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("Nop-B", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("Nop-C", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  DOLWorldConfig config;
+  config.MIN_FUNCTION_CNT(1);
+  config.MAX_FUNCTION_CNT(8);
+  config.MIN_FUNCTION_LEN(1);
+  config.MAX_FUNCTION_LEN(24);
+  config.MIN_ARGUMENT_VAL(0);
+  config.MAX_ARGUMENT_VAL(8);
+  config.PROGRAM_ARG_SUB__PER_ARG(0.02);
+  config.PROGRAM_INST_SUB__PER_INST(0.02);
+  config.PROGRAM_INST_INS__PER_INST(0.02);
+  config.PROGRAM_INST_DEL__PER_INST(0.02);
+  config.PROGRAM_SLIP__PER_FUN(0.1);
+  config.PROGRAM_FUNC_DUP__PER_FUN(0.1);
+  config.PROGRAM_FUNC_DEL__PER_FUN(0.1);
+  config.PROGRAM_TAG_BIT_FLIP__PER_BIT(0.02);
+  config.BIRTH_TAG_BIT_FLIP__PER_BIT(0.02);
+  // (an ancestor with a few functions of different lengths, so function order shows in per-function lengths)
+  genome_t ancestor = GenRandDigitalOrganismGenome(rnd, inst_lib, config);
+  while (ancestor.program.GetSize() < 3
+         || ancestor.program[0].GetSize() == ancestor.program[ancestor.program.GetSize() - 1].GetSize()) {
+    ancestor = GenRandDigitalOrganismGenome(rnd, inst_lib, config);
+  }
+  // Per-function lengths: length of the function at each position (0 if the program is shorter)
+  auto sample = [&](const std::string & engine, Stats & mutations, Stats & inst_cnt, Stats & func_cnt,
+                    emp::vector<Stats> & func_lens) {
+    config.MUTATION_ENGINE(engine);
+    Mutator mutator;
+    mutator.Setup(config);
+    func_lens.resize(config.MAX_FUNCTION_CNT());
+    for (size_t t = 0; t < 4000; ++t) {
+      genome_t genome(ancestor);
+      mutations.Add((double)mutator.Mutate(genome, rnd));
+      REQUIRE(ValidateDigitalOrganismGenome(config, genome));
+      inst_cnt.Add((double)genome.program.GetInstCnt());
+      func_cnt.Add((double)genome.program.GetSize());
+      for (size_t fID = 0; fID < func_lens.size(); ++fID) {
+        func_lens[fID].Add((fID < genome.program.GetSize()) ? (double)genome.program[fID].GetSize() : 0.0);
+      }
+    }
+  };
+  auto same_lens = [&](const emp::vector<Stats> & a, const emp::vector<Stats> & b) {
+    for (size_t fID = 0; fID < a.size(); ++fID) {
+      if (a[fID].Var() == 0.0 && b[fID].Var() == 0.0) {
+        if (a[fID].Mean() != b[fID].Mean()) return false;
+      } else if (!same_mean(a[fID], b[fID])) return false;
+    }
+    return true;
+  };
+  Stats per_site_muts, per_site_insts, per_site_funcs;
+  Stats skip_muts, skip_insts, skip_funcs;
+  emp::vector<Stats> per_site_lens, skip_lens;
+  sample("per-site", per_site_muts, per_site_insts, per_site_funcs, per_site_lens);
+  sample("skip-ahead", skip_muts, skip_insts, skip_funcs, skip_lens);
+  REQUIRE(skip_muts.Mean() > 0.0);
+  REQUIRE(same_mean(per_site_muts, skip_muts));
+  REQUIRE(same_mean(per_site_insts, skip_insts));
+  REQUIRE(same_mean(per_site_funcs, skip_funcs));
+  REQUIRE(same_lens(per_site_lens, skip_lens));
+  REQUIRE(std::abs(per_site_muts.Var() - skip_muts.Var()) <= 0.15 * per_site_muts.Var());
+
+  // Every operator on: per-site mutates the same distribution of genomes as SignalGP's mutator
+  // (mutation counts, genome sizes, and which function ends up where, e.g., after a deletion)
+  Stats all_sgp_muts, all_sgp_insts, all_sgp_funcs;
+  Stats all_site_muts, all_site_insts, all_site_funcs;
+  emp::vector<Stats> all_sgp_lens, all_site_lens;
+  sample("signalgp", all_sgp_muts, all_sgp_insts, all_sgp_funcs, all_sgp_lens);
+  sample("per-site", all_site_muts, all_site_insts, all_site_funcs, all_site_lens);
+  REQUIRE(all_site_muts.Mean() > 0.0);
+  REQUIRE(all_site_funcs.Var() > 0.0);
+  REQUIRE(same_mean(all_sgp_muts, all_site_muts));
+  REQUIRE(same_mean(all_sgp_insts, all_site_insts));
+  REQUIRE(same_mean(all_sgp_funcs, all_site_funcs));
+  REQUIRE(same_lens(all_sgp_lens, all_site_lens));
+  REQUIRE(std::abs(all_sgp_muts.Var() - all_site_muts.Var()) <= 0.15 * all_sgp_muts.Var());
+
+  // Substitutions only: same number of mutations as SignalGP's mutator
+  config.PROGRAM_INST_INS__PER_INST(0.0);
+  config.PROGRAM_INST_DEL__PER_INST(0.0);
+  config.PROGRAM_SLIP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DUP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DEL__PER_FUN(0.0);
+  Stats sgp_muts, sgp_insts, sgp_funcs;
+  Stats sub_muts, sub_insts, sub_funcs;
+  emp::vector<Stats> sgp_lens, sub_lens;
+  sample("signalgp", sgp_muts, sgp_insts, sgp_funcs, sgp_lens);
+  sample("skip-ahead", sub_muts, sub_insts, sub_funcs, sub_lens);
+  REQUIRE(same_mean(sgp_muts, sub_muts));
+  REQUIRE(sub_insts.Mean() == (double)ancestor.program.GetInstCnt());
+
+  // Bad engine names are rejected
+  MutationEngine engine;
+  REQUIRE(!ParseMutationEngine("geometric", engine));
+  REQUIRE(ParseMutationEngine("skip-ahead", engine));
+  REQUIRE(engine == MutationEngine::SKIP_AHEAD);
+}
+
+TEST_CASE ( "Mutator - Mutation Deltas", "[mutator]") {
+  using genome_t = typename DigitalOrganism::Genome;
+  using sgp_hardware_t = typename DOLWorld::sgp_hardware_t;
+  using inst_lib_t = typename DOLWorld::inst_lib_t;
+
+  emp::Random rnd(8);
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop-A", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("Nop-B", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("Nop-C", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  DOLWorldConfig config;
+  config.MAX_FUNCTION_CNT(8);
+  config.MAX_FUNCTION_LEN(24);
+  config.MAX_ARGUMENT_VAL(8);
+  config.PROGRAM_ARG_SUB__PER_ARG(0.005);
+  config.PROGRAM_INST_SUB__PER_INST(0.005);
+  config.PROGRAM_INST_INS__PER_INST(0.005);
+  config.PROGRAM_INST_DEL__PER_INST(0.005);
+  config.PROGRAM_SLIP__PER_FUN(0.02);
+  config.PROGRAM_FUNC_DUP__PER_FUN(0.02);
+  config.PROGRAM_FUNC_DEL__PER_FUN(0.02);
+  config.PROGRAM_TAG_BIT_FLIP__PER_BIT(0.002);
+  config.BIRTH_TAG_BIT_FLIP__PER_BIT(0.005);
+  DigitalOrganism::genotype_store_t store;
+
+  // Digests updated from deltas match digests computed from scratch, and
+  // validating only what changed agrees with validating everything
+  for (const std::string engine : {"per-site", "skip-ahead", "signalgp"}) {
+    config.MUTATION_ENGINE(engine);
+    Mutator mutator;
+    mutator.Setup(config);
+    DigitalOrganism parent(store.Intern(GenRandDigitalOrganismGenome(rnd, inst_lib, config)));
+    size_t num_changed = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+      DigitalOrganism offspring(parent.GetGenotype());
+      const MutationDelta delta = mutator.Mutate(offspring, rnd);
+      REQUIRE(ValidateMutatedGenome(config, offspring.GetGenome(), delta)
+              == ValidateDigitalOrganismGenome(config, offspring.GetGenome()));
+      if (!delta.num_mutations) {
+        REQUIRE(!delta.IsProgramChanged());
+        REQUIRE(!delta.birth_tag_changed);
+        continue;
+      }
+      ++num_changed;
+      REQUIRE(offspring.GetGenotype().HasDigest());
+      DigitalOrganism::GenomeDigest digest;
+      DigitalOrganism::GenomeHash::Digest(offspring.GetGenome(), digest);
+      REQUIRE(offspring.GetGenotype().GetDigest().function_hashes == digest.function_hashes);
+      REQUIRE(offspring.GetGenotype().GetHash() == digest.hash);
+      REQUIRE(delta.whole_program == (engine == "signalgp" && delta.IsProgramChanged()));
+      // Walk down a lineage (so deltas apply to already-mutated parents)
+      offspring.SetGenotype(store.Intern(offspring.GetGenotype()));
+      if (i % 5 == 0) parent = offspring;
+    }
+    REQUIRE(num_changed > 0);
+  }
+
+  // Deltas list exactly what changed
+  config.MUTATION_ENGINE("skip-ahead");
+  config.PROGRAM_ARG_SUB__PER_ARG(0.0);
+  config.PROGRAM_INST_INS__PER_INST(0.0);
+  config.PROGRAM_INST_DEL__PER_INST(0.0);
+  config.PROGRAM_SLIP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DUP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DEL__PER_FUN(0.0);
+  config.PROGRAM_TAG_BIT_FLIP__PER_BIT(0.0);
+  config.BIRTH_TAG_BIT_FLIP__PER_BIT(0.0);
+  config.PROGRAM_INST_SUB__PER_INST(0.05);
+  Mutator mutator;
+  mutator.Setup(config);
+  const genome_t ancestor = GenRandDigitalOrganismGenome(rnd, inst_lib, config);
+  for (size_t i = 0; i < 100; ++i) {
+    genome_t genome(ancestor);
+    const MutationDelta delta = mutator.Mutate(genome, rnd);
+    REQUIRE(delta.function_sources.empty());
+    REQUIRE(delta.resized_functions.empty());
+    REQUIRE(delta.inst_edits.size() == delta.num_mutations);
+    for (size_t fID = 0; fID < genome.program.GetSize(); ++fID) {
+      for (size_t pos = 0; pos < genome.program[fID].GetSize(); ++pos) {
+        const bool edited = std::binary_search(delta.inst_edits.begin(), delta.inst_edits.end(), MutationDelta::InstEdit{fID, pos});
+        if (!edited) REQUIRE(genome.program[fID][pos].id == ancestor.program[fID][pos].id);
+      }
+      if (!delta.IsFunctionChanged(fID)) REQUIRE(genome.program[fID].inst_seq == ancestor.program[fID].inst_seq);
+    }
+  }
+}
+
+TEST_CASE ( "GenotypeStore", "[genotype]") {
+  using genome_t = typename DigitalOrganism::Genome;
+  using genotype_t = typename DigitalOrganism::genotype_t;
+  using sgp_hardware_t = typename DOLWorld::sgp_hardware_t;
+  using inst_lib_t = typename DOLWorld::inst_lib_t;
+
+  emp::Random rnd(5);
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop-A", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("Nop-B", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  DOLWorldConfig config;
+  config.MUTATION_ENGINE("skip-ahead");
+  config.MAX_FUNCTION_CNT(4);
+  config.MAX_FUNCTION_LEN(16);
+  const genome_t genome_a = GenRandDigitalOrganismGenome(rnd, inst_lib, config);
+  genome_t genome_b(genome_a);
+  genome_b.birth_tag.Toggle(0);
+
+  // Equal genomes are interned once; genotypes leave the store with their last handle
+  DigitalOrganism::genotype_store_t store;
+  {
+    genotype_t a1 = store.Intern(genome_a);
+    genotype_t a2 = store.Intern(genome_t(genome_a));
+    REQUIRE(a1 == a2);
+    REQUIRE(a1.GetAbundance() == 2);
+    REQUIRE(a1.GetHash() == DigitalOrganism::GenomeHash()(genome_a));
+    genotype_t b = store.Intern(genome_b);
+    REQUIRE(b != a1);
+    REQUIRE(store.GetNumGenotypes() == 2);
+    size_t total_abundance = 0;
+    store.ForEachGenotype([&](const genome_t &, size_t abundance) { total_abundance += abundance; });
+    REQUIRE(total_abundance == 3);
+    // Interning a standalone genotype that's new to the store adopts it
+    genome_t genome_c(genome_b);
+    genome_c.birth_tag.Toggle(1);
+    DigitalOrganism org(genome_c);
+    REQUIRE(!org.GetGenotype().IsInterned());
+    org.SetGenotype(store.Intern(org.GetGenotype()));
+    REQUIRE(org.GetGenotype().IsInterned());
+    REQUIRE(store.GetNumGenotypes() == 3);
+  }
+  REQUIRE(store.GetNumGenotypes() == 0);
+
+  // Derived data (each genotype's decoded program) is computed once, when the genotype is interned
+  {
+    const emp::vector<DecodedProgram::BlockRole> roles = DecodedProgram::ClassifyInstructions(inst_lib);
+    size_t num_derived = 0;
+    store.SetDeriveFun([&](const genome_t & genome, DecodedProgram & decoded) {
+      ++num_derived;
+      decoded.Decode(genome.program, roles);
+    });
+    genotype_t a1 = store.Intern(genome_a);
+    genotype_t a2 = store.Intern(genome_t(genome_a));
+    REQUIRE(num_derived == 1);
+    REQUIRE(&a1.GetDerived() == &a2.GetDerived());
+    REQUIRE(a1.GetDerived().GetFunctionCnt() == genome_a.program.GetSize());
+    store.SetDeriveFun(nullptr);
+  }
+
+  // Mutation is copy-on-write: organisms that don't mutate keep their genotype
+  config.PROGRAM_ARG_SUB__PER_ARG(0.0);
+  config.PROGRAM_INST_SUB__PER_INST(0.0);
+  config.PROGRAM_INST_INS__PER_INST(0.0);
+  config.PROGRAM_INST_DEL__PER_INST(0.0);
+  config.PROGRAM_SLIP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DUP__PER_FUN(0.0);
+  config.PROGRAM_FUNC_DEL__PER_FUN(0.0);
+  config.PROGRAM_TAG_BIT_FLIP__PER_BIT(0.0);
+  config.BIRTH_TAG_BIT_FLIP__PER_BIT(0.05);  // Offspring mutate about half the time
+  Mutator mutator;
+  mutator.Setup(config);
+  genotype_t parent = store.Intern(genome_a);
+  size_t shared = 0;
+  for (size_t i = 0; i < 200; ++i) {
+    DigitalOrganism offspring(parent);
+    if (mutator.Mutate(offspring, rnd)) {
+      REQUIRE(offspring.GetGenotype() != parent);
+    } else {
+      REQUIRE(offspring.GetGenotype() == parent);
+      ++shared;
+    }
+    REQUIRE(parent.GetGenome() == genome_a);
+  }
+  REQUIRE(shared > 0);
+  REQUIRE(shared < 200);
+  REQUIRE(parent.GetAbundance() == 1);
+
+  // In a world, every organism's genotype is interned & abundances add up to the population
+  DOLWorldConfig world_config;
+  world_config.SEED(3);
+  world_config.INIT_POP_SIZE(10);
+  world_config.MAX_POP_SIZE(16);
+  world_config.INIT_POP_MODE("random");
+  world_config.DEME_REPRODUCTION_COST(0);
+  world_config.MAX_FUNCTION_CNT(4);
+  world_config.MAX_FUNCTION_LEN(16);
+  world_config.MUTATION_ENGINE("skip-ahead");
+  emp::Random world_rnd(world_config.SEED());
+  DOLWorld world(world_rnd);
+  world.Setup(world_config);
+  for (size_t u = 0; u < 10; ++u) world.RunStep();
+  const DigitalOrganism::genotype_store_t & world_genotypes = world.GetGenotypeStore();
+  size_t total_abundance = 0;
+  world_genotypes.ForEachGenotype([&](const genome_t &, size_t abundance) { total_abundance += abundance; });
+  REQUIRE(total_abundance == world.GetNumOrgs());
+  REQUIRE(world_genotypes.GetNumGenotypes() <= world.GetNumOrgs());
+  for (size_t pos = 0; pos < world.GetSize(); ++pos) {
+    if (!world.IsOccupied(pos)) continue;
+    REQUIRE(world.GetOrg(pos).GetGenotype().IsInterned());
+    // Demes run against their organism's (shared) decoded program
+    REQUIRE(&world.GetDeme(pos).GetDecodedProgram() == &world.GetOrg(pos).GetGenotype().GetDerived());
+  }
+}
+
+TEST_CASE ( "DecodedProgram", "[decoded_program]") {
+  using sgp_hardware_t = typename DOLWorld::sgp_hardware_t;
+  using inst_lib_t = typename DOLWorld::inst_lib_t;
+  using program_t = typename DOLWorld::sgp_program_t;
+
+  inst_lib_t inst_lib;
+  inst_lib.AddInst("Nop", sgp_hardware_t::Inst_Nop, 0, "No operation.");
+  inst_lib.AddInst("If", sgp_hardware_t::Inst_If, 1, "If", emp::ScopeType::BASIC, 0, {"block_def"});
+  inst_lib.AddInst("While", sgp_hardware_t::Inst_While, 1, "While", emp::ScopeType::BASIC, 0, {"block_def"});
+  inst_lib.AddInst("Close", sgp_hardware_t::Inst_Close, 0, "Close", emp::ScopeType::BASIC, 0, {"block_close"});
+
+  emp::vector<DecodedProgram::BlockRole> roles = DecodedProgram::ClassifyInstructions(inst_lib);
+  REQUIRE(roles[inst_lib.GetID("Nop")] == DecodedProgram::BlockRole::NONE);
+  REQUIRE(roles[inst_lib.GetID("If")] == DecodedProgram::BlockRole::BLOCK_DEF);
+  REQUIRE(roles[inst_lib.GetID("While")] == DecodedProgram::BlockRole::BLOCK_DEF);
+  REQUIRE(roles[inst_lib.GetID("Close")] == DecodedProgram::BlockRole::BLOCK_CLOSE);
+
+  std::stringstream prog_stream;
+  prog_stream << "Fn-0000000000000000:\n"
+              << "  Nop\n"       // 0
+              << "  While\n"     // 1
+              << "    If\n"      // 2
+              << "      Nop\n"   // 3
+              << "    Close\n"   // 4
+              << "    Nop\n"     // 5
+              << "  Close\n"     // 6
+              << "  Close\n"     // 7 (nothing to close)
+              << "  If\n"        // 8 (never closed)
+              << "Fn-1111111111111111:\n"
+              << "  If\n"        // 0
+              << "  Close\n";    // 1
+  program_t prog(&inst_lib);
+  prog.Load(prog_stream);
+  REQUIRE(prog.GetSize() == 2);
+
+  DecodedProgram decoded;
+  decoded.Decode(prog, roles);
+  REQUIRE(decoded.GetFunctionCnt() == 2);
+  REQUIRE(decoded.GetFunctionSize(0) == 9);
+  REQUIRE(decoded.GetFunctionSize(1) == 2);
+  REQUIRE(decoded.GetBlockEnd(0, 1) == 6);
+  REQUIRE(decoded.GetBlockEnd(0, 2) == 4);
+  REQUIRE(decoded.GetBlockEnd(0, 8) == 9);
+  REQUIRE(decoded.GetBlockEnd(1, 0) == 1);
+
+  // Decoded block ends should agree with SignalGP's end-of-block search
+  emp::Random rnd(1);
+  sgp_hardware_t hw(&inst_lib, nullptr, &rnd);
+  hw.SetProgram(prog);
+  for (size_t fp = 0; fp < prog.GetSize(); ++fp) {
+    for (size_t ip = 0; ip + 1 < prog[fp].GetSize(); ++ip) {
+      if (roles[prog[fp][ip].id] != DecodedProgram::BlockRole::BLOCK_DEF) continue;
+      REQUIRE(decoded.GetBlockEnd(fp, ip) == hw.FindEndOfBlock(fp, ip+1));
+    }
+  }
+}
+
 TEST_CASE ("Utilities - GenRandTag", "[utilities]") {
   constexpr size_t TWIDTH = 4;
   using tag_t = emp::BitSet<TWIDTH>;
@@ -0,0 +1,53 @@
+// Headless smoke test for the simulation worker builds (see `make web-test`).
+//
+// Usage: node tests/web/worker_smoke.js web/plasticity_dol_model-worker[-fast].js SUMMARY_FPATH
+//
+// Configures a small world with several threads, runs a few updates, and writes
+// the update, population size, and a hash of the snapshot bytes to SUMMARY_FPATH.
+// The scalar and fast builds should write exactly the same summary. (The world's
+// own log goes to stdout and differs between builds, e.g., thread availability
+// and phase timings, so it isn't part of the comparison.)
+
+var fs = require('fs');
+var path = require('path');
+
+if (process.argv.length < 4) {
+  console.error('Usage: node worker_smoke.js WORKER_JS SUMMARY_FPATH');
+  process.exit(2);
+}
+var summary_fpath = process.argv[3];
+
+var config = [
+  'set SEED 1',
+  'set INIT_POP_SIZE 10',
+  'set MAX_POP_SIZE 100',
+  'set NUM_THREADS 4',
+  ''
+].join('\n');
+var num_updates = 20;
+
+// FNV-1a over the snapshot bytes
+function hashBytes(bytes) {
+  var hash = 0x811c9dc5;
+  for (var i = 0; i < bytes.length; ++i) {
+    hash ^= bytes[i];
+    hash = Math.imul(hash, 0x01000193) >>> 0;
+  }
+  return ('00000000' + hash.toString(16)).slice(-8);
+}
+
+global.Module = {
+  onRuntimeInitialized: function() {
+    Module.ccall('worker_configure', null, ['string', 'number'], [config, 1]);
+    Module._worker_run(1e9, num_updates);
+    var ptr = Module._worker_snapshot_data();
+    var size = Module._worker_snapshot_size();
+    var bytes = Module.HEAPU8.slice(ptr, ptr + size);
+    // Header words: generation, update, num_orgs, ...
+    var words = new BigUint64Array(bytes.buffer, 0, 3);
+    fs.writeFileSync(summary_fpath, 'update ' + words[1] + ' orgs ' + words[2] + ' bytes ' + size + ' hash ' + hashBytes(bytes) + '\n');
+    process.exit(0);  // pthreads builds keep their thread pool alive
+  }
+};
+
+require(path.resolve(process.argv[2]));
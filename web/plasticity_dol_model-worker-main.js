@@ -0,0 +1,93 @@
+// Web worker that runs the simulation (plasticity_dol_model-worker.cc).
+//
+// Messages from the page:
+//   {type: 'configure', config: <config file text>, generation: <int>}
+//   {type: 'run', budget_ms: <ms>}  run continuously (in slices of budget_ms)
+//   {type: 'pause'}
+//   {type: 'step'}   run a single update
+// Messages to the page:
+//   {type: 'snapshot', running: <bool>, snapshot: <ArrayBuffer (transferred)>}
+//
+// Loads the fast build (pthreads + wasm SIMD, `make web-fast`) when the browser
+// supports it, and otherwise the scalar build.
+
+var run_slice_ms = 16;      // Publish a snapshot after each slice of simulation time
+var running = false;
+var ready = false;
+var pending = [];           // Messages that arrived before the module was ready
+var max_threads = 8;        // Must not exceed WEB_FAST_POOL_SIZE in the Makefile
+
+// Smallest module using a SIMD instruction (v128 splat); only validates if wasm SIMD is supported.
+var simd_probe = new Uint8Array([0,97,115,109,1,0,0,0,1,5,1,96,0,1,123,3,2,1,0,10,10,1,8,0,65,0,253,15,253,98,11]);
+
+// Threads need SharedArrayBuffer, which browsers only allow on cross-origin isolated pages
+// (served with COOP/COEP headers).
+function canRunFast() {
+  return typeof SharedArrayBuffer !== 'undefined' && self.crossOriginIsolated === true &&
+         typeof WebAssembly === 'object' && WebAssembly.validate(simd_probe);
+}
+
+var use_fast = canRunFast();
+var script = use_fast ? 'plasticity_dol_model-worker-fast.js' : 'plasticity_dol_model-worker.js';
+var num_threads = use_fast ? Math.max(1, Math.min(navigator.hardwareConcurrency || 1, max_threads)) : 1;
+
+var Module = {
+  mainScriptUrlOrBlob: script,  // Lets the pthreads build find itself when starting threads
+  onRuntimeInitialized: function() {
+    ready = true;
+    pending.forEach(handleMessage);
+    pending = [];
+  }
+};
+
+importScripts(script);
+
+function publishSnapshot() {
+  var ptr = Module._worker_snapshot_data();
+  var size = Module._worker_snapshot_size();
+  var buffer = HEAPU8.slice(ptr, ptr + size).buffer;
+  postMessage({type: 'snapshot', running: running, snapshot: buffer}, [buffer]);
+}
+
+function runSlice() {
+  if (!running) return;
+  Module._worker_run(run_slice_ms, 0xFFFFFFFF);
+  publishSnapshot();
+  setTimeout(runSlice, 0);  // Yield so 'pause'/'configure' messages get handled
+}
+
+function handleMessage(msg) {
+  switch (msg.type) {
+    case 'configure':
+      running = false;
+      Module.ccall('worker_configure', null, ['string', 'number'],
+                   [msg.config + '\nset NUM_THREADS ' + num_threads + '\n', msg.generation]);
+      publishSnapshot();
+      break;
+    case 'run':
+      if (msg.budget_ms > 0) run_slice_ms = msg.budget_ms;
+      if (!running) {
+        running = true;
+        runSlice();
+      }
+      break;
+    case 'pause':
+      running = false;
+      publishSnapshot();
+      break;
+    case 'step':
+      if (!running) {
+        Module._worker_run(0, 1);
+        publishSnapshot();
+      }
+      break;
+  }
+}
+
+onmessage = function(e) {
+  if (!ready) {
+    pending.push(e.data);
+    return;
+  }
+  handleMessage(e.data);
+};